@@ -7,7 +7,6 @@
 //
 
 #include <iostream>
-#include <regex>
 #include <string>
 #include <sstream>
 #include <utility>
@@ -28,8 +27,8 @@ using namespace rpc;
 template <typename T>
 using iter_type = typename std::basic_string<T>::const_iterator;
 
-auto rx_as    = basic::regexparser<iter_type<char>> (std::regex("a+"));
-auto rx_as_bs = basic::regexparser<iter_type<char>> (std::regex("a+b+"));
+auto rx_as    = basic::compiled_regexparser<iter_type<char>> ("a+");
+auto rx_as_bs = basic::compiled_regexparser<iter_type<char>> ("a+b+");
 
 template <typename T>
 std::string print_results (std::deque<T> const& l)
@@ -0,0 +1,594 @@
+//
+// Conversion of numbers to integers and floating point straight from the
+// tokens of the input, without strings or the locale
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef NUMERIC_CONVERSION_HPP
+#define NUMERIC_CONVERSION_HPP
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "core/char_class.hpp"
+
+#include "powers_of_five.hpp"
+
+//
+// Eight decimal digits are read at once as a 64-bit word where bytes are
+// laid out little-endian; elsewhere digits are read one at a time.
+//
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define RPC_SWAR_DIGITS 1
+#else
+#define RPC_SWAR_DIGITS 0
+#endif
+
+namespace rpc
+{
+namespace basic
+{
+namespace detail
+{
+    //
+    // the value of a digit in any base up to 36 (letters of either case
+    // from 'a' on are 10 and up), or 36 if the token is no digit.
+    //
+    template <typename T>
+    inline unsigned digit_value (T const& c) noexcept
+    {
+        if (c >= T ('0') && c <= T ('9'))
+            return static_cast<unsigned> (c - T ('0'));
+        else if (c >= T ('a') && c <= T ('z'))
+            return static_cast<unsigned> (c - T ('a')) + 10;
+        else if (c >= T ('A') && c <= T ('Z'))
+            return static_cast<unsigned> (c - T ('A')) + 10;
+        else
+            return 36;
+    }
+
+    template <typename T>
+    inline bool is_decimal (T const& c) noexcept
+    {
+        return c >= T ('0') && c <= T ('9');
+    }
+
+    //
+    // the eight decimal digits at it as a number, if there are eight bytes
+    // left before e and each is a digit. The word is tested in one step:
+    // a byte below '0' borrows into, and a byte above '9' carries into,
+    // its high bit. It is then reduced in three multiplications, pairing
+    // digits, then pairs, then quadruples.
+    //
+    template <typename It>
+    inline bool eight_digits (It const it, It const e, std::uint32_t& v,
+                              std::true_type) noexcept
+    {
+#if RPC_SWAR_DIGITS
+        if (e - it < 8)
+            return false;
+
+        std::uint64_t x;
+        std::memcpy (&x, &*it, sizeof (x));
+        if ((((x + 0x4646464646464646) | (x - 0x3030303030303030)) &
+             0x8080808080808080) != 0)
+            return false;
+
+        std::uint64_t const mask (0x000000ff000000ff);
+        std::uint64_t const mul1 (0x000f424000000064);
+        std::uint64_t const mul2 (0x0000271000000001);
+        x -= 0x3030303030303030;
+        x = (x * 10) + (x >> 8);
+        x = (((x & mask) * mul1) + (((x >> 16) & mask) * mul2)) >> 32;
+        v = static_cast<std::uint32_t> (x);
+        return true;
+#else
+        (void) it, (void) e, (void) v;
+        return false;
+#endif
+    }
+
+    template <typename It>
+    inline bool eight_digits (It const, It const, std::uint32_t&,
+                              std::false_type) noexcept
+    {
+        return false;
+    }
+
+    //
+    // The digits of a base at the beginning of [it, e), as a number; n is
+    // how many there are, and overflow whether their value does not fit in
+    // 64 bits. Decimal digits over contiguous bytes are read eight at a
+    // time while no 64-bit value of them may overflow (19 digits), and the
+    // rest one at a time with the overflow checked.
+    //
+    template <unsigned base, typename It>
+    inline std::uint64_t scan_natural (It it, It const e, std::size_t& n,
+                                       bool& overflow) noexcept
+    {
+        static_assert (base >= 2 && base <= 36,
+                       "natural numbers are read in bases 2 to 36.");
+        using contiguous = core::is_contiguous_byte_iterator<It>;
+
+        std::uint64_t v (0);
+        std::uint32_t eight;
+        n = 0;
+        overflow = false;
+
+        if (base == 10)
+            while (n + 8 <= 19 && eight_digits (it, e, eight, contiguous {})) {
+                v = v * 100000000 + eight;
+                std::advance (it, 8);
+                n += 8;
+            }
+
+        auto const max (std::numeric_limits<std::uint64_t>::max ());
+        for (; it != e; ++it, ++n) {
+            auto const d (digit_value (*it));
+            if (d >= base)
+                break;
+            else if (v > (max - d) / base)
+                overflow = true;
+            else
+                v = v * base + d;
+        }
+        return v;
+    }
+
+    //
+    // a magnitude as an integer of type IntT, negated if negative; false
+    // if it is out of the range of IntT.
+    //
+    template <typename IntT>
+    inline bool to_integer (std::uint64_t const m, bool const negative,
+                            IntT& v) noexcept
+    {
+        auto const max
+            (static_cast<std::uint64_t> (std::numeric_limits<IntT>::max ()));
+
+        if (not negative || m == 0) {
+            v = static_cast<IntT> (m);
+            return m <= max;
+        } else if (std::is_signed<IntT>::value && m - 1 <= max) {
+            v = static_cast<IntT> (-static_cast<IntT> (m - 1) - 1);
+            return true;
+        } else
+            return false;
+    }
+
+    //
+    // A decimal number
+    //
+    //      [+-]? digit+ ('.' digit+)? ([eE] [+-]? digit+)?
+    //
+    // as the first 19 of its significant digits and the power of ten they
+    // are scaled by; truncated is whether any nonzero digit was left out.
+    // The digits run from first to last (with the point between them), so
+    // that they may be read again where the 19 are not enough.
+    //
+    template <typename It>
+    struct decimal
+    {
+        std::uint64_t mantissa;
+        std::int64_t exponent;
+        std::int64_t fraction_digits;
+        std::int64_t explicit_exponent;
+        bool negative;
+        bool truncated;
+        It first;
+        It last;
+    };
+
+    //
+    // the decimal number at the beginning of [it, e), if there is one; n
+    // is how many tokens it takes up. As the grammar above has it, a point
+    // or exponent marker followed by no digit is not part of the number.
+    //
+    template <typename It>
+    inline bool scan_decimal (It it, It const e, decimal<It>& d,
+                              std::size_t& n) noexcept
+    {
+        using T = typename std::iterator_traits<It>::value_type;
+        using contiguous = core::is_contiguous_byte_iterator<It>;
+
+        d.mantissa = 0;
+        d.exponent = 0;
+        d.fraction_digits = 0;
+        d.explicit_exponent = 0;
+        d.negative = false;
+        d.truncated = false;
+        n = 0;
+
+        if (it != e && (*it == T ('-') || *it == T ('+'))) {
+            d.negative = *it == T ('-');
+            ++it, ++n;
+        }
+        d.first = it;
+
+        std::size_t significant (0);
+        std::uint32_t eight;
+        auto const digits = [&](bool const fraction)
+        {
+            std::size_t k (0);
+            while (it != e) {
+                if (d.mantissa != 0 && significant + 8 <= 19 &&
+                    eight_digits (it, e, eight, contiguous {})) {
+                    d.mantissa = d.mantissa * 100000000 + eight;
+                    significant += 8;
+                    if (fraction)
+                        d.exponent -= 8;
+                    std::advance (it, 8);
+                    k += 8;
+                    continue;
+                } else if (not is_decimal (*it))
+                    break;
+
+                auto const x (static_cast<unsigned> (*it - T ('0')));
+                if (significant < 19) {
+                    if (d.mantissa != 0 || x != 0) {
+                        d.mantissa = d.mantissa * 10 + x;
+                        ++significant;
+                    }
+                    if (fraction)
+                        --d.exponent;
+                } else {
+                    if (not fraction)
+                        ++d.exponent;
+                    d.truncated = d.truncated || x != 0;
+                }
+                ++it, ++k;
+            }
+            return k;
+        };
+
+        auto const whole (digits (false));
+        if (whole == 0)
+            return false;
+        n += whole;
+
+        if (it != e && *it == T ('.')) {
+            auto const next (std::next (it));
+            if (next != e && is_decimal (*next)) {
+                it = next;
+                d.fraction_digits = static_cast<std::int64_t> (digits (true));
+                n += 1 + static_cast<std::size_t> (d.fraction_digits);
+            } else {
+                d.last = it;
+                return true;
+            }
+        }
+        d.last = it;
+
+        if (it != e && (*it == T ('e') || *it == T ('E'))) {
+            auto p (std::next (it));
+            std::size_t k (1);
+            bool negative (false);
+            if (p != e && (*p == T ('-') || *p == T ('+'))) {
+                negative = *p == T ('-');
+                ++p, ++k;
+            }
+            if (p != e && is_decimal (*p)) {
+                std::int64_t x (0);
+                for (; p != e && is_decimal (*p); ++p, ++k)
+                    if (x < 100000000)
+                        x = x * 10 + (*p - T ('0'));
+                d.explicit_exponent = negative ? -x : x;
+                d.exponent += d.explicit_exponent;
+                n += k;
+            }
+        }
+        return true;
+    }
+
+    //
+    // The layout of a binary floating point type, and the bounds within
+    // which a conversion may be made exactly or by Eisel and Lemire's
+    // method; see Lemire, "Number Parsing at a Gigabyte per Second" (2021).
+    //
+    template <typename F>
+    struct binary_format;
+
+    template <>
+    struct binary_format<double>
+    {
+        using bits_type = std::uint64_t;
+
+        static constexpr int mantissa_bits = 52;
+        static constexpr int minimum_exponent = -1023;
+        static constexpr int infinite_power = 0x7ff;
+        static constexpr int sign_bit = 63;
+        static constexpr int smallest_power_of_ten = -342;
+        static constexpr int largest_power_of_ten = 308;
+        static constexpr int min_exponent_round_to_even = -4;
+        static constexpr int max_exponent_round_to_even = 23;
+        static constexpr int max_exact_power = 22;
+        static constexpr std::uint64_t max_exact_mantissa =
+            std::uint64_t (1) << 53;
+
+        static inline double exact_power (int const q) noexcept
+        {
+            static constexpr double powers [] =
+            {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+                1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                1e20, 1e21, 1e22
+            };
+            return powers [q];
+        }
+    };
+
+    template <>
+    struct binary_format<float>
+    {
+        using bits_type = std::uint32_t;
+
+        static constexpr int mantissa_bits = 23;
+        static constexpr int minimum_exponent = -127;
+        static constexpr int infinite_power = 0xff;
+        static constexpr int sign_bit = 31;
+        static constexpr int smallest_power_of_ten = -65;
+        static constexpr int largest_power_of_ten = 38;
+        static constexpr int min_exponent_round_to_even = -17;
+        static constexpr int max_exponent_round_to_even = 10;
+        static constexpr int max_exact_power = 10;
+        static constexpr std::uint64_t max_exact_mantissa =
+            std::uint64_t (1) << 24;
+
+        static inline float exact_power (int const q) noexcept
+        {
+            static constexpr float powers [] =
+            {
+                1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f,
+                1e10f
+            };
+            return powers [q];
+        }
+    };
+
+    struct product_128
+    {
+        std::uint64_t high;
+        std::uint64_t low;
+    };
+
+    inline product_128 multiply_128 (std::uint64_t const a,
+                                     std::uint64_t const b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 uint128;
+        auto const p (static_cast<uint128> (a) * b);
+        return product_128 {static_cast<std::uint64_t> (p >> 64),
+                            static_cast<std::uint64_t> (p)};
+#else
+        std::uint64_t const al (a & 0xffffffff), ah (a >> 32);
+        std::uint64_t const bl (b & 0xffffffff), bh (b >> 32);
+        std::uint64_t const p0 (al * bl), p1 (al * bh);
+        std::uint64_t const p2 (ah * bl), p3 (ah * bh);
+        std::uint64_t const mid
+            ((p0 >> 32) + (p1 & 0xffffffff) + (p2 & 0xffffffff));
+        return product_128
+            {p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32),
+             (mid << 32) | (p0 & 0xffffffff)};
+#endif
+    }
+
+    inline int leading_zeros (std::uint64_t const x) noexcept
+    {
+#if defined(__GNUC__)
+        return __builtin_clzll (x);
+#else
+        int n (0);
+        for (std::uint64_t bit (std::uint64_t (1) << 63); not (x & bit);
+             bit >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    //
+    // The binary significand (without its implicit bit) and biased exponent
+    // of the float nearest to w * 10^q, for w nonzero. w is multiplied by
+    // the 128-bit truncation of 5^q, which decides the rounding for every
+    // w of at most 19 digits; ties to even can only arise for small q.
+    //
+    struct binary_float
+    {
+        std::uint64_t mantissa;
+        int power2;
+
+        friend inline bool operator!= (binary_float const& a,
+                                       binary_float const& b) noexcept
+        {
+            return a.mantissa != b.mantissa || a.power2 != b.power2;
+        }
+    };
+
+    template <typename F>
+    inline binary_float eisel_lemire (std::int64_t const q,
+                                      std::uint64_t w) noexcept
+    {
+        using B = binary_format<F>;
+
+        if (w == 0 || q < B::smallest_power_of_ten)
+            return binary_float {0, 0};
+        else if (q > B::largest_power_of_ten)
+            return binary_float {0, B::infinite_power};
+
+        int const lz (leading_zeros (w));
+        w <<= lz;
+
+        auto const index (2 * static_cast<int> (q - smallest_power_of_five));
+        auto const precision_mask
+            (std::uint64_t (0xffffffffffffffff) >> (B::mantissa_bits + 3));
+        auto product (multiply_128 (w, power_of_five_128 [index]));
+        if ((product.high & precision_mask) == precision_mask) {
+            auto const low (multiply_128 (w, power_of_five_128 [index + 1]));
+            product.low += low.high;
+            if (low.high > product.low)
+                ++product.high;
+        }
+
+        int const upper (static_cast<int> (product.high >> 63));
+        int const shift (upper + 64 - B::mantissa_bits - 3);
+        binary_float f
+        {
+            product.high >> shift,
+            static_cast<int> ((((152170 + 65536) * q) >> 16) + 63) + upper -
+                lz - B::minimum_exponent
+        };
+
+        if (f.power2 <= 0) {
+            if (-f.power2 + 1 >= 64)
+                return binary_float {0, 0};
+            f.mantissa >>= -f.power2 + 1;
+            f.mantissa += f.mantissa & 1;
+            f.mantissa >>= 1;
+            f.power2 =
+                f.mantissa < (std::uint64_t (1) << B::mantissa_bits) ? 0 : 1;
+            return f;
+        }
+
+        if (product.low <= 1 &&
+            q >= B::min_exponent_round_to_even &&
+            q <= B::max_exponent_round_to_even &&
+            (f.mantissa & 3) == 1 &&
+            (f.mantissa << shift) == product.high)
+            f.mantissa &= ~std::uint64_t (1);
+
+        f.mantissa += f.mantissa & 1;
+        f.mantissa >>= 1;
+        if (f.mantissa >= (std::uint64_t (2) << B::mantissa_bits)) {
+            f.mantissa = std::uint64_t (1) << B::mantissa_bits;
+            ++f.power2;
+        }
+        f.mantissa &= ~(std::uint64_t (1) << B::mantissa_bits);
+        if (f.power2 >= B::infinite_power)
+            return binary_float {0, B::infinite_power};
+        return f;
+    }
+
+    //
+    // the number as a string of its digits and a power of ten (so with no
+    // point, whose character the locale would decide), for strtod and the
+    // like; only made where the first 19 digits do not decide the result.
+    //
+    template <typename It>
+    inline std::string decimal_string (decimal<It> const& d)
+    {
+        using T = typename std::iterator_traits<It>::value_type;
+
+        std::string s (d.negative ? "-" : "");
+        for (auto it (d.first); it != d.last; ++it)
+            if (is_decimal (*it))
+                s.push_back (static_cast<char> ('0' + (*it - T ('0'))));
+        s += "e" + std::to_string (d.explicit_exponent - d.fraction_digits);
+        return s;
+    }
+
+    inline void from_string (std::string const& s, float& v)
+    {
+        v = std::strtof (s.c_str (), nullptr);
+    }
+
+    inline void from_string (std::string const& s, double& v)
+    {
+        v = std::strtod (s.c_str (), nullptr);
+    }
+
+    inline void from_string (std::string const& s, long double& v)
+    {
+        v = std::strtold (s.c_str (), nullptr);
+    }
+
+    //
+    // The float nearest to a decimal number. Where the mantissa and the
+    // power of ten are both exact in F, it is their product (or quotient),
+    // correctly rounded by the hardware. Otherwise Eisel-Lemire decides it
+    // from the first 19 digits, and where they were truncated and both they
+    // and the next number up do not round alike, the whole is converted by
+    // the C library.
+    //
+    template <typename F, typename It>
+    inline F to_floating (decimal<It> const& d)
+    {
+        using B = binary_format<F>;
+        using bits_type = typename B::bits_type;
+
+        if (d.mantissa == 0)
+            return d.negative ? -F (0) : F (0);
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+        if (not d.truncated &&
+            d.exponent >= -B::max_exact_power &&
+            d.exponent <= B::max_exact_power &&
+            d.mantissa <= B::max_exact_mantissa) {
+            auto v (static_cast<F> (d.mantissa));
+            if (d.exponent < 0)
+                v = v / B::exact_power (static_cast<int> (-d.exponent));
+            else
+                v = v * B::exact_power (static_cast<int> (d.exponent));
+            return d.negative ? -v : v;
+        }
+#endif
+
+        auto const f (eisel_lemire<F> (d.exponent, d.mantissa));
+        if (d.truncated && f != eisel_lemire<F> (d.exponent, d.mantissa + 1)) {
+            F v;
+            from_string (decimal_string (d), v);
+            return v;
+        }
+
+        auto const bits
+            (static_cast<bits_type> (f.mantissa) |
+             (static_cast<bits_type> (f.power2) << B::mantissa_bits) |
+             (static_cast<bits_type> (d.negative) << B::sign_bit));
+        F v;
+        std::memcpy (&v, &bits, sizeof (v));
+        return v;
+    }
+
+    //
+    // long double is converted as double where it is the same; otherwise,
+    // with a 64-bit significand, the product of a mantissa and a power of
+    // ten up to 10^27 (5^27 < 2^64) is exact, and anything else is left to
+    // strtold.
+    //
+    template <typename It>
+    inline long double to_long_double (decimal<It> const& d)
+    {
+        if (LDBL_MANT_DIG == 53)
+            return to_floating<double> (d);
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD >= 0
+        if (LDBL_MANT_DIG >= 64 && not d.truncated &&
+            d.exponent >= -27 && d.exponent <= 27) {
+            long double p (1);
+            for (auto q (d.exponent < 0 ? -d.exponent : d.exponent); q > 0;
+                 --q)
+                p *= 10;
+            auto v (static_cast<long double> (d.mantissa));
+            v = d.exponent < 0 ? v / p : v * p;
+            return d.negative ? -v : v;
+        }
+#endif
+
+        long double v;
+        from_string (decimal_string (d), v);
+        return v;
+    }
+} // namespace detail
+} // namespace basic
+} // namespace rpc
+
+#endif // ifndef NUMERIC_CONVERSION_HPP
@@ -9,14 +9,18 @@
 #ifndef NUMERIC_PARSERS_HPP
 #define NUMERIC_PARSERS_HPP
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
-#include <locale>
 #include <string>
 
+#include "core/char_class.hpp"
 #include "core/parser.hpp"
 #include "core/combinators.hpp"
 #include "core/token_parsers.hpp"
 
+#include "numeric_conversion.hpp"
 #include "text_parsers.hpp"
 
 #include "funktional/include/eval.hpp"
@@ -28,66 +32,70 @@ namespace basic
 {
 namespace detail
 {
+    //
+    // The text of numbers, as strings copied out of the input or (with
+    // S = core::slice<It>) views of it; a signed or decimal one is the run
+    // of input its parts consumed, but for the + of a natural.
+    //
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
-              typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> natural_str =
+              typename R = core::range<It>,
+              typename S = std::basic_string<T>>
+    core::parser<It, S, R> natural_str =
         core::override_description
-            (core::reducel
-                (basic::digits<It, T, R>,
-                [](T c, std::basic_string<T> & s)
-                    { s.push_back (c); return s; },
-                std::basic_string<T>()),
+            (core::take_while1<It, T, R, S>
+                (core::class_predicate {core::char_class::digit},
+                "digit character"),
             "[natural]");
 
 
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
-              typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> plus_natural_str =
+              typename R = core::range<It>,
+              typename S = std::basic_string<T>>
+    core::parser<It, S, R> plus_natural_str =
         core::override_description
             (core::ignorel
                 (core::token<It, T, R> ('+'),
-                natural_str<It, T, R>),
+                natural_str<It, T, R, S>),
             "[(+) natural]");
 
 
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
-              typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> minus_natural_str = 
+              typename R = core::range<It>,
+              typename S = std::basic_string<T>>
+    core::parser<It, S, R> minus_natural_str =
         core::override_description
-            (core::reduce
-                (core::sequence
-                    (core::inject
-                        (basic::character<It, T, R> ('-'),
-                         std::basic_string<T> (1, '-')),
-                    natural_str<It, T, R>)),
+            (core::recognize<S>
+                (core::ignorel
+                    (basic::character<It, T, R> ('-'),
+                    natural_str<It, T, R, S>)),
             "[(-) natural]");
 
 
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
-              typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> decimal_str =
+              typename R = core::range<It>,
+              typename S = std::basic_string<T>>
+    core::parser<It, S, R> decimal_str =
         core::override_description
-            (core::reduce
-                (core::sequence
-                    (core::inject
-                        (basic::character<It, T, R>('.'),
-                         std::basic_string<T> (1, '.')),
-                    natural_str<It, T, R>)),
+            (core::recognize<S>
+                (core::ignorel
+                    (basic::character<It, T, R> ('.'),
+                    natural_str<It, T, R, S>)),
             "[decimal]");
 
 
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
-              typename R = core::range<It>>
+              typename R = core::range<It>,
+              typename S = std::basic_string<T>>
     auto number_str =
         core::option
-            (natural_str<It, T, R>,
-            minus_natural_str<It, T, R>,
-            plus_natural_str<It, T, R>);
+            (natural_str<It, T, R, S>,
+            minus_natural_str<It, T, R, S>,
+            plus_natural_str<It, T, R, S>);
 
 
      template <typename It,
@@ -117,6 +125,170 @@ namespace detail
                     core::optional (exponent_str<It, T, R>,
                                         std::basic_string<T> ()))),
             "[(+/-) float]");
+
+    //
+    // The numeric parsers read their numbers straight from the range, in
+    // one pass over its tokens, and make their values as they go, with no
+    // string in between and no regard to the locale. A number out of the
+    // range of the value type is a failure, at the beginning of the number.
+    //
+    template <typename It, typename T, typename R, typename V, unsigned base>
+    inline core::parser<It, V, R> make_natural (std::string const& dsc)
+    {
+        using A = typename core::parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        core::description const described (dsc);
+        auto const expected_item (core::expect_item<T> ());
+        auto const expected (core::expect (described));
+        core::failure const out_of_range
+            (core::fixed_message (dsc + " out of range"));
+
+        using token_type = typename std::iterator_traits<It>::value_type;
+        auto const first
+            (core::first_of<token_type>
+                ([](token_type const& c) { return digit_value (c) < base; },
+                 core::is_byte_token<token_type> {}));
+
+        return core::parser<It, V, R>
+        {
+            .description = described,
+            .parse =
+            [=](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                std::size_t n;
+                bool overflow;
+                auto const m (scan_natural<base>
+                    (rng.begin (), rng.end (), n, overflow));
+
+                V v;
+                if (n == 0)
+                    acc->insert
+                        (core::failure
+                            {rng.empty () ? expected_item : expected},
+                         rng);
+                else if (overflow || not to_integer (m, false, v))
+                    acc->insert (out_of_range, rng);
+                else
+                    acc->insert (core::parse_result<V> {v}, rng.tail (n));
+                return acc;
+            },
+            .lookahead = first
+        };
+    }
+
+    template <typename It, typename T, typename R, typename V, unsigned base>
+    inline core::parser<It, V, R> make_integer (std::string const& dsc)
+    {
+        using A = typename core::parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        core::description const described (dsc);
+        auto const expected_item (core::expect_item<T> ());
+        auto const expected (core::expect (described));
+        core::failure const out_of_range
+            (core::fixed_message (dsc + " out of range"));
+
+        using token_type = typename std::iterator_traits<It>::value_type;
+        auto const first
+            (core::first_of<token_type>
+                ([](token_type const& c)
+                 {
+                    return digit_value (c) < base ||
+                           c == token_type ('-') || c == token_type ('+');
+                 },
+                 core::is_byte_token<token_type> {}));
+
+        return core::parser<It, V, R>
+        {
+            .description = described,
+            .parse =
+            [=](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                auto it (rng.begin ());
+                std::size_t sign (0);
+                bool negative (false);
+                if (it != rng.end () &&
+                    (*it == token_type ('-') || *it == token_type ('+'))) {
+                    negative = *it == token_type ('-');
+                    ++it, ++sign;
+                }
+
+                std::size_t n;
+                bool overflow;
+                auto const m (scan_natural<base> (it, rng.end (), n, overflow));
+
+                V v;
+                if (n == 0)
+                    acc->insert
+                        (core::failure
+                            {rng.empty () ? expected_item : expected},
+                         rng);
+                else if (overflow || not to_integer (m, negative, v))
+                    acc->insert (out_of_range, rng);
+                else
+                    acc->insert
+                        (core::parse_result<V> {v}, rng.tail (sign + n));
+                return acc;
+            },
+            .lookahead = first
+        };
+    }
+
+    template <typename It, typename T, typename R, typename V,
+              typename Convert>
+    inline core::parser<It, V, R> make_floating (Convert const& convert,
+                                                 std::string const& dsc)
+    {
+        using A = typename core::parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        core::description const described (dsc);
+        auto const expected_item (core::expect_item<T> ());
+        auto const expected (core::expect (described));
+        core::failure const out_of_range
+            (core::fixed_message (dsc + " out of range"));
+
+        using token_type = typename std::iterator_traits<It>::value_type;
+        auto const first
+            (core::first_of<token_type>
+                ([](token_type const& c)
+                 {
+                    return is_decimal (c) ||
+                           c == token_type ('-') || c == token_type ('+');
+                 },
+                 core::is_byte_token<token_type> {}));
+
+        return core::parser<It, V, R>
+        {
+            .description = described,
+            .parse =
+            [=](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                decimal<It> d;
+                std::size_t n;
+
+                if (not scan_decimal (rng.begin (), rng.end (), d, n)) {
+                    acc->insert
+                        (core::failure
+                            {rng.empty () ? expected_item : expected},
+                         rng);
+                    return acc;
+                }
+
+                V const v (convert (d));
+                if (std::isinf (v))
+                    acc->insert (out_of_range, rng);
+                else
+                    acc->insert (core::parse_result<V> {v}, rng.tail (n));
+                return acc;
+            },
+            .lookahead = first
+        };
+    }
 } // namespace detail
 
     template <typename It,
@@ -174,12 +346,8 @@ namespace detail
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>, int base = 10>
-    core::parser<It, unsigned long, R> natural = core::override_description
-        (core::lift
-            (detail::natural_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> unsigned long
-                { return std::stoul (s, nullptr, base); }),
-        "[nautral]");
+    core::parser<It, unsigned long, R> natural =
+        detail::make_natural<It, T, R, unsigned long, base> ("[natural]");
 
 
     template <typename It,
@@ -200,12 +368,8 @@ namespace detail
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>, int base = 10>
     core::parser<It, unsigned long long, R> lnatural =
-        core::override_description
-            (core::lift
-                (detail::natural_str<It, T, R>,
-                [](std::basic_string<T> const& s) -> unsigned long long
-                    { return std::stoull (s, nullptr, base); }),
-            "[long natural]");
+        detail::make_natural<It, T, R, unsigned long long, base>
+            ("[long natural]");
 
 
     template <typename It,
@@ -225,12 +389,8 @@ namespace detail
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>, int base = 10>
-    core::parser<It, int, R> integer = core::override_description
-        (core::lift
-            (detail::number_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> int
-                { return std::stoi (s, nullptr, base); }),
-        "[integer]");
+    core::parser<It, int, R> integer =
+        detail::make_integer<It, T, R, int, base> ("[integer]");
 
 
     template <typename It,
@@ -248,12 +408,8 @@ namespace detail
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>, int base = 10>
-    core::parser<It, long, R> linteger = core::override_description
-        (core::lift
-            (detail::number_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> long
-                { return std::stol (s, nullptr, base); }),
-        "[long integer]");
+    core::parser<It, long, R> linteger =
+        detail::make_integer<It, T, R, long, base> ("[long integer]");
  
 
     template <typename It,
@@ -271,12 +427,9 @@ namespace detail
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>, int base = 10>   
-    core::parser<It, long long, R> llinteger = core::override_description
-        (core::lift
-            (detail::number_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> long long
-                { return std::stoll(s, nullptr, base); }),
-        "[long long integer]");
+    core::parser<It, long long, R> llinteger =
+        detail::make_integer<It, T, R, long long, base>
+            ("[long long integer]");
 
 
     template <typename It,
@@ -296,12 +449,11 @@ namespace detail
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
               typename R = core::range<It>>
-    core::parser<It, float, R> floating = core::override_description
-        (core::lift
-            (detail::floating_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> float
-                { return std::stof(s, nullptr); }),
-        "[float]");
+    core::parser<It, float, R> floating =
+        detail::make_floating<It, T, R, float>
+            ([](detail::decimal<It> const& d)
+                { return detail::to_floating<float> (d); },
+             "[float]");
 
 
     template <typename It,
@@ -319,12 +471,11 @@ namespace detail
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
               typename R = core::range<It>>   
-    core::parser<It, double, R> lfloating = core::override_description
-        (core::lift
-            (detail::floating_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> double
-                { return std::stod(s, nullptr); }),
-        "[double]");
+    core::parser<It, double, R> lfloating =
+        detail::make_floating<It, T, R, double>
+            ([](detail::decimal<It> const& d)
+                { return detail::to_floating<double> (d); },
+             "[double]");
 
 
     template <typename It,
@@ -342,12 +493,11 @@ namespace detail
     template <typename It,
               typename T = typename std::iterator_traits<It>::value_type,
               typename R = core::range<It>>   
-    core::parser<It, long double, R> llfloating = core::override_description
-        (core::lift
-            (detail::floating_str<It, T, R>,
-            [](std::basic_string<T> const& s) -> long double
-                { return std::stold(s, nullptr); }),
-        "[long double]");
+    core::parser<It, long double, R> llfloating =
+        detail::make_floating<It, T, R, long double>
+            ([](detail::decimal<It> const& d)
+                { return detail::to_long_double (d); },
+             "[long double]");
 
 
     template <typename It,
@@ -0,0 +1,889 @@
+//
+// Regular expressions compiled into automata finding the longest match at
+// the beginning of a range
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef REGEX_AUTOMATON_HPP
+#define REGEX_AUTOMATON_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/first_set.hpp"
+
+namespace rpc
+{
+namespace basic
+{
+namespace detail
+{
+    using code_unit = std::uint32_t;
+
+    //
+    // A set of code units, as sorted and disjoint closed intervals.
+    //
+    struct unit_set
+    {
+    public:
+        static inline unit_set of (code_unit const lo, code_unit const hi)
+        {
+            unit_set s;
+            s.add (lo, hi);
+            return s;
+        }
+
+        inline void add (code_unit const lo, code_unit const hi)
+        {
+            if (lo <= hi) {
+                ranges_.emplace_back (lo, hi);
+                normalize ();
+            }
+        }
+
+        inline void add (unit_set const& s)
+        {
+            ranges_.insert (ranges_.end (), s.ranges_.begin (),
+                            s.ranges_.end ());
+            normalize ();
+        }
+
+        inline bool contains (code_unit const u) const noexcept
+        {
+            auto const it (std::upper_bound
+                (ranges_.begin (), ranges_.end (),
+                 std::make_pair (u, std::numeric_limits<code_unit>::max ())));
+            return it != ranges_.begin () && std::prev (it)->second >= u;
+        }
+
+        inline bool single (void) const noexcept
+        {
+            return ranges_.size () == 1 &&
+                   ranges_.front ().first == ranges_.front ().second;
+        }
+
+        inline code_unit front (void) const noexcept
+        {
+            return ranges_.front ().first;
+        }
+
+        //
+        // the units from 0 to max which are not in the set.
+        //
+        inline unit_set complement (code_unit const max) const
+        {
+            unit_set s;
+            code_unit next (0);
+            for (auto const& r : ranges_) {
+                if (r.first > max)
+                    break;
+                else if (r.first > next)
+                    s.ranges_.emplace_back (next, r.first - 1);
+
+                if (r.second >= max)
+                    return s;
+                next = r.second + 1;
+            }
+            s.ranges_.emplace_back (next, max);
+            return s;
+        }
+
+        //
+        // add the other case of each ASCII letter in the set.
+        //
+        inline void fold_case (void)
+        {
+            auto const shift (code_unit ('a' - 'A'));
+            auto const rs (ranges_);
+            for (auto const& r : rs) {
+                auto const lo (std::max (r.first, code_unit ('a')));
+                auto const hi (std::min (r.second, code_unit ('z')));
+                if (lo <= hi)
+                    ranges_.emplace_back (lo - shift, hi - shift);
+
+                auto const ulo (std::max (r.first, code_unit ('A')));
+                auto const uhi (std::min (r.second, code_unit ('Z')));
+                if (ulo <= uhi)
+                    ranges_.emplace_back (ulo + shift, uhi + shift);
+            }
+            normalize ();
+        }
+
+        //
+        // the units at which membership in the set changes, up to max.
+        //
+        inline void bounds (std::vector<code_unit>& b, code_unit const max)
+            const
+        {
+            for (auto const& r : ranges_) {
+                b.push_back (r.first);
+                if (r.second < max)
+                    b.push_back (r.second + 1);
+            }
+        }
+
+    private:
+        inline void normalize (void)
+        {
+            std::sort (ranges_.begin (), ranges_.end ());
+
+            std::size_t n (0);
+            for (std::size_t i (1); i < ranges_.size (); ++i) {
+                auto& last (ranges_ [n]);
+                if (last.second == std::numeric_limits<code_unit>::max () ||
+                    ranges_ [i].first <= last.second + 1)
+                    last.second = std::max (last.second, ranges_ [i].second);
+                else
+                    ranges_ [++n] = ranges_ [i];
+            }
+            if (not ranges_.empty ())
+                ranges_.resize (n + 1);
+        }
+
+        std::vector<std::pair<code_unit, code_unit>> ranges_;
+    };
+
+    struct regex_fragment
+    {
+        std::vector<std::uint32_t> first;
+        std::vector<std::uint32_t> last;
+        bool nullable;
+    };
+
+    //
+    // The position (Glushkov) automaton of a pattern in the syntax of
+    // ECMAScript: a state for each set of code units the pattern matches
+    // one of, with the states which may follow it; state 0 is the start.
+    // It is built by descent over the pattern, and a counted repetition
+    // parses its atom again for each copy it needs. The rest of the syntax
+    // (anchors but a leading ^, assertions, back references, lazy
+    // quantifiers, named classes) leaves it unbuilt, so that the pattern is
+    // given to std::regex instead.
+    //
+    template <typename T>
+    class regex_positions
+    {
+    public:
+        using unit_type = typename std::make_unsigned<T>::type;
+
+        static constexpr code_unit max_unit =
+            std::numeric_limits<unit_type>::max ();
+
+        regex_positions (std::basic_string<T> const& pattern, bool const icase)
+            : pattern_ (pattern)
+            , icase_ (icase)
+            , at_ (0)
+            , ok_ (true)
+            , sets_ (1)
+            , follow_ (1)
+        {
+            if (peek ('^'))
+                ++at_;
+
+            auto const whole (alternation ());
+            if (at_ != pattern_.size ())
+                ok_ = false;
+            if (not ok_)
+                return;
+
+            link ({0}, whole.first);
+            final_ = whole.last;
+            if (whole.nullable)
+                final_.push_back (0);
+
+            for (auto& f : follow_) {
+                std::sort (f.begin (), f.end ());
+                f.erase (std::unique (f.begin (), f.end ()), f.end ());
+            }
+        }
+
+        inline bool built (void) const noexcept
+        {
+            return ok_;
+        }
+
+        inline std::size_t size (void) const noexcept
+        {
+            return sets_.size ();
+        }
+
+        inline unit_set const& set (std::size_t const p) const noexcept
+        {
+            return sets_ [p];
+        }
+
+        inline std::vector<std::uint32_t> const& follow (std::size_t const p)
+            const noexcept
+        {
+            return follow_ [p];
+        }
+
+        inline std::vector<std::uint32_t> const& final (void) const noexcept
+        {
+            return final_;
+        }
+
+    private:
+        static constexpr std::size_t max_positions = 1 << 14;
+        static constexpr std::size_t max_repeat = 1000;
+        static constexpr std::size_t unbounded =
+            std::numeric_limits<std::size_t>::max ();
+
+        inline bool peek (char const c) const noexcept
+        {
+            return at_ < pattern_.size () && pattern_ [at_] == T (c);
+        }
+
+        inline code_unit unit (T const& t) const noexcept
+        {
+            return static_cast<code_unit> (static_cast<unit_type> (t));
+        }
+
+        inline regex_fragment alternation (void)
+        {
+            auto f (sequence ());
+            while (ok_ && peek ('|')) {
+                ++at_;
+                auto const g (sequence ());
+                f = either (f, g);
+            }
+            return f;
+        }
+
+        inline regex_fragment sequence (void)
+        {
+            auto f (empty ());
+            while (ok_ && at_ < pattern_.size () && not peek ('|') &&
+                   not peek (')')) {
+                auto const g (quantified ());
+                f = then (f, g);
+            }
+            return f;
+        }
+
+        inline regex_fragment quantified (void)
+        {
+            auto const begin (at_);
+            auto const f (atom ());
+            if (not ok_ || at_ == pattern_.size ())
+                return f;
+
+            std::size_t lo (0), hi (unbounded);
+            if (peek ('{')) {
+                if (not counts (lo, hi))
+                    return fail ();
+            } else if (peek ('*') || peek ('+') || peek ('?')) {
+                if (peek ('+'))
+                    lo = 1;
+                else if (peek ('?'))
+                    hi = 1;
+                ++at_;
+            } else
+                return f;
+
+            if (peek ('?') || peek ('*') || peek ('+') || peek ('{'))
+                return fail ();
+            return repeat (f, begin, lo, hi);
+        }
+
+        //
+        // lo to hi copies of the atom f, parsed first at begin; the last is
+        // starred (or plussed) if there is no upper bound, and those after
+        // the first lo are optional.
+        //
+        inline regex_fragment repeat (regex_fragment const& f,
+                                      std::size_t const begin,
+                                      std::size_t const lo,
+                                      std::size_t const hi)
+        {
+            auto const after (at_);
+            auto const copies (hi == unbounded ? std::max<std::size_t> (lo, 1)
+                                               : hi);
+            if (copies > max_repeat)
+                return fail ();
+
+            auto r (empty ());
+            for (std::size_t i (0); ok_ && i < copies; ++i) {
+                at_ = begin;
+                auto g (i == 0 ? f : atom ());
+                if (hi == unbounded && i + 1 == copies)
+                    g = lo == 0 ? star (g) : plus (g);
+                else if (i >= lo)
+                    g.nullable = true;
+                r = then (r, g);
+            }
+            at_ = after;
+            return r;
+        }
+
+        inline bool counts (std::size_t& lo, std::size_t& hi)
+        {
+            ++at_;
+            if (not number (lo))
+                return false;
+
+            if (peek (',')) {
+                ++at_;
+                if (peek ('}'))
+                    hi = unbounded;
+                else if (not number (hi) || hi < lo)
+                    return false;
+            } else
+                hi = lo;
+
+            if (not peek ('}'))
+                return false;
+            ++at_;
+            return true;
+        }
+
+        inline bool number (std::size_t& n)
+        {
+            auto const begin (at_);
+            n = 0;
+            while (at_ < pattern_.size () && pattern_ [at_] >= T ('0') &&
+                   pattern_ [at_] <= T ('9') && n <= max_repeat)
+                n = n * 10 + static_cast<std::size_t>
+                    (pattern_ [at_++] - T ('0'));
+            return at_ != begin;
+        }
+
+        inline regex_fragment atom (void)
+        {
+            if (at_ == pattern_.size ())
+                return fail ();
+
+            auto const c (pattern_ [at_++]);
+            if (c == T ('(')) {
+                if (peek ('?')) {
+                    if (at_ + 1 < pattern_.size () &&
+                        pattern_ [at_ + 1] == T (':'))
+                        at_ += 2;
+                    else
+                        return fail ();
+                }
+
+                auto const f (alternation ());
+                if (not ok_ || not peek (')'))
+                    return fail ();
+                ++at_;
+                return f;
+            } else if (c == T ('[')) {
+                auto const s (bracket ());
+                return ok_ ? position (s) : fail ();
+            } else if (c == T ('.')) {
+                unit_set s;
+                s.add (code_unit ('\n'), code_unit ('\n'));
+                s.add (code_unit ('\r'), code_unit ('\r'));
+                s.add (0x2028, 0x2029);
+                return position (s.complement (max_unit));
+            } else if (c == T ('\\')) {
+                unit_set s;
+                return escape (s, false) ? position (s) : fail ();
+            } else if (c == T ('*') || c == T ('+') || c == T ('?') ||
+                       c == T ('{') || c == T ('}') || c == T (']') ||
+                       c == T ('^') || c == T ('$'))
+                return fail ();
+            else
+                return position (unit_set::of (unit (c), unit (c)));
+        }
+
+        //
+        // the set of an escape, after its backslash; in a class \b is a
+        // backspace, elsewhere an assertion.
+        //
+        inline bool escape (unit_set& s, bool const in_class)
+        {
+            if (at_ == pattern_.size ())
+                return false;
+
+            auto const digits (unit_set::of ('0', '9'));
+            auto word (digits);
+            word.add ('A', 'Z');
+            word.add ('a', 'z');
+            word.add ('_', '_');
+            auto space (unit_set::of ('\t', '\r'));
+            space.add (' ', ' ');
+
+            auto const c (pattern_ [at_++]);
+            code_unit u (0);
+            if (c == T ('d'))
+                s = digits;
+            else if (c == T ('D'))
+                s = digits.complement (max_unit);
+            else if (c == T ('w'))
+                s = word;
+            else if (c == T ('W'))
+                s = word.complement (max_unit);
+            else if (c == T ('s'))
+                s = space;
+            else if (c == T ('S'))
+                s = space.complement (max_unit);
+            else if (c == T ('t'))
+                s = unit_set::of ('\t', '\t');
+            else if (c == T ('n'))
+                s = unit_set::of ('\n', '\n');
+            else if (c == T ('v'))
+                s = unit_set::of ('\v', '\v');
+            else if (c == T ('f'))
+                s = unit_set::of ('\f', '\f');
+            else if (c == T ('r'))
+                s = unit_set::of ('\r', '\r');
+            else if (c == T ('b') && in_class)
+                s = unit_set::of ('\b', '\b');
+            else if (c == T ('0') &&
+                     not (at_ < pattern_.size () &&
+                          pattern_ [at_] >= T ('0') &&
+                          pattern_ [at_] <= T ('9')))
+                s = unit_set::of (0, 0);
+            else if (c == T ('x') && hex (2, u))
+                s = unit_set::of (u, u);
+            else if (c == T ('u') && hex (4, u))
+                s = unit_set::of (u, u);
+            else if ((c >= T ('0') && c <= T ('9')) ||
+                     (c >= T ('A') && c <= T ('Z')) ||
+                     (c >= T ('a') && c <= T ('z')))
+                return false;
+            else
+                s = unit_set::of (unit (c), unit (c));
+            return true;
+        }
+
+        inline bool hex (std::size_t const n, code_unit& u)
+        {
+            u = 0;
+            for (std::size_t i (0); i < n; ++i, ++at_) {
+                if (at_ == pattern_.size ())
+                    return false;
+
+                auto const c (pattern_ [at_]);
+                if (c >= T ('0') && c <= T ('9'))
+                    u = u * 16 + unit (c) - '0';
+                else if (c >= T ('a') && c <= T ('f'))
+                    u = u * 16 + unit (c) - 'a' + 10;
+                else if (c >= T ('A') && c <= T ('F'))
+                    u = u * 16 + unit (c) - 'A' + 10;
+                else
+                    return false;
+            }
+            return true;
+        }
+
+        //
+        // a class in brackets, after its [; a range has single units at
+        // both ends, and a - first or last is itself.
+        //
+        inline unit_set bracket (void)
+        {
+            unit_set s;
+            bool const negated (peek ('^'));
+            if (negated)
+                ++at_;
+            if (peek (']')) {
+                ok_ = false;
+                return s;
+            }
+
+            while (not peek (']')) {
+                unit_set a;
+                if (not class_atom (a)) {
+                    ok_ = false;
+                    return s;
+                }
+
+                if (peek ('-') && at_ + 1 < pattern_.size () &&
+                    pattern_ [at_ + 1] != T (']')) {
+                    ++at_;
+                    unit_set b;
+                    if (not class_atom (b) || not a.single () ||
+                        not b.single () || b.front () < a.front ()) {
+                        ok_ = false;
+                        return s;
+                    }
+                    s.add (a.front (), b.front ());
+                } else
+                    s.add (a);
+            }
+            ++at_;
+
+            if (icase_)
+                s.fold_case ();
+            return negated ? s.complement (max_unit) : s;
+        }
+
+        inline bool class_atom (unit_set& a)
+        {
+            if (at_ == pattern_.size ())
+                return false;
+
+            auto const c (pattern_ [at_++]);
+            if (c == T ('\\'))
+                return escape (a, true);
+            else if (c == T ('[') && (peek (':') || peek ('.') || peek ('=')))
+                return false;
+
+            a = unit_set::of (unit (c), unit (c));
+            return true;
+        }
+
+        inline regex_fragment position (unit_set s)
+        {
+            if (sets_.size () == max_positions)
+                return fail ();
+            if (icase_)
+                s.fold_case ();
+
+            auto const p (static_cast<std::uint32_t> (sets_.size ()));
+            sets_.push_back (std::move (s));
+            follow_.emplace_back ();
+            return regex_fragment {{p}, {p}, false};
+        }
+
+        static inline regex_fragment empty (void)
+        {
+            return regex_fragment {{}, {}, true};
+        }
+
+        inline regex_fragment fail (void)
+        {
+            ok_ = false;
+            return empty ();
+        }
+
+        inline void link (std::vector<std::uint32_t> const& from,
+                          std::vector<std::uint32_t> const& to)
+        {
+            for (auto const p : from)
+                follow_ [p].insert (follow_ [p].end (), to.begin (), to.end ());
+        }
+
+        inline regex_fragment then (regex_fragment const& a,
+                                    regex_fragment const& b)
+        {
+            link (a.last, b.first);
+
+            regex_fragment r {a.first, b.last, a.nullable && b.nullable};
+            if (a.nullable)
+                r.first.insert (r.first.end (), b.first.begin (),
+                                b.first.end ());
+            if (b.nullable)
+                r.last.insert (r.last.end (), a.last.begin (), a.last.end ());
+            return r;
+        }
+
+        static inline regex_fragment either (regex_fragment a,
+                                             regex_fragment const& b)
+        {
+            a.first.insert (a.first.end (), b.first.begin (), b.first.end ());
+            a.last.insert (a.last.end (), b.last.begin (), b.last.end ());
+            a.nullable = a.nullable || b.nullable;
+            return a;
+        }
+
+        inline regex_fragment star (regex_fragment f)
+        {
+            f = plus (f);
+            f.nullable = true;
+            return f;
+        }
+
+        inline regex_fragment plus (regex_fragment const& f)
+        {
+            link (f.last, f.first);
+            return f;
+        }
+
+        std::basic_string<T> const& pattern_;
+        bool icase_;
+        std::size_t at_;
+        bool ok_;
+        std::vector<unit_set> sets_;
+        std::vector<std::vector<std::uint32_t>> follow_;
+        std::vector<std::uint32_t> final_;
+    };
+
+    template <typename T>
+    constexpr code_unit regex_positions<T>::max_unit;
+
+    template <typename T>
+    constexpr std::size_t regex_positions<T>::max_positions;
+
+    template <typename T>
+    constexpr std::size_t regex_positions<T>::max_repeat;
+
+    template <typename T>
+    constexpr std::size_t regex_positions<T>::unbounded;
+
+    inline unsigned lowest_bit (std::uint64_t const x) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned> (__builtin_ctzll (x));
+#else
+        unsigned n (0);
+        while (not (x & (std::uint64_t (1) << n)))
+            ++n;
+        return n;
+#endif
+    }
+
+    //
+    // The longest match of a pattern at the beginning of a range. Code units
+    // are mapped to classes first, two units sharing a class where no set of
+    // the pattern tells them apart: by a table for units below 256, and by
+    // a search of the bounds of the classes above. The DFA of the position
+    // automaton is then built in full, a row of its table for each state,
+    // when the automaton is made rather than as states are reached, so
+    // that matching never writes to it and threads may share it.
+    // Past a bound on its size, the position automaton itself is run with a
+    // bit of a word for each position, if there are no more than 64 of
+    // them; otherwise the pattern is not built at all.
+    //
+    template <typename T>
+    class regex_automaton
+    {
+    public:
+        using unit_type = typename std::make_unsigned<T>::type;
+
+        regex_automaton (std::basic_string<T> const& pattern,
+                         bool const icase)
+            : engine_ (engine::NONE)
+            , classes_ (0)
+            , final_bits_ (0)
+        {
+            regex_positions<T> const positions (pattern, icase);
+            if (not positions.built () || not partition (positions))
+                return;
+            else if (build_dfa (positions))
+                engine_ = engine::DFA;
+            else if (build_bits (positions))
+                engine_ = engine::BITS;
+        }
+
+        inline bool built (void) const noexcept
+        {
+            return engine_ != engine::NONE;
+        }
+
+        //
+        // the length of the longest match at the beginning of [it, e), or
+        // -1 if there is none.
+        //
+        template <typename It>
+        inline std::ptrdiff_t match (It it, It const e) const
+        {
+            std::ptrdiff_t n (0), found (-1);
+            if (engine_ == engine::DFA) {
+                std::int32_t s (0);
+                if (accept_ [0])
+                    found = 0;
+                for (; it != e; ++it) {
+                    s = delta_ [static_cast<std::size_t> (s) * classes_ +
+                                classify (*it)];
+                    if (s < 0)
+                        break;
+                    ++n;
+                    if (accept_ [static_cast<std::size_t> (s)])
+                        found = n;
+                }
+            } else {
+                std::uint64_t live (1);
+                if (final_bits_ & live)
+                    found = 0;
+                for (; it != e; ++it) {
+                    std::uint64_t reach (0);
+                    for (auto m (live); m; m &= m - 1)
+                        reach |= follow_bits_ [lowest_bit (m)];
+                    live = reach & class_bits_ [classify (*it)];
+                    if (not live)
+                        break;
+                    ++n;
+                    if (live & final_bits_)
+                        found = n;
+                }
+            }
+            return found;
+        }
+
+        //
+        // the bytes which may begin a match, and whether it may be empty.
+        //
+        inline core::first_set first (void) const
+        {
+            auto s (core::first_set::none ());
+            for (std::size_t b (0); b < 256; ++b) {
+                auto const c (byte_class_ [b]);
+                if (engine_ == engine::DFA ? delta_ [c] >= 0
+                                           : (follow_bits_ [0] &
+                                              class_bits_ [c]) != 0)
+                    s.set (static_cast<unsigned char> (b));
+            }
+            s.nullable = engine_ == engine::DFA ? accept_ [0] != 0
+                                                : (final_bits_ & 1) != 0;
+            return s;
+        }
+
+    private:
+        enum class engine
+        {
+            NONE,
+            DFA,
+            BITS
+        };
+
+        static constexpr std::size_t max_states = 4096;
+        static constexpr std::size_t max_cells = std::size_t (1) << 21;
+        static constexpr std::size_t max_members = std::size_t (1) << 24;
+
+        inline std::size_t classify (T const& t) const noexcept
+        {
+            auto const u (static_cast<code_unit> (static_cast<unit_type> (t)));
+            return u < 256
+                ? byte_class_ [u]
+                : static_cast<std::size_t>
+                    (std::upper_bound (bounds_.begin (), bounds_.end (), u) -
+                     bounds_.begin ());
+        }
+
+        inline bool partition (regex_positions<T> const& positions)
+        {
+            for (std::size_t p (1); p < positions.size (); ++p)
+                positions.set (p).bounds
+                    (bounds_, regex_positions<T>::max_unit);
+            std::sort (bounds_.begin (), bounds_.end ());
+            bounds_.erase (std::unique (bounds_.begin (), bounds_.end ()),
+                           bounds_.end ());
+            if (not bounds_.empty () && bounds_.front () == 0)
+                bounds_.erase (bounds_.begin ());
+
+            classes_ = bounds_.size () + 1;
+            if (positions.size () * classes_ > max_members)
+                return false;
+
+            for (std::size_t u (0); u < 256; ++u)
+                byte_class_ [u] = static_cast<std::uint32_t>
+                    (std::upper_bound (bounds_.begin (), bounds_.end (),
+                                       code_unit (u)) - bounds_.begin ());
+
+            members_.assign (positions.size () * classes_, 0);
+            for (std::size_t p (1); p < positions.size (); ++p)
+                for (std::size_t c (0); c < classes_; ++c)
+                    members_ [p * classes_ + c] = positions.set (p).contains
+                        (c == 0 ? 0 : bounds_ [c - 1]);
+            return true;
+        }
+
+        //
+        // the subset construction, from the start state alone; a state is
+        // the set of positions last matched.
+        //
+        inline bool build_dfa (regex_positions<T> const& positions)
+        {
+            std::vector<std::uint8_t> final (positions.size (), 0);
+            for (auto const p : positions.final ())
+                final [p] = 1;
+
+            std::vector<std::vector<std::uint32_t>> states {{0}};
+            std::map<std::vector<std::uint32_t>, std::int32_t> ids;
+            ids.emplace (states [0], 0);
+
+            for (std::size_t i (0); i < states.size (); ++i) {
+                std::vector<std::uint32_t> reach;
+                bool accepts (false);
+                for (auto const p : states [i]) {
+                    auto const& f (positions.follow (p));
+                    reach.insert (reach.end (), f.begin (), f.end ());
+                    accepts = accepts || final [p];
+                }
+                std::sort (reach.begin (), reach.end ());
+                reach.erase (std::unique (reach.begin (), reach.end ()),
+                             reach.end ());
+                accept_.push_back (accepts);
+
+                for (std::size_t c (0); c < classes_; ++c) {
+                    std::vector<std::uint32_t> next;
+                    for (auto const q : reach)
+                        if (members_ [q * classes_ + c])
+                            next.push_back (q);
+
+                    std::int32_t to (-1);
+                    if (not next.empty ()) {
+                        auto const found (ids.find (next));
+                        if (found != ids.end ())
+                            to = found->second;
+                        else if (states.size () == max_states ||
+                                 (states.size () + 1) * classes_ > max_cells) {
+                            delta_.clear ();
+                            accept_.clear ();
+                            return false;
+                        } else {
+                            to = static_cast<std::int32_t> (states.size ());
+                            ids.emplace (next, to);
+                            states.push_back (std::move (next));
+                        }
+                    }
+                    delta_.push_back (to);
+                }
+            }
+            members_.clear ();
+            return true;
+        }
+
+        inline bool build_bits (regex_positions<T> const& positions)
+        {
+            if (positions.size () > 64)
+                return false;
+
+            follow_bits_.assign (positions.size (), 0);
+            for (std::size_t p (0); p < positions.size (); ++p)
+                for (auto const q : positions.follow (p))
+                    follow_bits_ [p] |= std::uint64_t (1) << q;
+
+            class_bits_.assign (classes_, 0);
+            for (std::size_t p (1); p < positions.size (); ++p)
+                for (std::size_t c (0); c < classes_; ++c)
+                    if (members_ [p * classes_ + c])
+                        class_bits_ [c] |= std::uint64_t (1) << p;
+
+            for (auto const p : positions.final ())
+                final_bits_ |= std::uint64_t (1) << p;
+            members_.clear ();
+            return true;
+        }
+
+        engine engine_;
+        std::vector<code_unit> bounds_;
+        std::array<std::uint32_t, 256> byte_class_;
+        std::size_t classes_;
+        std::vector<std::uint8_t> members_;
+        std::vector<std::int32_t> delta_;
+        std::vector<std::uint8_t> accept_;
+        std::vector<std::uint64_t> follow_bits_;
+        std::vector<std::uint64_t> class_bits_;
+        std::uint64_t final_bits_;
+    };
+
+    template <typename T>
+    constexpr std::size_t regex_automaton<T>::max_states;
+
+    template <typename T>
+    constexpr std::size_t regex_automaton<T>::max_cells;
+
+    template <typename T>
+    constexpr std::size_t regex_automaton<T>::max_members;
+} // namespace detail
+} // namespace basic
+} // namespace rpc
+
+#endif // ifndef REGEX_AUTOMATON_HPP
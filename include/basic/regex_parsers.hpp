@@ -1,5 +1,6 @@
 //
-// Constructing parsers from std::regex objects
+// Constructing parsers from std::regex objects, and from patterns compiled
+// into automata
 //
 // Author: Dalton Woodard
 // Contact: daltonmwoodard@gmail.com
@@ -12,109 +13,244 @@
 #include <type_traits>
 #include <iterator>
 #include <list>
+#include <memory>
 #include <regex>
 #include <string>
 #include <utility>
 
+#include "core/first_set.hpp"
 #include "core/range.hpp"
 #include "core/parser.hpp"
 #include "gsl/not_null.hpp"
 
+#include "regex_automaton.hpp"
+
 namespace rpc
 {
 namespace basic
 {
-    template <typename It,
-             typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    inline core::parser<It, std::basic_string<T>, R> regexparser
-        (std::basic_regex<T> const& rx, std::string const& pattern = "")
+namespace detail
+{
+    //
+    // the pattern of a regex, in which T is not deduced but taken from the
+    // iterators, so that it may be given as a string literal.
+    //
+    template <typename T>
+    struct pattern_of
+    {
+        using type = std::basic_string<T>;
+    };
+
+    template <typename T>
+    inline std::string describe_pattern (std::basic_string<T> const& pattern)
+    {
+        std::string s;
+        for (auto const& t : pattern)
+            s.push_back (static_cast<char> (t));
+        return s;
+    }
+
+    //
+    // a match of rx by std::regex_search, continuous from the beginning of
+    // the range.
+    //
+    template <typename It, typename T, typename R, typename S>
+    inline core::parser<It, S, R> search_regex
+        (std::basic_regex<T> const& rx, std::string const& description)
     {
-        using A = typename core::parser
-            <It, std::basic_string<T>, R>::accumulator_type;
+        using A = typename core::parser<It, S, R>::accumulator_type;
         using AccT = gsl::not_null_ptr<A>;
 
-        return core::parser<It, std::basic_string<T>, R>
+        core::description const described (description);
+        auto const expected (core::expect (described));
+
+        return core::parser<It, S, R>
         {
-            .description =
-                "[" + 
-                (pattern.empty() ? "regex match" : (pattern + " match")) +
-                "]",
+            .description = described,
             .parse =
             [=](AccT const acc)
             {
                 std::match_results
-                    <typename core::parser
-                        <It, std::basic_string<T>, R>::range_type::iter_type>
+                    <typename core::parser<It, S, R>::range_type::iter_type>
                 matches;
- 
+
                 auto start (core::torange (*acc));
                 auto res = std::regex_search
                     (start.cbegin(), start.cend(), matches, rx,
                     std::regex_constants::match_continuous);
                 if (res) {
                     acc->insert
-                        (matches.str (0), start.tail (matches.length (0)));
+                        (S (matches [0].first, matches [0].second),
+                         start.tail (matches.length (0)));
                     return acc;
                 } else {
-                    acc->insert
-                        (core::failure
-                            {"expected [" +
-                            (pattern.empty() ? "regex match"
-                                             : (pattern + " match")) +
-                            "]"},
-                        start);
+                    acc->insert (core::failure {expected}, start);
                     return acc;
                 }
             }
         };
     }
 
-    template <typename It,
-             typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    inline core::parser<It, std::basic_string<T>, R> wregexparser
-        (std::basic_regex<T> const& rx, std::string const& pattern = "")
+    //
+    // the automaton of a pattern, or null where the pattern (or its flags)
+    // is one it cannot take.
+    //
+    template <typename T>
+    inline std::shared_ptr<regex_automaton<T> const> make_automaton
+        (std::basic_string<T> const& pattern,
+         std::regex_constants::syntax_option_type const flags)
     {
-        using A = typename core::parser
-            <It, std::basic_string<T>, R>::accumulator_type;
+        using option_type = std::regex_constants::syntax_option_type;
+        namespace rc = std::regex_constants;
+
+        auto const plain
+            ((flags & ~(rc::ECMAScript | rc::icase | rc::nosubs |
+                        rc::optimize)) == option_type ());
+        if (not plain)
+            return nullptr;
+
+        auto const automaton
+            (std::make_shared<regex_automaton<T> const>
+                (pattern, (flags & rc::icase) == rc::icase));
+        return automaton->built () ? automaton : nullptr;
+    }
+
+    //
+    // the longest match of a pattern, by an automaton built once, when the
+    // parser is.
+    //
+    template <typename It, typename T, typename R, typename S>
+    inline core::parser<It, S, R> automaton_regex
+        (std::shared_ptr<regex_automaton<T> const> const& automaton,
+         std::string const& description)
+    {
+        using A = typename core::parser<It, S, R>::accumulator_type;
         using AccT = gsl::not_null_ptr<A>;
-        
-        return core::parser<It, std::basic_string<T>, R>
+        using token_type = typename std::iterator_traits<It>::value_type;
+
+        core::description const described (description);
+        auto const expected (core::expect (described));
+        auto const first
+            (core::is_byte_token<token_type>::value ? automaton->first ()
+                                                    : core::first_set::any ());
+
+        return core::parser<It, S, R>
         {
-            .description =
-                "[" +
-                (pattern.empty() ? "wregex match" : (pattern + " match")) +
-                "]",
+            .description = described,
             .parse =
             [=](AccT const acc)
             {
-                std::match_results
-                    <typename core::parser
-                        <It, std::basic_string<T>, R>::range_type::iter_type>
-                matches;
-
-                auto start (core::torange (*acc));
-                auto res = std::regex_search
-                    (start.cbegin(), start.cend(), matches, rx,
-                    std::regex_constants::match_continuous);
-                if (res) {
-                    acc->insert
-                        (matches.str (0), start.tail (matches.length (0)));
-                    return acc;
-                } else {
-                    acc->insert
-                        (core::failure
-                            {"expected [" +
-                            (pattern.empty() ? "wregex match"
-                                             : (pattern + " match")) +
-                            "]"},
-                        start);
+                auto const rng (core::torange (*acc));
+                auto const n (automaton->match (rng.begin (), rng.end ()));
+                if (n < 0) {
+                    acc->insert (core::failure {expected}, rng);
                     return acc;
                 }
-            }
+
+                auto const next
+                    (rng.tail (static_cast<typename R::diff_type> (n)));
+                acc->insert
+                    (core::parse_result<S> {S (rng.begin (), next.begin ())},
+                     next);
+                return acc;
+            },
+            .lookahead = first
         };
     }
+
+    //
+    // a pattern compiled into an automaton; patterns (or flags) it cannot
+    // take are given to std::regex.
+    //
+    template <typename It, typename T, typename R, typename S>
+    inline core::parser<It, S, R> compiled_regex
+        (std::basic_string<T> const& pattern,
+         std::regex_constants::syntax_option_type const flags,
+         std::string const& description)
+    {
+        auto const automaton (make_automaton (pattern, flags));
+        if (automaton)
+            return automaton_regex<It, T, R, S> (automaton, description);
+        return search_regex<It, T, R, S>
+            (std::basic_regex<T> (pattern, flags), description);
+    }
+} // namespace detail
+
+    //
+    // A std::regex is matched by std::regex_search, continuous from the
+    // beginning of the range; the pattern, if given, only describes it.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    inline core::parser<It, S, R> regexparser
+        (std::basic_regex<T> const& rx, std::string const& pattern = "")
+    {
+        auto const description
+            ("[" +
+             (pattern.empty() ? "regex match" : (pattern + " match")) +
+             "]");
+        return detail::search_regex<It, T, R, S> (rx, description);
+    }
+
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    inline core::parser<It, S, R> wregexparser
+        (std::basic_regex<T> const& rx, std::string const& pattern = "")
+    {
+        auto const description
+            ("[" +
+             (pattern.empty() ? "wregex match" : (pattern + " match")) +
+             "]");
+        return detail::search_regex<It, T, R, S> (rx, description);
+    }
+
+    //
+    // compiled_regexparser compiles a pattern once, when the parser is
+    // built, into an automaton (basic/regex_automaton) run straight over the
+    // range, with nothing allocated but the string of the match. Its DFA is
+    // built in full then, not state by state as it is matched, so that the
+    // automaton is immutable and may be shared by the threads a parser is
+    // run on; past 4096 states the position automaton is run instead. It
+    // takes the longest match at the beginning of the range, where
+    // std::regex takes the first that ECMAScript's backtracking finds; the
+    // two differ only where an earlier alternative (or a shorter repetition)
+    // lets the rest of the pattern match less, which is why it is not what
+    // regexparser does. Patterns using assertions, back references or lazy
+    // quantifiers, and grammars other than ECMAScript, are given to
+    // std::regex. As with the text parsers, S may be core::slice<It>, a view
+    // of the match in the input.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    inline core::parser<It, S, R> compiled_regexparser
+        (typename detail::pattern_of<T>::type const& pattern,
+         std::regex_constants::syntax_option_type const flags =
+            std::regex_constants::ECMAScript)
+    {
+        return detail::compiled_regex<It, T, R, S>
+            (pattern, flags,
+             "[" + detail::describe_pattern (pattern) + " match]");
+    }
+
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    inline core::parser<It, S, R> compiled_wregexparser
+        (typename detail::pattern_of<T>::type const& pattern,
+         std::regex_constants::syntax_option_type const flags =
+            std::regex_constants::ECMAScript)
+    {
+        return detail::compiled_regex<It, T, R, S>
+            (pattern, flags,
+             "[" + detail::describe_pattern (pattern) + " match]");
+    }
 } // namespace basic
 } // namesapce rpc
 
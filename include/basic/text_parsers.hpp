@@ -14,9 +14,11 @@
 #include <list>
 #include <string>
 
+#include "core/char_class.hpp"
 #include "core/range.hpp"
 #include "core/parser.hpp"
 #include "core/combinators.hpp"
+#include "core/slice.hpp"
 #include "core/token_parsers.hpp"
 
 namespace rpc
@@ -44,43 +46,53 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> space =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::isspace(c); },
+            (core::pure ([](T const& c) -> bool { return std::isspace(c); }),
             "whitespace");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>
-    core::parser<It, T, R> spaces = core::some (space<It, T, R>);
+    core::parser<It, T, R> spaces =
+        core::skip_while1<It, T, R>
+            (core::class_predicate {core::char_class::space}, "whitespace");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>
-    core::parser<It, T, R> spacem = core::many (space<It, T, R>);
+    core::parser<It, T, R> spacem =
+        core::skip_while<It, T, R>
+            (core::class_predicate {core::char_class::space}, "whitespace");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>
     core::parser<It, T, R> wspace =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswspace(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswspace(c); }),
             "wide whitespace");
  
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>    
-    core::parser<It, T, R> wspaces = core::some (wspace<It, T, R>);
+    core::parser<It, T, R> wspaces =
+        core::skip_while1<It, T, R>
+            (core::pure ([](T const& c) -> bool { return std::iswspace(c); }),
+            "wide whitespace");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>
-    core::parser<It, T, R> wspacem = core::many (wspace<It, T, R>);
+    core::parser<It, T, R> wspacem =
+        core::skip_while<It, T, R>
+            (core::pure ([](T const& c) -> bool { return std::iswspace(c); }),
+            "wide whitespace");
  
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>   
     core::parser<It, T, R> punct =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::ispunct(c); },
+            (core::pure ([](T const& c) -> bool { return std::ispunct(c); }),
             "punctuation");
 
     template <typename It,
@@ -98,7 +110,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> wpunct =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswpunct(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswpunct(c); }),
             "wide punctuation");
  
     template <typename It,
@@ -116,8 +128,8 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> alpha =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool
-                { return std::isalpha(c); },
+            (core::pure ([](T const& c) -> bool
+                { return std::isalpha(c); }),
             "alphabetic");
  
     template <typename It,
@@ -135,7 +147,7 @@ namespace basic
              typename R = core::range<It>>   
     core::parser<It, T, R> walpha =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswalpha(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswalpha(c); }),
             "wide alphabetic");
 
     template <typename It,
@@ -153,8 +165,8 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> palpha =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool
-                { return std::isalpha(c) || std::ispunct(c); },
+            (core::pure ([](T const& c) -> bool
+                { return std::isalpha(c) || std::ispunct(c); }),
         "alphabetic or punctuation");
  
     template <typename It,
@@ -172,8 +184,8 @@ namespace basic
              typename R = core::range<It>>   
     core::parser<It, T, R> wpalpha =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool
-                { return std::iswalpha(c) || std::iswpunct(c); },
+            (core::pure ([](T const& c) -> bool
+                { return std::iswalpha(c) || std::iswpunct(c); }),
             "wide alphabetic or wide punctuation");
 
     template <typename It,
@@ -191,7 +203,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> lower =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::islower(c); },
+            (core::pure ([](T const& c) -> bool { return std::islower(c); }),
             "lower-case");
 
     template <typename It,
@@ -209,7 +221,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> wlower =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswlower(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswlower(c); }),
             "wide lower-case");
  
     template <typename It,
@@ -227,7 +239,7 @@ namespace basic
              typename R = core::range<It>> 
     core::parser<It, T, R> upper =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::isupper(c); },
+            (core::pure ([](T const& c) -> bool { return std::isupper(c); }),
             "upper-case");
 
     template <typename It,
@@ -245,7 +257,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> wupper =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswupper(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswupper(c); }),
             "wide upper-case");
  
     template <typename It,
@@ -263,7 +275,7 @@ namespace basic
              typename R = core::range<It>>    
     core::parser<It, T, R> digit =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::isdigit(c); },
+            (core::pure ([](T const& c) -> bool { return std::isdigit(c); }),
             "digit character");
 
     template <typename It,
@@ -281,7 +293,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> wdigit =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswdigit(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswdigit(c); }),
             "wide digit character");
  
     template <typename It,
@@ -299,7 +311,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> hexdigit =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::isxdigit(c); },
+            (core::pure ([](T const& c) -> bool { return std::isxdigit(c); }),
             "hex-digit character");
 
     template <typename It,
@@ -317,7 +329,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> whexdigit =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswxdigit(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswxdigit(c); }),
             "wide hex-digit character");
  
     template <typename It,
@@ -335,7 +347,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> cntrl =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iscntrl(c); },
+            (core::pure ([](T const& c) -> bool { return std::iscntrl(c); }),
             "control character");
 
     template <typename It,
@@ -353,7 +365,7 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> wcntrl =
         core::satisfy<It, T, R>
-            ([](T const& c) -> bool { return std::iswcntrl(c); },
+            (core::pure ([](T const& c) -> bool { return std::iswcntrl(c); }),
             "wide control character");
  
     template <typename It,
@@ -366,104 +378,121 @@ namespace basic
              typename R = core::range<It>>
     core::parser<It, T, R> wcntrlm = core::many (wcntrl<It, T, R>); 
 
+    //
+    // Words are strings copied out of the input, or with S = core::slice<It>
+    // views of it, which allocate nothing.
+    //
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> word =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> word =
         core::override_description
-            (core::reducel (alphas<It, T, R>,
-                          [](T c, std::basic_string<T> & s)
-                                { s.push_back (c); return s; },
-                          std::basic_string<T>()),
-             "[word ::" + fnk::utility::type_name<T>::name() + "]");
+            (core::take_while1<It, T, R, S>
+                (core::class_predicate {core::char_class::alpha},
+                "alphabetic"),
+             "[word ::" + core::describe_type<T> () + "]");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> words =
-        core::some (rpc::core::ignorel (spacem<It, T, R>, word<It, T, R>));
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> words =
+        core::some
+            (rpc::core::ignorel (spacem<It, T, R>, word<It, T, R, S>));
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> wordm =
-        core::many (rpc::core::ignorel (spacem<It, T, R>, word<It, T, R>));
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> wordm =
+        core::many
+            (rpc::core::ignorel (spacem<It, T, R>, word<It, T, R, S>));
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> pword =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> pword =
         core::override_description
-            (core::reducer (palphas<It, T, R>, 
-                           [](T c, std::basic_string<T> & s)
-                                { s.push_back (c); return s; },
-                           std::basic_string<T>()),
-             "[pword ::" + fnk::utility::type_name<T>::name() + "]");
+            (core::take_while1<It, T, R, S>
+                (core::class_predicate
+                    {core::char_class::alpha | core::char_class::punct},
+                "alphabetic or punctuation"),
+             "[pword ::" + core::describe_type<T> () + "]");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> pwords =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> pwords =
         core::some
-            (core::ignorel (spacem<It, T, R>, pword<It, T, R>));
+            (core::ignorel (spacem<It, T, R>, pword<It, T, R, S>));
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> pwordm =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> pwordm =
         core::many
             (core::ignorel
-                (spacem<It, T, R>, pword<It, T, R>));
+                (spacem<It, T, R>, pword<It, T, R, S>));
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> wword =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> wword =
         core::override_description
-            (core::reducer (walphas<It, T, R>,
-                           [](T c, std::basic_string<T> & s)
-                                { s.append (c); return s; },
-                           std::basic_string<T>()),
-             "[wide word ::" + fnk::utility::type_name<T>::name() + "]");
+            (core::take_while1<It, T, R, S>
+                (core::pure ([](T const& c) -> bool
+                    { return std::iswalpha(c); }),
+                "wide alphabetic"),
+             "[wide word ::" + core::describe_type<T> () + "]");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> wwords =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> wwords =
         core::some
-            (core::ignorel (wspacem<It, T, R>, wword<It, T, R>));
+            (core::ignorel (wspacem<It, T, R>, wword<It, T, R, S>));
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> wwordm =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> wwordm =
         core::many
-            (core::ignorel (wspacem<It, T, R>, wword<It, T, R>));
+            (core::ignorel (wspacem<It, T, R>, wword<It, T, R, S>));
  
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>   
-    core::parser<It, std::basic_string<T>, R> pwword =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> pwword =
         core::override_description
-            (core::reducer (wpalphas<It, T, R>,
-                           [](T c, std::basic_string<T> & s)
-                                { s.append (c); return s; },
-                           std::basic_string<T>()),
-             "[wide pword ::" + fnk::utility::type_name<T>::name() + "]");
+            (core::take_while1<It, T, R, S>
+                (core::pure ([](T const& c) -> bool
+                    { return std::iswalpha(c) || std::iswpunct(c); }),
+                "wide alphabetic or wide punctuation"),
+             "[wide pword ::" + core::describe_type<T> () + "]");
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> pwwords =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> pwwords =
         core::some
-            (core::ignorel (wspacem<It, T, R>, pwword<It, T, R>));
+            (core::ignorel (wspacem<It, T, R>, pwword<It, T, R, S>));
 
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
-             typename R = core::range<It>>
-    core::parser<It, std::basic_string<T>, R> pwwordm =
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>>
+    core::parser<It, S, R> pwwordm =
         core::many
-            (core::ignorel (wspacem<It, T, R>, pwword<It, T, R>));
+            (core::ignorel (wspacem<It, T, R>, pwword<It, T, R, S>));
 } // namespace basic
 } // namespace rpc
 
@@ -11,9 +11,13 @@
 
 #include <cassert>
 #include <deque>
+#include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "memo.hpp"
+#include "memory.hpp"
 #include "range.hpp"
 #include "result_type.hpp"
 
@@ -33,8 +37,11 @@ namespace core
         using range_type   = R;
         using result_type  = parse_result <V>;
         using result_value_type = V;
-        using backing_type = 
-            std::deque <std::pair<result_type, range_type>>;
+        using backing_type = std::deque
+            <std::pair<result_type, range_type>,
+             resource_allocator<std::pair<result_type, range_type>>>;
+        using allocator_type = typename backing_type::allocator_type;
+        struct mark_type;
     private:
         using backing_value_t  = typename backing_type::value_type;
         using backing_ref_t    = typename backing_type::reference;
@@ -69,18 +76,43 @@ namespace core
         accumulator & operator= (accumulator const&) = delete;
 
         //
-        // valid constructors
+        // valid constructors; storage for results is drawn from the given
+        // memory resource (by default, global operator new and delete).
         //
-        accumulator (result_type const& res, range_type const& rng)
+        accumulator (result_type const& res,
+                     range_type const& rng,
+                     memory_resource * const mem = default_resource ())
+            : acc_ (allocator_type {mem})
         {
             acc_.emplace_back (res, rng);
         }
 
-        accumulator (std::pair<result_type, range_type> const& p)
+        accumulator (std::pair<result_type, range_type> const& p,
+                     memory_resource * const mem = default_resource ())
+            : acc_ (allocator_type {mem})
         {
             acc_.emplace_back (p);
         }
 
+        inline memory_resource * resource (void) const noexcept
+        {
+            return acc_.get_allocator ().resource ();
+        }
+
+        //
+        // the memo context of the parse, if there is one; memoized parsers
+        // run on an accumulator without a context simply parse.
+        //
+        inline memo_context * context (void) const noexcept
+        {
+            return ctx_;
+        }
+
+        inline void attach (memo_context * const ctx) noexcept
+        {
+            ctx_ = ctx;
+        }
+
         // iterators:
         //
         inline backing_iter_t begin (void) noexcept
@@ -146,9 +178,11 @@ namespace core
         }
 
         //
-        // view the n'th most recent result.
+        // view the n'th most recent result (in place: range and result
+        // copy out only the part asked for).
         //
-        inline backing_value_t view (std::size_t const n = 0) const noexcept
+        inline backing_value_t const& view (std::size_t const n = 0)
+            const noexcept
         {
             assert (not empty() &&
                     "cannot view into empty contianer (view call)");
@@ -205,6 +239,69 @@ namespace core
             replace (res, rng);
         }
 
+        //
+        // checkpoints: a mark records the extent of the accumulator, and
+        // the range of its last result (which ignore moves on in place);
+        // after a parse is attempted from a mark, its results are either
+        // discarded with truncate (rolling back to the mark) or accepted
+        // with commit.
+        //
+        struct mark_type
+        {
+            backing_size_t size;
+            range_type range;
+        };
+
+        inline mark_type mark (void) const
+        {
+            return mark_type {acc_.size (), acc_.back ().second};
+        }
+
+        inline void truncate (mark_type const& m)
+        {
+            assert (m.size <= size() &&
+                    "cannot truncate past end (truncate call)");
+
+            while (acc_.size () > m.size)
+                acc_.pop_back ();
+            if (acc_.back ().second.length () != m.range.length ())
+                replace (m.range);
+        }
+
+        inline void commit (mark_type const& m) const noexcept
+        {
+            assert (m.size <= size() && "cannot commit past end (commit call)");
+            (void) m;
+        }
+
+        //
+        // obtain a view of the results made since a mark (or of all but
+        // the first n results), in chronological order.
+        //
+        inline std::pair<backing_citer_t, backing_citer_t> since
+            (mark_type const& m) const noexcept
+        {
+            return since (m.size);
+        }
+
+        inline std::pair<backing_citer_t, backing_citer_t> since
+            (std::size_t const n) const noexcept
+        {
+            assert (n <= size() && "cannot view past end (since call)");
+
+            return std::make_pair
+                (std::next (cbegin (), n), cend ());
+        }
+
+        //
+        // discard every result, and begin again from the given one.
+        //
+        inline void reset (result_type const& res, range_type const& rng)
+        {
+            acc_.clear ();
+            acc_.emplace_back (res, rng);
+        }
+
         //
         // obtain a view of the past n results in 
         // chronological order; returns a pair of 
@@ -233,36 +330,189 @@ namespace core
             return view (n).second;
         }
  
-        inline bool range_empty (std::size_t const n = 0) const noexcept
+        //
+        // these look at the input, and so (over a stream) may read it.
+        //
+        inline bool range_empty (std::size_t const n = 0) const
         {
             return view (n).second.empty ();
         }
  
         inline typename range_type::token_type range_head
-            (std::size_t const n = 0) const noexcept
+            (std::size_t const n = 0) const
         {
             return range (n).head ();
         }
  
-        inline range_type range_tail (std::size_t const n = 0) const noexcept
+        inline range_type range_tail (std::size_t const n = 0) const
         {
             return range (n).tail ();
         }
 
-        inline decltype(auto) values (void) const noexcept
+        //
+        // the values parsed, in order; these are returned in a container
+        // of the default allocator, so that they may outlive the memory
+        // resource of the accumulator.
+        //
+        inline std::deque<V> values (void) const
         {
-            using PT = std::pair<parse_result<V>, R>;
-
-            return fnk::map
-            (&result_type::to_value,
-             fnk::filter
-                (&result_type::is_value,
-                 fnk::map (&PT::first, acc_)));
-                    //([](std::pair<parse_result<V>, R> const& r) { return r.first; },
-                    //acc_)));
+            std::deque<V> vs;
+            for (auto const& e : acc_)
+                if (e.first.is_value ())
+                    vs.emplace_back (e.first.to_value ());
+            return vs;
         }
     private:
         backing_type acc_;
+        memo_context * ctx_ = nullptr;
+    };
+
+    //
+    // Combinators which must run a parser at another value type need an
+    // accumulator of that type for the duration of the call; a scratch
+    // accumulator is leased from a per-thread pool, so that its storage
+    // is reused from call to call rather than allocated afresh each time.
+    // Leases nest, and each one holds its accumulator exclusively; the
+    // memo context of the parse is passed on to it.
+    //
+    // A lease is drawn from the memory resource of the parse. Under the
+    // default resource the pool owns its accumulators. Under a monotonic
+    // resource (a monotonic_arena) they are made in the resource itself,
+    // pooled for as long as its generation is unchanged, and then forgotten
+    // (never destroyed, as what they hold was returned to the resource with
+    // everything else, and may since have been handed out again). Under any
+    // other resource, which may be gone by the time a pool would return to
+    // it, a lease is made in the resource and returned to it when the lease
+    // ends, and nothing is pooled.
+    //
+    template <typename A>
+    struct scratch
+    {
+    public:
+        using type         = scratch <A>;
+        using range_type   = typename A::range_type;
+        using result_value_type = typename A::result_value_type;
+
+        scratch (void) = delete;
+
+        scratch (scratch const&) = delete;
+        scratch & operator= (scratch const&) = delete;
+
+        explicit scratch (range_type const& rng,
+                          memo_context * const ctx = nullptr,
+                          memory_resource * const mem = default_resource ())
+            : mem_ (mem)
+            , generation_ (mem->generation ())
+            , rng_ (rng)
+        {
+            if (mem == default_resource ()) {
+                owned_ = acquire (rng);
+                acc_   = owned_.get ();
+            } else if (mem->monotonic ()) {
+                acc_ = acquire (rng, mem);
+            } else {
+                auto const where (mem->allocate (sizeof (A), alignof (A)));
+                acc_ = ::new (where) A {empty<result_value_type>{}, rng, mem};
+            }
+            acc_->attach (ctx);
+        }
+
+        ~scratch (void)
+        {
+            if (owned_) {
+                pool ().emplace_back (std::move (owned_));
+                return;
+            } else if (not mem_->monotonic ()) {
+                acc_->~A ();
+                mem_->deallocate (acc_, sizeof (A), alignof (A));
+                return;
+            }
+
+            //
+            // drop the values of the lease now, as its accumulator is not
+            // destroyed when it is forgotten; a lease outlived by the
+            // generation of the pool is forgotten at once.
+            //
+            acc_->reset (empty<result_value_type>{}, rng_);
+            auto & p (resource_pool ());
+            if (p.generation == generation_)
+                p.free.push_back (acc_);
+        }
+
+        inline A * get (void) const noexcept
+        {
+            return acc_;
+        }
+
+        inline A & operator* (void) const noexcept
+        {
+            return *acc_;
+        }
+
+        inline A * operator-> (void) const noexcept
+        {
+            return acc_;
+        }
+
+    private:
+        using pool_type = std::vector <std::unique_ptr<A>>;
+
+        struct resource_pool_type
+        {
+            std::size_t generation = 0;
+            std::vector<A *> free;
+        };
+
+        static inline pool_type & pool (void)
+        {
+            static thread_local pool_type p;
+            return p;
+        }
+
+        static inline resource_pool_type & resource_pool (void)
+        {
+            static thread_local resource_pool_type p;
+            return p;
+        }
+
+        static inline std::unique_ptr<A> acquire (range_type const& rng)
+        {
+            auto & p (pool ());
+            if (p.empty ())
+                return std::unique_ptr<A>
+                    (new A {empty<result_value_type>{}, rng});
+
+            auto a (std::move (p.back ()));
+            p.pop_back ();
+            a->reset (empty<result_value_type>{}, rng);
+            return a;
+        }
+
+        static inline A * acquire (range_type const& rng,
+                                   memory_resource * const mem)
+        {
+            auto & p (resource_pool ());
+            if (p.generation != mem->generation ()) {
+                p.generation = mem->generation ();
+                p.free.clear ();
+            }
+
+            if (p.free.empty ()) {
+                auto const where (mem->allocate (sizeof (A), alignof (A)));
+                return ::new (where) A {empty<result_value_type>{}, rng, mem};
+            }
+
+            auto a (p.free.back ());
+            p.free.pop_back ();
+            a->reset (empty<result_value_type>{}, rng);
+            return a;
+        }
+
+        memory_resource * const mem_;
+        std::size_t const generation_;
+        range_type const rng_;
+        std::unique_ptr<A> owned_;
+        A * acc_;
     };
 
     template <typename A>
@@ -274,6 +524,8 @@ namespace core
         using result_value_type =
             typename A::result_value_type;
         using backing_type = typename A::backing_type;
+        using allocator_type = typename A::allocator_type;
+        using mark_type    = typename A::mark_type;
     };
 } // namespace core
 } // namespace rpc
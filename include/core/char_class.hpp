@@ -0,0 +1,445 @@
+//
+// Classes of characters, tables of sets of bytes, and vectorized scans of
+// runs of classes over contiguous input
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef CHAR_CLASS_HPP
+#define CHAR_CLASS_HPP
+
+#include <array>
+#include <cctype>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "first_set.hpp"
+
+//
+// Define RPC_NO_SIMD to scan runs of a class one character at a time on
+// every target. Otherwise, on x86 with GCC or Clang, runs over contiguous
+// input are scanned 16 bytes at a time (SSE2), or 32 at a time where the
+// CPU supports AVX2; the choice is made once, when first needed.
+//
+#ifndef RPC_NO_SIMD
+#define RPC_NO_SIMD 0
+#else
+#undef  RPC_NO_SIMD
+#define RPC_NO_SIMD 1
+#endif
+
+#if not RPC_NO_SIMD && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define RPC_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define RPC_SIMD_X86 0
+#endif
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // The classes of <cctype> which text parsers scan runs of; a union of
+    // classes is the class of characters in any of them.
+    //
+    enum class char_class : unsigned
+    {
+        space  = 1 << 0,
+        digit  = 1 << 1,
+        alpha  = 1 << 2,
+        punct  = 1 << 3,
+        xdigit = 1 << 4
+    };
+
+    inline constexpr char_class operator| (char_class const a,
+                                           char_class const b) noexcept
+    {
+        return static_cast<char_class>
+            (static_cast<unsigned> (a) | static_cast<unsigned> (b));
+    }
+
+    inline constexpr bool has_class (char_class const cls,
+                                     char_class const c) noexcept
+    {
+        return (static_cast<unsigned> (cls) & static_cast<unsigned> (c)) != 0;
+    }
+
+    //
+    // The predicate of a class, as the functions of <cctype> (and so the
+    // current locale) decide it. Parsers which scan runs (take_while and
+    // the like) given one scan contiguous input of bytes with the kernels
+    // below, and call it only for bytes outside of ASCII, which is the same
+    // in every locale. The functions of <cctype> are only defined for the
+    // values of unsigned char, and so a token is read as unsigned (a char
+    // of 0x80 or above is negative), and one wider than a byte and outside
+    // of those values is in no class.
+    //
+    struct class_predicate
+    {
+    public:
+        template <typename T>
+        inline bool operator() (T const& t) const
+        {
+            auto const u (static_cast<std::make_unsigned_t<T>> (t));
+            if (u > UCHAR_MAX)
+                return false;
+
+            auto const c (static_cast<int> (u));
+            return (has_class (cls, char_class::space)  && std::isspace (c)) ||
+                   (has_class (cls, char_class::digit)  && std::isdigit (c)) ||
+                   (has_class (cls, char_class::alpha)  && std::isalpha (c)) ||
+                   (has_class (cls, char_class::punct)  && std::ispunct (c)) ||
+                   (has_class (cls, char_class::xdigit) && std::isxdigit (c));
+        }
+
+        char_class cls;
+    };
+
+    //
+    // A set of byte-sized tokens as a table of 256 bits, so that whether a
+    // token is in it is a single bit test. A predicate is compiled into one
+    // by asking it of every byte, once; sets are composed as bitmaps. As a
+    // predicate it is only meaningful for tokens of one byte.
+    //
+    struct byte_class
+    {
+    public:
+        static inline byte_class none (void) noexcept
+        {
+            return byte_class {{{0, 0, 0, 0}}};
+        }
+
+        static inline byte_class all (void) noexcept
+        {
+            return ~none ();
+        }
+
+        template <typename T, typename Pr>
+        static inline byte_class of (Pr const& predicate)
+        {
+            auto s (none ());
+            for (unsigned b (0); b < 256; ++b)
+                if (predicate (static_cast<T> (static_cast<unsigned char> (b))))
+                    s.set (static_cast<unsigned char> (b));
+            return s;
+        }
+
+        template <typename T>
+        static inline byte_class one_of (std::initializer_list<T> l) noexcept
+        {
+            auto s (none ());
+            for (auto const& t : l)
+                s.set (static_cast<unsigned char> (t));
+            return s;
+        }
+
+        template <typename T>
+        static inline byte_class in_range (T const& start,
+                                           T const& end) noexcept
+        {
+            return of<T> ([&](T const& t) { return start <= t && t <= end; });
+        }
+
+        inline bool test (unsigned char const b) const noexcept
+        {
+            return (bits [b >> 6] >> (b & 63)) & 1;
+        }
+
+        inline void set (unsigned char const b) noexcept
+        {
+            bits [b >> 6] |= std::uint64_t (1) << (b & 63);
+        }
+
+        inline bool operator() (unsigned char const b) const noexcept
+        {
+            return test (b);
+        }
+
+        //
+        // the FIRST set of satisfy of this class: its bytes, not nullable.
+        //
+        inline first_set first (void) const noexcept
+        {
+            return first_set {bits, false};
+        }
+
+        friend inline byte_class operator| (byte_class const& a,
+                                            byte_class const& b) noexcept
+        {
+            return byte_class
+            {
+                {{a.bits [0] | b.bits [0], a.bits [1] | b.bits [1],
+                  a.bits [2] | b.bits [2], a.bits [3] | b.bits [3]}}
+            };
+        }
+
+        friend inline byte_class operator& (byte_class const& a,
+                                            byte_class const& b) noexcept
+        {
+            return byte_class
+            {
+                {{a.bits [0] & b.bits [0], a.bits [1] & b.bits [1],
+                  a.bits [2] & b.bits [2], a.bits [3] & b.bits [3]}}
+            };
+        }
+
+        friend inline byte_class operator~ (byte_class const& a) noexcept
+        {
+            return byte_class
+                {{{~a.bits [0], ~a.bits [1], ~a.bits [2], ~a.bits [3]}}};
+        }
+
+        std::array<std::uint64_t, 4> bits;
+    };
+
+    //
+    // Iterators over tokens which lie one after another in memory (those of
+    // pointers, strings and vectors), so that a range of them may be read
+    // through a pointer to its first.
+    //
+namespace detail
+{
+    template <typename It, typename T, bool byte>
+    struct contiguous_byte_iterator : public std::false_type
+    {};
+
+    template <typename It, typename T>
+    struct contiguous_byte_iterator<It, T, true>
+        : public std::integral_constant
+            <bool,
+             std::is_pointer<It>::value ||
+             std::is_same<It, typename std::basic_string<T>::iterator>::value ||
+             std::is_same
+                <It, typename std::basic_string<T>::const_iterator>::value ||
+             std::is_same<It, typename std::vector<T>::iterator>::value ||
+             std::is_same<It, typename std::vector<T>::const_iterator>::value>
+    {};
+} // namespace detail
+
+    template <typename It>
+    struct is_contiguous_byte_iterator
+        : public detail::contiguous_byte_iterator
+            <It,
+             typename std::iterator_traits<It>::value_type,
+             is_byte_token<typename std::iterator_traits<It>::value_type>::value>
+    {};
+
+namespace detail
+{
+    //
+    // Each kernel returns the offset in [p, p + n) of the first byte which
+    // either ends the run (one outside the class, or inside it if until)
+    // or lies outside of ASCII, which the caller must classify; n if none.
+    //
+    inline bool ascii_in_class (char_class const cls,
+                                unsigned char const c) noexcept
+    {
+        return (has_class (cls, char_class::space) &&
+                (c == ' ' || (c >= '\t' && c <= '\r'))) ||
+               (has_class (cls, char_class::digit) &&
+                c >= '0' && c <= '9') ||
+               (has_class (cls, char_class::alpha) &&
+                (c | 0x20) >= 'a' && (c | 0x20) <= 'z') ||
+               (has_class (cls, char_class::punct) &&
+                ((c >= 0x21 && c <= 0x2f) || (c >= 0x3a && c <= 0x40) ||
+                 (c >= 0x5b && c <= 0x60) || (c >= 0x7b && c <= 0x7e))) ||
+               (has_class (cls, char_class::xdigit) &&
+                ((c >= '0' && c <= '9') ||
+                 ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')));
+    }
+
+    inline std::size_t class_run_scalar (char_class const cls,
+                                         unsigned char const* const p,
+                                         std::size_t const n,
+                                         bool const until) noexcept
+    {
+        std::size_t i (0);
+        while (i < n && p [i] < 0x80 && ascii_in_class (cls, p [i]) != until)
+            ++i;
+        return i;
+    }
+
+#if RPC_SIMD_X86
+    //
+    // The bytes of x in [lo, hi], as a mask of bytes. Compares are signed,
+    // so that bytes outside of ASCII (negative) are in no range of ASCII.
+    //
+    __attribute__ ((target ("sse2")))
+    inline __m128i in_byte_range (__m128i const x, char const lo,
+                                  char const hi) noexcept
+    {
+        return _mm_and_si128 (_mm_cmpgt_epi8 (x, _mm_set1_epi8 (lo - 1)),
+                              _mm_cmplt_epi8 (x, _mm_set1_epi8 (hi + 1)));
+    }
+
+    __attribute__ ((target ("avx2")))
+    inline __m256i in_byte_range (__m256i const x, char const lo,
+                                  char const hi) noexcept
+    {
+        return _mm256_and_si256
+            (_mm256_cmpgt_epi8 (x, _mm256_set1_epi8 (lo - 1)),
+             _mm256_cmpgt_epi8 (_mm256_set1_epi8 (hi + 1), x));
+    }
+
+    __attribute__ ((target ("sse2")))
+    inline std::uint32_t class_mask (char_class const cls,
+                                     __m128i const x) noexcept
+    {
+        auto const lx (_mm_or_si128 (x, _mm_set1_epi8 (0x20)));
+        auto m (_mm_setzero_si128 ());
+
+        if (has_class (cls, char_class::space))
+            m = _mm_or_si128
+                (m, _mm_or_si128 (_mm_cmpeq_epi8 (x, _mm_set1_epi8 (' ')),
+                                  in_byte_range (x, '\t', '\r')));
+        if (has_class (cls, char_class::digit))
+            m = _mm_or_si128 (m, in_byte_range (x, '0', '9'));
+        if (has_class (cls, char_class::alpha))
+            m = _mm_or_si128 (m, in_byte_range (lx, 'a', 'z'));
+        if (has_class (cls, char_class::punct))
+            m = _mm_or_si128
+                (m, _mm_or_si128
+                    (_mm_or_si128 (in_byte_range (x, 0x21, 0x2f),
+                                   in_byte_range (x, 0x3a, 0x40)),
+                     _mm_or_si128 (in_byte_range (x, 0x5b, 0x60),
+                                   in_byte_range (x, 0x7b, 0x7e))));
+        if (has_class (cls, char_class::xdigit))
+            m = _mm_or_si128
+                (m, _mm_or_si128 (in_byte_range (x, '0', '9'),
+                                  in_byte_range (lx, 'a', 'f')));
+
+        return static_cast<std::uint32_t> (_mm_movemask_epi8 (m));
+    }
+
+    __attribute__ ((target ("avx2")))
+    inline std::uint32_t class_mask (char_class const cls,
+                                     __m256i const x) noexcept
+    {
+        auto const lx (_mm256_or_si256 (x, _mm256_set1_epi8 (0x20)));
+        auto m (_mm256_setzero_si256 ());
+
+        if (has_class (cls, char_class::space))
+            m = _mm256_or_si256
+                (m, _mm256_or_si256
+                    (_mm256_cmpeq_epi8 (x, _mm256_set1_epi8 (' ')),
+                     in_byte_range (x, '\t', '\r')));
+        if (has_class (cls, char_class::digit))
+            m = _mm256_or_si256 (m, in_byte_range (x, '0', '9'));
+        if (has_class (cls, char_class::alpha))
+            m = _mm256_or_si256 (m, in_byte_range (lx, 'a', 'z'));
+        if (has_class (cls, char_class::punct))
+            m = _mm256_or_si256
+                (m, _mm256_or_si256
+                    (_mm256_or_si256 (in_byte_range (x, 0x21, 0x2f),
+                                      in_byte_range (x, 0x3a, 0x40)),
+                     _mm256_or_si256 (in_byte_range (x, 0x5b, 0x60),
+                                      in_byte_range (x, 0x7b, 0x7e))));
+        if (has_class (cls, char_class::xdigit))
+            m = _mm256_or_si256
+                (m, _mm256_or_si256 (in_byte_range (x, '0', '9'),
+                                     in_byte_range (lx, 'a', 'f')));
+
+        return static_cast<std::uint32_t> (_mm256_movemask_epi8 (m));
+    }
+
+    //
+    // each block of 16 (or 32) bytes is classified at once; the run goes
+    // on while every byte of a block is in the class (or, if until, none
+    // is) and within ASCII, whose bytes have their high bits clear.
+    //
+    __attribute__ ((target ("sse2")))
+    inline std::size_t class_run_sse2 (char_class const cls,
+                                       unsigned char const* const p,
+                                       std::size_t const n,
+                                       bool const until) noexcept
+    {
+        std::size_t i (0);
+        for (; i + 16 <= n; i += 16) {
+            auto const x (_mm_loadu_si128
+                (reinterpret_cast<__m128i const*> (p + i)));
+            auto const in (class_mask (cls, x));
+            auto const high
+                (static_cast<std::uint32_t> (_mm_movemask_epi8 (x)));
+            auto const stop ((until ? in : ~in & 0xffffu) | high);
+            if (stop != 0)
+                return i + static_cast<std::size_t> (__builtin_ctz (stop));
+        }
+        return i + class_run_scalar (cls, p + i, n - i, until);
+    }
+
+    __attribute__ ((target ("avx2")))
+    inline std::size_t class_run_avx2 (char_class const cls,
+                                       unsigned char const* const p,
+                                       std::size_t const n,
+                                       bool const until) noexcept
+    {
+        std::size_t i (0);
+        for (; i + 32 <= n; i += 32) {
+            auto const x (_mm256_loadu_si256
+                (reinterpret_cast<__m256i const*> (p + i)));
+            auto const in (class_mask (cls, x));
+            auto const high
+                (static_cast<std::uint32_t> (_mm256_movemask_epi8 (x)));
+            auto const stop ((until ? in : ~in) | high);
+            if (stop != 0)
+                return i + static_cast<std::size_t> (__builtin_ctz (stop));
+        }
+        return i + class_run_sse2 (cls, p + i, n - i, until);
+    }
+#endif
+
+    using class_kernel = std::size_t (*) (char_class,
+                                          unsigned char const*,
+                                          std::size_t,
+                                          bool) noexcept;
+
+    inline class_kernel select_class_kernel (void) noexcept
+    {
+#if RPC_SIMD_X86
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx2"))
+            return &class_run_avx2;
+        if (__builtin_cpu_supports ("sse2"))
+            return &class_run_sse2;
+#endif
+        return &class_run_scalar;
+    }
+} // namespace detail
+
+    //
+    // The length of the longest run of bytes at p (of n) in the class (or,
+    // if until, outside of it), as the predicate of the class decides of
+    // them as tokens of type T.
+    //
+    template <typename T>
+    inline std::size_t class_run (class_predicate const& predicate,
+                                  unsigned char const* const p,
+                                  std::size_t const n,
+                                  bool const until)
+    {
+        static detail::class_kernel const kernel
+            (detail::select_class_kernel ());
+
+        std::size_t i (0);
+        for (;;) {
+            i += kernel (predicate.cls, p + i, n - i, until);
+            if (i == n || p [i] < 0x80 ||
+                predicate (static_cast<T> (p [i])) == until)
+                return i;
+            ++i;
+        }
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef CHAR_CLASS_HPP
@@ -9,11 +9,20 @@
 #ifndef COMBINATORS_HPP
 #define COMBINATORS_HPP
 
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "memo.hpp"
 #include "range.hpp"
 #include "parser.hpp"
+#include "slice.hpp"
 #include "token_parsers.hpp"
 
 #include "../funktional/include/compose.hpp"
@@ -57,7 +66,7 @@ namespace core
                 "[" +
                 p.description +
                 " //bind// " +
-                fnk::utility::format_function_type<F>() +
+                describe_function_type<F> () +
                 "]",
             .parse = [=](AccT const acc) 
             {
@@ -102,18 +111,21 @@ namespace core
                 "[" + 
                 p.description + 
                 " //bindf// " + 
-                fnk::utility::format_function_type<F>() + 
+                describe_function_type<F> () + 
                 "]",
             .parse = [=](AccT const acc) 
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (AccT {&mock});
-                auto pres    (p.parse (mockptr));
-                auto q       (fnk::eval (f, toresult (*pres)));
+                auto mark (acc->mark ());
+                auto pres (detail::backtrack_point (acc, p.parse));
+                if (parse_fatal (*pres))
+                    return pres;
+
+                auto q    (fnk::eval (f, toresult (*pres)));
 
                 if (parse_success (*pres))
-                    acc->insert (*pres);
+                    acc->commit (mark);
+                else
+                    acc->truncate (mark);
 
                 return q.parse (acc);
             }
@@ -131,17 +143,18 @@ namespace core
             .description = p.description,
             .parse = [=](AccT const acc) 
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (AccT {&mock});
-                auto pres    (p.parse (mockptr));
+                auto mark (acc->mark ());
+                auto pres (p.parse (acc));
+                auto last (pres->view ());
 
-                if (parse_success (*pres))
-                    acc->replace (torange (*pres));
+                acc->truncate (mark);
+                if (parse_success (last))
+                    acc->replace (torange (last));
                 else
-                    acc->insert (toresult (*pres), torange (*pres));
+                    acc->insert (last);
                 return acc;
-            }
+            },
+            .lookahead = p.lookahead
         };
     }
 
@@ -198,7 +211,8 @@ namespace core
                     return q.parse (pres);
                 else
                     return pres;
-            }
+            },
+            .lookahead = p.lookahead.then (q.lookahead)
         };
     /*    return override_description
             (branch (p, q, basic::failwith<It, V, R> (p.description)),
@@ -269,38 +283,266 @@ namespace core
         return sequence (liftignore<U> (s), p, liftignore<U> (s));
     }
  
+namespace detail
+{
+    //
+    // Run f on the accumulator through the table of the given memoized
+    // parser: at a position already parsed, the entries recorded there are
+    // appended in place of parsing again; otherwise f parses, and the
+    // entries it appended (and where it left the range of the entry it
+    // was called upon, which ignore moves) are recorded.
+    //
+    template <typename A, typename F>
+    inline gsl::not_null_ptr<A> const memo_parse
+        (std::size_t const id, gsl::not_null_ptr<A> const acc, F const& f)
+    {
+        using E = typename A::backing_type::value_type;
+
+        auto const ctx (acc->context ());
+        auto const remaining
+            (static_cast<std::size_t> (torange (*acc).length ()));
+
+        if (ctx == nullptr || remaining > ctx->input_length ())
+            return f (acc);
+
+        auto & table (ctx->template table<E> (id));
+        if (auto const s = table.find (remaining)) {
+            auto first (s->first);
+            auto const last (first + (s->count & ~table.moved_bit) - 1);
+
+            if (s->count & table.moved_bit)
+                acc->replace (torange (table.entries [first++]));
+            for (; first < last; ++first)
+                acc->insert (table.entries [first]);
+            return acc;
+        }
+
+        auto const mark (acc->mark ());
+        auto const res  (f (acc));
+        assert (res->size () >= mark.size &&
+                "memoized parser truncated past its mark (memo_parse)");
+
+        auto const made  (res->since (mark));
+        auto const count (static_cast<std::size_t>
+            (std::distance (made.first, made.second)));
+        auto const moved
+            (static_cast<std::size_t> (torange (*res, count).length ()) !=
+             remaining);
+
+        if (table.covers (remaining) && table.has_room (count + 1)) {
+            auto const first (table.entries.size ());
+            if (moved)
+                table.entries.emplace_back (res->view (count));
+            for (auto it (made.first); it != made.second; ++it)
+                table.entries.emplace_back (*it);
+            table.record (remaining, first, moved);
+        }
+        return res;
+    }
+} // namespace detail
+
+    //
+    // Memoize a parser: its results are recorded by input position in the
+    // memo context of the parse, so that it parses at most once at each
+    // position however often it is backtracked over. This turns ordered
+    // choices between alternatives with a shared prefix from exponential
+    // to linear time, at the price of a table the length of the input (or of
+    // the input parsed since the last commit).
+    //
+    // A parser must not depend upon the results before it in order to be
+    // memoized (as, e.g., the continuation of a bind may). Without a memo
+    // context (i.e. when not run by core::parse) it simply parses.
+    //
     template <typename It, typename V, typename R>
-    inline parser<It, V, R> option (parser<It, V, R> const& p,
-                                    parser<It, V, R> const& q)
+    inline parser<It, V, R> memo (parser<It, V, R> const& p)
     {
         using A = typename parser<It, V, R>::accumulator_type;
         using AccT = gsl::not_null_ptr<A>;
+
+        auto const id (detail::next_memo_id ());
         return parser<It, V, R>
         {
-            .description =
-                "[" + p.description + " //or// " + q.description + "]",
-            .parse = [=](AccT const acc) 
+            .description = "[(memo) " + p.description + "]",
+            .parse = [=](AccT const acc)
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (AccT {&mock});
-                auto pres (p.parse (mockptr));
-                
-                if (parse_success (*pres)) {
-                    acc->insert (*pres);
-                    return acc;
-                } else {
-                    return q.parse (acc); 
+                return detail::memo_parse<A> (id, acc, p.parse);
+            },
+            .lookahead = p.lookahead
+        };
+    }
+
+namespace detail
+{
+    //
+    // The alternatives of a choice, and for parsers over byte-sized tokens,
+    // a jump table from the next token (or the end of the input) to those
+    // alternatives which may succeed there, in order: those whose FIRST set
+    // admits it. The last alternative is always among them, so that when
+    // every alternative fails, the failure is that of the last, as when
+    // each is tried in turn.
+    //
+    template <typename It, typename V, typename R>
+    struct choice_table
+    {
+    public:
+        using token_type = typename range_traits<R>::token_type;
+        using dispatch   = is_byte_token<token_type>;
+
+        static constexpr std::size_t at_end = 256;
+
+        explicit choice_table (std::vector<parser<It, V, R>> ps)
+            : alternatives (std::move (ps))
+        {
+            if (not dispatch::value)
+                return;
+
+            auto const last (alternatives.size () - 1);
+            for (std::size_t k (0); k <= at_end; ++k) {
+                offsets [k] = static_cast<std::uint32_t> (candidates.size ());
+                for (std::size_t i (0); i < last; ++i) {
+                    auto const& first (alternatives [i].lookahead);
+                    if (k == at_end ? first.admits_end ()
+                                    : first.admits
+                                        (static_cast<unsigned char> (k)))
+                        candidates.push_back
+                            (static_cast<std::uint32_t> (i));
                 }
+                candidates.push_back (static_cast<std::uint32_t> (last));
             }
+            offsets [at_end + 1] =
+                static_cast<std::uint32_t> (candidates.size ());
+        }
+
+        //
+        // the alternatives to try at the given range, as a pair of
+        // pointers into candidates (reading its first token).
+        //
+        inline std::pair<std::uint32_t const*, std::uint32_t const*>
+            at (R const& r) const
+        {
+            auto const k (r.empty ()
+                ? at_end
+                : static_cast<std::size_t>
+                    (static_cast<unsigned char> (r.head ())));
+            return std::make_pair (candidates.data () + offsets [k],
+                                   candidates.data () + offsets [k + 1]);
+        }
+
+        std::vector<parser<It, V, R>> alternatives;
+        std::array<std::uint32_t, at_end + 2> offsets;
+        std::vector<std::uint32_t> candidates;
+        // the choice's memo table, in packrat mode.
+        lazy_memo_id memo_id;
+    };
+
+    //
+    // Ordered choice among any number of alternatives: each is tried only
+    // if those before it fail. Over byte-sized tokens, only those which may
+    // succeed on the next token (by their FIRST sets) are tried at all, so
+    // that a choice between alternatives which begin differently (such as
+    // keywords) makes one attempt rather than one for each alternative.
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> choice (std::vector<parser<It, V, R>> ps)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        using table_type = choice_table<It, V, R>;
+
+        assert (not ps.empty () && "choice of no alternatives (choice call)");
+
+        auto dsc (ps.front ().description);
+        auto first (ps.front ().lookahead);
+        for (std::size_t i (1); i < ps.size (); ++i) {
+            dsc   = dsc + " //or// " + ps [i].description;
+            first = first | ps [i].lookahead;
+        }
+
+        auto const table
+            (std::make_shared<table_type const> (std::move (ps)));
+
+        auto const ordered = [table](AccT const acc)
+        {
+            auto const& alts (table->alternatives);
+            auto const last (alts.size () - 1);
+
+            for (std::size_t i (0); i < last; ++i) {
+                auto mark (acc->mark ());
+                auto res  (detail::backtrack_point (acc, alts [i].parse));
+
+                if (parse_success (*res) || parse_fatal (*res)) {
+                    acc->commit (mark);
+                    return res;
+                }
+                acc->truncate (mark);
+            }
+            return alts [last].parse (acc);
+        };
+
+        auto const dispatched = [table](AccT const acc)
+        {
+            auto const& alts (table->alternatives);
+            auto const tries (table->at (torange (*acc)));
+
+            for (auto it (tries.first); it + 1 != tries.second; ++it) {
+                auto mark (acc->mark ());
+                auto res  (detail::backtrack_point (acc, alts [*it].parse));
+
+                if (parse_success (*res) || parse_fatal (*res)) {
+                    acc->commit (mark);
+                    return res;
+                }
+                acc->truncate (mark);
+            }
+            return alts.back ().parse (acc);
+        };
+
+        return parser<It, V, R>
+        {
+            .description = "[" + dsc + "]",
+            .parse = [=](AccT const acc)
+            {
+                auto const ctx (acc->context ());
+                if (table_type::dispatch::value) {
+                    if (ctx != nullptr && ctx->packrat ())
+                        return detail::memo_parse<A>
+                            (table->memo_id.get (), acc, dispatched);
+                    return dispatched (acc);
+                } else {
+                    if (ctx != nullptr && ctx->packrat ())
+                        return detail::memo_parse<A>
+                            (table->memo_id.get (), acc, ordered);
+                    return ordered (acc);
+                }
+            },
+            .lookahead = first
         };
     }
- 
+} // namespace detail
+
+    //
+    // Ordered choice: q is tried only if p fails. In a packrat memo context,
+    // the result of every choice is memoized (see memo). Alternatives which
+    // cannot succeed on the next token (by their FIRST sets) are skipped.
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> option (parser<It, V, R> const& p,
+                                    parser<It, V, R> const& q)
+    {
+        return detail::choice (std::vector<parser<It, V, R>> {p, q});
+    }
+
+    //
+    // Ordered choice among three or more alternatives, dispatched on the
+    // next token through a single table.
+    //
     template <typename P, typename ... Qs,
               typename = std::enable_if_t<sizeof...(Qs) >= 2>>
     inline auto option (P && p, Qs && ... qs) -> typename parser_traits<P>::type
     {
-        return option (p, option (qs...));
+        using Q = typename parser_traits<P>::type;
+        return detail::choice (std::vector<Q> {p, qs...});
     }
 
     template <typename It, typename V, typename R>
@@ -318,7 +560,8 @@ namespace core
     inline parser<It, V, R> optional (parser<It, V, R> const& p)
     {
         return override_description
-            (option (p, core::pass<It, V, R>), "(optional) " + p.description);
+            (option (p, detail::make_pass<It, V, R> ()),
+             "(optional) " + p.description);
     }
 
     template <typename It, typename V, typename R>
@@ -342,6 +585,85 @@ namespace core
             "(optional) " + p.description + " | " + dflt.description);
     }
 
+    //
+    // Commit to p: once it is begun, the parse does not backtrack over it.
+    // A failure of p is made fatal, so that no enclosing choice tries
+    // another alternative and no enclosing repetition ends quietly on it;
+    // the failure passes up to the end of the parse (or to an attempt).
+    // Committing where a construct is recognized, as in
+    //
+    //      sequence (keyword, commit (rest))
+    //
+    // reports an error inside it where it is, rather than as the failure
+    // of every alternative around it. The memo context is told that the
+    // parse does not expect to return to the input before p, and so may
+    // release the memo tables' results there (see memo_context::cut); so
+    // is the input, which over a stream may then drop what lies before p
+    // (see core/stream), other than what an enclosing choice, repetition
+    // or attempt may still return to, which each holds.
+    //
+    // A commit is tried wherever it stands in a choice, whatever the next
+    // token: its FIRST set is that of everything, so that the choice fails
+    // fatally with it whether it is dispatched on the next token (over
+    // bytes) or tries each alternative in turn. Committing after the
+    // tokens which decide an alternative leaves its FIRST set as theirs.
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> commit (parser<It, V, R> const& p)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        return parser<It, V, R>
+        {
+            .description = "[(commit) " + p.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                if (auto const ctx = acc->context ())
+                    ctx->cut (static_cast<std::size_t>
+                        (torange (*acc).length ()));
+                release_input (torange (*acc));
+
+                auto res (p.parse (acc));
+                if (parse_failure (*res) && not parse_fatal (*res))
+                    res->replace (typename A::result_type
+                        {toresult_failure (*res).fatal ()});
+                return res;
+            },
+            .lookahead = first_set::any ()
+        };
+    }
+
+    //
+    // Attempt p, recovering from a fatal failure of it: the failure is made
+    // an ordinary one, which an enclosing choice may backtrack over. This
+    // bounds the reach of the commits within p, and so the input before p
+    // is held until p is done.
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> attempt (parser<It, V, R> const& p)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        return parser<It, V, R>
+        {
+            .description = "[(attempt) " + p.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                R const rng (torange (*acc));
+                hold_input (rng);
+                auto res (p.parse (acc));
+                unhold_input (rng);
+                if (parse_fatal (*res))
+                    res->replace (typename A::result_type
+                        {toresult_failure (*res).fatal (false)});
+                return res;
+            },
+            .lookahead = p.lookahead
+        };
+    }
+
     //
     // At least one but at most n successful parses; if n == 0,
     // then there is no upper bound.
@@ -359,25 +681,30 @@ namespace core
             .description = "(iterated) " + p.description,
             .parse = [=] (AccT const acc) -> AccT
             {
-                auto itered_
-                    (fnk::iterate_while
-                        (p.parse,
-                         [](AccT const a) { return parse_success (*a); },
-                         n == 0 ? 0 : n-1));
-
-                auto asize_ (acc->size ());
-                auto res_   (itered_ (acc));
-                auto diff_  (res_->size() - asize_);
-                if (not parse_success (*res_) && diff_ > 1)
-                    res_->ignore_previous ();
+                //
+                // the first successful parse has already been made by the
+                // enclosing branch, so at most n - 1 further parses remain;
+                // the trailing failure which ends the iteration is dropped.
+                //
+                auto res_ (acc);
+                for (std::size_t i = 1; n == 0 || i < n; ++i) {
+                    res_ = detail::backtrack_point (res_, p.parse);
+                    if (not parse_success (*res_)) {
+                        if (not parse_fatal (*res_))
+                            res_->ignore_previous ();
+                        break;
+                    }
+                }
                 return res_;
             }
         });
 
-        return override_description
-            (branch
-                (p, success, core::failwith<It, V, R> (p.description)),
-            "[(some) " + p.description + "]");
+        return override_lookahead
+            (override_description
+                (branch
+                    (p, success, core::failwith<It, V, R> (p.description)),
+                "[(some) " + p.description + "]"),
+            p.lookahead);
     }
 
     template <typename It, typename V, typename R>
@@ -410,20 +737,25 @@ namespace core
             {
                 auto itered_
                     (fnk::iterate_while
-                        (p.parse,
+                        ([p](AccT const a)
+                         {
+                             return detail::backtrack_point (a, p.parse);
+                         },
                          [](AccT const a) { return parse_success (*a); }));
 
                 auto res_ (itered_ (acc));
-                if (not parse_success (*res_))
+                if (not parse_success (*res_) && not parse_fatal (*res_))
                     res_->ignore_previous ();
                 return res_;
             }
         });
 
-        return override_description
-            (branch
-                (p, success, core::pass<It, V, R>),
-            "[(many) " + p.description + "]");
+        return override_lookahead
+            (override_description
+                (branch
+                    (p, success, detail::make_pass<It, V, R> ()),
+                "[(many) " + p.description + "]"),
+            p.lookahead.or_empty ());
     }
 
     template <typename It, typename V, typename R>
@@ -473,7 +805,8 @@ namespace core
                 } else {
                     return res;
                 }
-            }
+            },
+            .lookahead = p.lookahead
         };
     }
  
@@ -482,8 +815,7 @@ namespace core
     // Reduction parser: reduces over a list of parse values (using a foldr)
     // to produce a final parse result.
     //
-    template <typename F, typename B, typename It, typename V, typename R,
-        typename = std::enable_if_t<fnk::monoid<V>::is_monoid_instance::value>>
+    template <typename F, typename B, typename It, typename V, typename R>
     inline auto reducer (parser<It, V, R> const& p, F && f, B && b)
         -> parser
             <It, typename fnk::type_support::function_traits<F>::return_type, R>
@@ -500,36 +832,39 @@ namespace core
         {
             .description =
                 "[(reducer'd by" +
-                fnk::utility::format_function_type<F>() + 
+                describe_function_type<F> () + 
                 ") " + 
                 p.description + 
                 "]",
             .parse = [=](AccT const acc) 
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (MockAccT {&mock});
-                auto res (p.parse (mockptr));
+                scratch<MockA> mock {torange (*acc), acc->context (),
+                                     acc->resource ()};
+                auto res (p.parse (MockAccT {mock.get ()}));
 
                 if (parse_success (*res)) {
-                    assert (res->size() >= 1); 
-                    std::vector<V> vs;
-                    vs.reserve (res->size() - 1);
+                    assert (res->size() >= 1);
 
-                    for (auto e : *res) {
-                        auto r (toresult (e)); 
+                    //
+                    // folded from the back as the values are visited,
+                    // rather than through fnk::foldr of a copy of them.
+                    //
+                    W w (b);
+                    for (auto it (res->crbegin ()); it != res->crend (); ++it) {
+                        auto const& r (it->first);
                         if (r.is_value ())
-                            vs.emplace_back (r.to_value ());
+                            w = f (r.to_value (), w);
                     }
 
-                    acc->insert (fnk::foldr (f, b, vs), torange (*res));
+                    acc->insert (std::move (w), torange (*res));
                     return acc;
                 } else {
                     acc->insert
-                        (failure {toresult_failure (*res)}, torange (*mockptr));
+                        (failure {toresult_failure (*res)}, torange (*res));
                     return acc;
                 }
-            }
+            },
+            .lookahead = p.lookahead
         };
     }
  
@@ -538,8 +873,7 @@ namespace core
     // Reduction parser: reduces over a list of parse values (using a foldl)
     // to produce a final parse result.
     //
-    template <typename F, typename B, typename It, typename V, typename R,
-        typename = std::enable_if_t<fnk::monoid<V>::is_monoid_instance::value>>
+    template <typename F, typename B, typename It, typename V, typename R>
     inline auto reducel (parser<It, V, R> const& p, F && f, B && b)
         -> parser
             <It, typename fnk::type_support::function_traits<F>::return_type, R>
@@ -556,36 +890,40 @@ namespace core
         {
             .description =
                 "[(reducel'd by" +
-                fnk::utility::format_function_type<F>() + 
+                describe_function_type<F> () + 
                 ") " + 
                 p.description + 
                 "]",
             .parse = [=](AccT const acc) 
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (MockAccT {&mock});
-                auto res (p.parse (mockptr));
+                scratch<MockA> mock {torange (*acc), acc->context (),
+                                     acc->resource ()};
+                auto res (p.parse (MockAccT {mock.get ()}));
 
                 if (parse_success (*res)) {
                     assert (res->size() >= 1);
-                    std::vector<V> vs;
-                    vs.reserve (res->size() - 1);
 
-                    for (auto e : *res) {
-                        auto r (toresult (e)); 
+                    //
+                    // folded as the values are visited, rather than through
+                    // fnk::foldl of a copy of them (which asks a monoid of V
+                    // that the fold never uses).
+                    //
+                    W w (b);
+                    for (auto const& e : *res) {
+                        auto const& r (e.first);
                         if (r.is_value ())
-                            vs.emplace_back (r.to_value ());
+                            w = f (r.to_value (), w);
                     }
 
-                    acc->insert (fnk::foldl (f, b, vs), torange (*res));
+                    acc->insert (std::move (w), torange (*res));
                     return acc;
                 } else {
                     acc->insert
-                        (failure {toresult_failure (*res)}, torange (*mockptr));
+                        (failure {toresult_failure (*res)}, torange (*res));
                     return acc;
                 }
-            }
+            },
+            .lookahead = p.lookahead
         };
     }
 
@@ -608,6 +946,180 @@ namespace core
     }
 
 
+namespace detail
+{
+    //
+    // fold a value into b: in place, by f (v, b), if f returns nothing;
+    // otherwise by b = f (v, b), as reducel does.
+    //
+    template <typename F, typename V, typename W>
+    inline void fold_into (F const& f, V const& v, W & b, std::true_type)
+    {
+        f (v, b);
+    }
+
+    template <typename F, typename V, typename W>
+    inline void fold_into (F const& f, V const& v, W & b, std::false_type)
+    {
+        b = f (v, b);
+    }
+
+    //
+    // Parse p repeatedly (at least n times), folding each value into b as
+    // soon as it is made. p is parsed in a scratch accumulator which is
+    // reset for each repetition, and the result of the fold is placed at
+    // once and its range moved on after each one; so the accumulator does
+    // not grow with the number of repetitions. The repetition also ends if
+    // p succeeds without consuming input.
+    //
+    template <typename It, typename V, typename R, typename F, typename W>
+    inline gsl::not_null_ptr<typename parser<It, W, R>::accumulator_type> const
+        fold_parse (parser<It, V, R> const& p, F const& f, W const& b,
+                    std::size_t const n,
+                    gsl::not_null_ptr
+                        <typename parser<It, W, R>::accumulator_type> const acc)
+    {
+        using A = typename parser<It, W, R>::accumulator_type;
+
+        using MockA = typename parser<It, V, R>::accumulator_type;
+        using MockAccT = gsl::not_null_ptr<MockA>;
+
+        using in_place = std::is_void
+            <decltype (f (std::declval<V const&> (), std::declval<W &> ()))>;
+
+        scratch<MockA> mock {torange (*acc), acc->context (), acc->resource ()};
+        acc->insert (empty<W> {}, torange (*acc));
+
+        W b_ (b);
+        for (std::size_t i (0); ; ++i) {
+            mock->reset (empty<V> {}, torange (*acc));
+            auto res (detail::backtrack_point
+                (MockAccT {mock.get ()}, p.parse));
+
+            if (not parse_success (*res)) {
+                if (i < n || parse_fatal (*res)) {
+                    acc->replace
+                        (failure {toresult_failure (*res)}, torange (*res));
+                    return acc;
+                }
+                break;
+            }
+
+            auto made (res->since (1));
+            for (auto it (made.first); it != made.second; ++it)
+                if (it->first.is_value ())
+                    fold_into (f, it->first.to_value (), b_, in_place {});
+
+            if (torange (*res).length () == torange (*acc).length ())
+                break;
+            acc->replace (torange (*res));
+        }
+
+        acc->replace (typename A::result_type {std::move (b_)});
+        return acc;
+    }
+} // namespace detail
+
+    //
+    // Zero or more successful parses, whose values are folded to the left
+    // into b as they are made: by b = f (v, b), as for reducel, or in place
+    // by f (v, b) if f returns nothing (taking b by reference). Unlike
+    // reducel (many (p), f, b), neither the accumulator nor a list of the
+    // values grows with the number of parses.
+    //
+    template <typename F, typename B, typename It, typename V, typename R>
+    inline auto fold_many (parser<It, V, R> const& p, F && f, B && b)
+        -> parser<It, std::decay_t<B>, R>
+    {
+        using W = std::decay_t<B>;
+
+        using A = typename parser<It, W, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        return parser<It, W, R>
+        {
+            .description =
+                "[(fold_many by " +
+                describe_function_type<F> () +
+                ") " +
+                p.description +
+                "]",
+            .parse = [=, b_ = W (std::forward<B> (b))](AccT const acc)
+            {
+                return detail::fold_parse (p, f, b_, 0, acc);
+            },
+            .lookahead = p.lookahead.or_empty ()
+        };
+    }
+
+    //
+    // At least one successful parse, folded as by fold_many.
+    //
+    template <typename F, typename B, typename It, typename V, typename R>
+    inline auto fold_some (parser<It, V, R> const& p, F && f, B && b)
+        -> parser<It, std::decay_t<B>, R>
+    {
+        using W = std::decay_t<B>;
+
+        using A = typename parser<It, W, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        return parser<It, W, R>
+        {
+            .description =
+                "[(fold_some by " +
+                describe_function_type<F> () +
+                ") " +
+                p.description +
+                "]",
+            .parse = [=, b_ = W (std::forward<B> (b))](AccT const acc)
+            {
+                return detail::fold_parse (p, f, b_, 1, acc);
+            },
+            .lookahead = p.lookahead
+        };
+    }
+
+    //
+    // Zero or more successful parses, whose results are discarded as they
+    // are made: as with ignore, the range of the result the parser is called
+    // upon is moved on past them, and nothing is added to the accumulator.
+    // The repetition also ends if p succeeds without consuming input.
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> skip_many (parser<It, V, R> const& p)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        return parser<It, V, R>
+        {
+            .description = "[(skip_many) " + p.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                for (;;) {
+                    auto const mark (acc->mark ());
+                    auto res (detail::backtrack_point (acc, p.parse));
+                    if (parse_fatal (*res))
+                        return res;
+                    if (not parse_success (*res)) {
+                        res->truncate (mark);
+                        break;
+                    }
+
+                    R const next (torange (*res));
+                    res->ignore_previous (res->size () - mark.size);
+                    if (next.length () == mark.range.length ())
+                        break;
+                    res->replace (next);
+                }
+                return acc;
+            },
+            .lookahead = p.lookahead.or_empty ()
+        };
+    }
+
+
     //
     // Lift a parser to a new value type using an existing type conversion
     // (by static_cast).
@@ -642,32 +1154,37 @@ namespace core
                 "[" +
                 p.description +
                 " //fmap// " +
-                fnk::utility::format_function_type<F>() +
+                describe_function_type<F> () +
                 "]",
             .parse =
             [=](AccT const acc) 
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (MockAccT {&mock}); 
-                auto res     (p.parse (mockptr));
+                scratch<MockA> mock {torange (*acc), acc->context (),
+                                     acc->resource ()};
+                auto res (p.parse (MockAccT {mock.get ()}));
 
                 if (parse_success (*res)) {
-                    for (auto e : *res) {
-                        auto r (toresult (e));
+                    auto made (res->since (1));
+                    for (auto it (made.first); it != made.second; ++it) {
+                        auto const& r (it->first);
                         if (r.is_value ())
                             acc->insert
-                                (fnk::eval (f, r.to_value ()), torange (e));
+                                (fnk::eval (f, r.to_value ()), torange (*it));
                         else if (r.is_empty ())
-                            acc->insert (empty<U>{}, torange (e));
+                            acc->insert (empty<U>{}, torange (*it));
                     }
+                    // a parse which only moved its range on (as ignore and
+                    // skip_many do) moves on the range of this one.
+                    if (made.first == made.second)
+                        acc->replace (torange (*res));
                     return acc;
                 } else {
                     acc->insert
-                        (failure {toresult_failure (*res)}, torange (*mockptr));
+                        (failure {toresult_failure (*res)}, torange (*res));
                     return acc;
                 }
-            }
+            },
+            .lookahead = p.lookahead
         };
     }
 
@@ -785,26 +1302,67 @@ namespace core
         {
             .description =
                 "[(injected value: " +
-                fnk::utility::type_name<U>::name() +
+                describe_type<U> () +
                 ") " +
                 p.description,
             .parse = [=](AccT const acc) 
             {
-                typename parser<It, V, R>::accumulator_type mock
-                    { empty<V>{}, torange (*acc) };
-                auto mockptr (MockAccT {&mock});
-                auto res     (p.parse (mockptr));
+                scratch<MockA> mock {torange (*acc), acc->context (),
+                                     acc->resource ()};
+                auto res (p.parse (MockAccT {mock.get ()}));
 
                 if (parse_success (*res)) {
-                    for (auto e : *res)
-                        acc->insert (static_cast<C>(u), torange (e));
+                    auto made (res->since (1));
+                    for (auto it (made.first); it != made.second; ++it)
+                        acc->insert (static_cast<C>(u), torange (*it));
+                    if (made.first == made.second)
+                        acc->replace (torange (*res));
                     return acc; 
                 } else {
                     acc->insert
-                        (failure {toresult_failure (*res)}, torange (*mockptr));
+                        (failure {toresult_failure (*res)}, torange (*res));
                     return acc;
                 }
-            }
+            },
+            .lookahead = p.lookahead
+        };
+    }
+
+
+    //
+    // The run of input a successful parse of p consumed, in the place of the
+    // values p made, as an S made from the iterators at its ends: a slice of
+    // the input, or a string copied out of it.
+    //
+    template <typename S, typename It, typename V, typename R>
+    inline parser<It, S, R> recognize (parser<It, V, R> const& p)
+    {
+        using A = typename parser<It, S, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        using MockA = typename parser<It, V, R>::accumulator_type;
+        using MockAccT = gsl::not_null_ptr<MockA>;
+
+        return parser<It, S, R>
+        {
+            .description = "[(recognize) " + p.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                auto const rng (torange (*acc));
+                scratch<MockA> mock {rng, acc->context (), acc->resource ()};
+                auto res (p.parse (MockAccT {mock.get ()}));
+
+                if (parse_success (*res)) {
+                    R const next (torange (*res));
+                    acc->insert
+                        (parse_result<S> {S (rng.begin (), next.begin ())},
+                         next);
+                } else
+                    acc->insert
+                        (failure {toresult_failure (*res)}, torange (*res));
+                return acc;
+            },
+            .lookahead = p.lookahead
         };
     }
 
@@ -832,30 +1390,241 @@ namespace core
     {
         return lift (p, f); 
     }
-/*
 namespace detail
 {
-    template <typename It, typename V, typename F>
-    inline decltype(auto) rest (V const& v, parser<It, V> const& p, parser<It, F> const& op)
+    //
+    // the last value among the results of an accumulator past the first n,
+    // or nullptr if none of them is a value.
+    //
+    template <typename A>
+    inline typename A::result_type const* last_value (A const& acc,
+                                                      std::size_t const n)
+        noexcept
+    {
+        auto made (acc.since (n));
+        for (auto it (made.second); it != made.first; ) {
+            --it;
+            if (it->first.is_value ())
+                return &it->first;
+        }
+        return nullptr;
+    }
+
+    //
+    // A chain is parsed in a loop, in constant space on the call stack and
+    // the accumulator: its result is placed once its first operand has been
+    // parsed, and each further operand is parsed after it, has its value
+    // taken out and folded in (by link), and is discarded, moving the range
+    // of the result on. Operators are parsed in a scratch accumulator, which
+    // is reset for each of them.
+    //
+    // The chain ends before the first operator which fails, or which is not
+    // followed by an operand; that operator is backtracked over. An operand
+    // or operator which succeeds without making a value also ends it, and
+    // one which fails fatally (see commit) fails the chain.
+    //
+    template <typename It, typename V, typename F, typename R, typename G>
+    inline gsl::not_null_ptr<typename parser<It, V, R>::accumulator_type> const
+        chain_parse (parser<It, V, R> const& p,
+                     parser<It, F, R> const& op,
+                     gsl::not_null_ptr
+                        <typename parser<It, V, R>::accumulator_type> const acc,
+                     G && link)
     {
-        return parser<It, V>
+        using A = typename parser<It, V, R>::accumulator_type;
+
+        using OpA = typename parser<It, F, R>::accumulator_type;
+        using OpAccT = gsl::not_null_ptr<OpA>;
+
+        auto const start (acc->mark ());
+        auto res (p.parse (acc));
+        if (not parse_success (*res))
+            return res;
+
+        auto const first (last_value (*res, start.size));
+        if (first == nullptr)
+            return res;
+
+        V x (first->to_value ());
+        R const after (torange (*res));
+        res->truncate (start);
+        res->insert (empty<V> {}, after);
+
+        scratch<OpA> oper {after, res->context (), res->resource ()};
+
+        //
+        // each operator and the operand after it are parsed from a point
+        // of backtracking (see backtrack_point), held until both are done.
+        //
+        for (;;) {
+            auto const tip (res->mark ());
+            auto const back = [&tip](void)
+            {
+                rewind_input (tip.range);
+                unhold_input (tip.range);
+            };
+            hold_input (tip.range);
+
+            oper->reset (empty<F> {}, tip.range);
+            auto ores (op.parse (OpAccT {oper.get ()}));
+            if (parse_fatal (*ores)) {
+                unhold_input (tip.range);
+                res->insert
+                    (failure {toresult_failure (*ores)}, torange (*ores));
+                return res;
+            }
+            auto const f (parse_success (*ores)
+                ? last_value (*ores, 1) : nullptr);
+            if (f == nullptr) {
+                back ();
+                break;
+            }
+
+            res->replace (torange (*ores));
+            auto yres (p.parse (res));
+            if (parse_fatal (*yres)) {
+                unhold_input (tip.range);
+                return yres;
+            }
+
+            auto const y (parse_success (*yres)
+                ? last_value (*yres, tip.size) : nullptr);
+            if (y == nullptr) {
+                yres->truncate (tip);
+                back ();
+                break;
+            }
+            unhold_input (tip.range);
+
+            link (x, f->to_value (), y->to_value ());
+            R const next (torange (*yres));
+            yres->ignore_previous (yres->size () - tip.size);
+            yres->replace (next);
+        }
+
+        res->replace (typename A::result_type {link (x)});
+        return res;
+    }
+} // namespace detail
+
+    //
+    // One or more p separated by op, whose values are functions (of type
+    // F, callable as V (V, V)), folded to the left as they are parsed:
+    // p1 op1 p2 op2 p3 makes op2 (op1 (p1, p2), p3). The parse is a loop
+    // rather than a recursion, so chains of any length are parsed in
+    // constant stack and accumulator space.
+    //
+    template <typename It, typename V, typename F, typename R>
+    inline parser<It, V, R> chainl1 (parser<It, V, R> const& p,
+                                     parser<It, F, R> const& op)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        struct fold
+        {
+            inline void operator() (V & x, F const& f, V const& y)
+            {
+                x = fnk::eval (f, std::move (x), y);
+            }
+
+            inline V & operator() (V & x) const noexcept
+            {
+                return x;
+            }
+        };
+
+        return parser<It, V, R>
         {
-            
+            .description =
+                "[(chainl1) " + p.description + " " + op.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                return detail::chain_parse (p, op, acc, fold {});
+            },
+            .lookahead = p.lookahead
         };
     }
-} // namespace detail
 
-    template <typename It, typename V, typename F>
-    inline decltype(auto) chainls (parser<It, V> const& p, parser<It, F> const& op)
+    //
+    // Zero or more p separated by op, folded to the left; if there are
+    // none, the value is v.
+    //
+    template <typename It, typename V, typename F, typename R>
+    inline parser<It, V, R> chainl (parser<It, V, R> const& p,
+                                    parser<It, F, R> const& op,
+                                    V const& v)
+    {
+        auto const chain (chainl1 (p, op));
+        return override_description
+            (option (chain, core::unit<It, V, R> (v)),
+             "[(chainl) " + p.description + " " + op.description + "]");
+    }
+
+    //
+    // One or more p separated by op, folded to the right: p1 op1 p2 op2 p3
+    // makes op1 (p1, op2 (p2, p3)). The operands and operators are held
+    // until the last operand is parsed, and then folded in a loop; as with
+    // chainl1, the call stack does not grow with the length of the chain.
+    //
+    template <typename It, typename V, typename F, typename R>
+    inline parser<It, V, R> chainr1 (parser<It, V, R> const& p,
+                                     parser<It, F, R> const& op)
     {
-        return parser<It, V>
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        struct fold
         {
-            .parse = [=](typename parser<It, V>::range_type const& r)
+            inline void operator() (V & x, F const& f, V const& y)
+            {
+                if (xs.empty ())
+                    xs.push_back (std::move (x));
+                fs.push_back (f);
+                xs.push_back (y);
+            }
+
+            inline V & operator() (V & x)
             {
+                if (xs.empty ())
+                    return x;
+
+                x = std::move (xs.back ());
+                for (auto i (fs.size ()); i-- > 0; )
+                    x = fnk::eval (fs [i], std::move (xs [i]), std::move (x));
+                return x;
             }
+
+            std::vector<V> xs;
+            std::vector<F> fs;
         };
+
+        return parser<It, V, R>
+        {
+            .description =
+                "[(chainr1) " + p.description + " " + op.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                return detail::chain_parse (p, op, acc, fold {});
+            },
+            .lookahead = p.lookahead
+        };
+    }
+
+    //
+    // Zero or more p separated by op, folded to the right; if there are
+    // none, the value is v.
+    //
+    template <typename It, typename V, typename F, typename R>
+    inline parser<It, V, R> chainr (parser<It, V, R> const& p,
+                                    parser<It, F, R> const& op,
+                                    V const& v)
+    {
+        auto const chain (chainr1 (p, op));
+        return override_description
+            (option (chain, core::unit<It, V, R> (v)),
+             "[(chainr) " + p.description + " " + op.description + "]");
     }
-*/
 } // namespace core
 } // namespace rpc
 
@@ -0,0 +1,256 @@
+//
+// Parser descriptions, built as shared trees and rendered on demand
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef DESCRIPTION_HPP
+#define DESCRIPTION_HPP
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "result_type.hpp"
+
+#include "../funktional/include/utility/type_utils.hpp"
+
+//
+// Define RPC_NO_DESCRIPTIONS to drop parser descriptions entirely; every
+// description is then empty, and building or combining one costs nothing.
+// The expectations made from descriptions are dropped with them (a parser
+// which fails then fails with the plain message "failure"); other failure
+// messages are unaffected.
+//
+#ifndef RPC_NO_DESCRIPTIONS
+#define RPC_NO_DESCRIPTIONS 0
+#else
+#undef  RPC_NO_DESCRIPTIONS
+#define RPC_NO_DESCRIPTIONS 1
+#endif
+
+namespace rpc
+{
+namespace core
+{
+#if not RPC_NO_DESCRIPTIONS
+    //
+    // A description is a pointer to an immutable node: a piece of text, a
+    // function which produces the text when asked (e.g. for demangled type
+    // names), or the concatenation of two descriptions. Combining
+    // descriptions shares the nodes of both rather than copying their text,
+    // and so the description of a grammar is linear in the size of the
+    // grammar. The text is only rendered by str ().
+    //
+    struct description
+    {
+    public:
+        description (void) : node_ (nullptr) {}
+
+        //
+        // text made at runtime (e.g. by a parser built while parsing) is
+        // held by its node, and freed with the last description of it.
+        //
+        description (std::string s)
+            : node_ (s.empty () ? nullptr : std::make_shared<node const>
+                (node {nullptr, nullptr, nullptr, nullptr, std::move (s)}))
+        {}
+
+        //
+        // the text of a literal is interned, so that each distinct piece
+        // is stored once however many parsers it describes.
+        //
+        description (char const* s)
+            : node_ (*s == '\0' ? nullptr : std::make_shared<node const>
+                (node {intern (s), nullptr, nullptr, nullptr, {}}))
+        {}
+
+        //
+        // a description whose text is produced by f () when rendered.
+        //
+        template <typename F>
+        static inline description deferred (F && f)
+        {
+            return description
+                (std::make_shared<node const>
+                    (node {nullptr,
+                           std::function<std::string ()>
+                                {std::forward<F> (f)},
+                           nullptr,
+                           nullptr,
+                           {}}));
+        }
+
+        inline bool empty (void) const noexcept
+        {
+            return node_ == nullptr;
+        }
+
+        inline std::string str (void) const
+        {
+            std::string out;
+            render (node_.get (), out);
+            return out;
+        }
+
+        inline operator std::string (void) const
+        {
+            return str ();
+        }
+
+        friend inline description operator+
+            (description const& lhs, description const& rhs)
+        {
+            if (lhs.empty ())
+                return rhs;
+            if (rhs.empty ())
+                return lhs;
+            return description
+                (std::make_shared<node const>
+                    (node {nullptr, nullptr, lhs.node_, rhs.node_, {}}));
+        }
+
+    private:
+        struct node
+        {
+            std::string const* text;
+            std::function<std::string ()> make;
+            std::shared_ptr<node const> left;
+            std::shared_ptr<node const> right;
+            std::string owned;
+        };
+
+        explicit description (std::shared_ptr<node const> n)
+            : node_ (std::move (n))
+        {}
+
+        static inline void render (node const* n, std::string & out)
+        {
+            while (n != nullptr) {
+                if (n->text)
+                    out.append (*n->text);
+                else if (n->make)
+                    out.append (n->make ());
+                else if (n->left)
+                    render (n->left.get (), out);
+                else
+                    out.append (n->owned);
+                n = n->right.get ();
+            }
+        }
+
+        std::shared_ptr<node const> node_;
+    };
+
+namespace detail
+{
+    //
+    // the message of an expectation, rendered from a description when it
+    // is asked for.
+    //
+    struct described_text : public message_source
+    {
+        explicit described_text (description const& d) : description_ (d) {}
+
+        inline std::string text (void) const override
+        {
+            return description_.str ();
+        }
+
+    private:
+        description const description_;
+    };
+} // namespace detail
+
+    //
+    // What a parser expected to find, as described by d (usually, the
+    // description of the parser itself); the description is shared with
+    // the expectation, not rendered, until a failure made from it is asked
+    // for its message.
+    //
+    inline expectation expect (description const& d)
+    {
+        return failure_message::expected (new detail::described_text {d});
+    }
+#else
+    struct description
+    {
+    public:
+        description (void) noexcept {}
+        description (std::string const&) noexcept {}
+        description (char const*) noexcept {}
+
+        template <typename F>
+        static inline description deferred (F &&) noexcept
+        {
+            return description {};
+        }
+
+        inline bool empty (void) const noexcept
+        {
+            return true;
+        }
+
+        inline std::string str (void) const
+        {
+            return std::string ();
+        }
+
+        inline operator std::string (void) const
+        {
+            return str ();
+        }
+
+        friend inline description operator+
+            (description const&, description const&) noexcept
+        {
+            return description {};
+        }
+    };
+
+    inline expectation expect (description const&)
+    {
+        return failure_message {};
+    }
+#endif
+
+    inline std::ostream& operator<< (std::ostream& os, description const& d)
+    {
+        return (os << d.str ());
+    }
+
+    //
+    // descriptions of types, demangled only when rendered.
+    //
+    template <typename T>
+    inline description describe_type (void)
+    {
+        return description::deferred (&fnk::utility::type_name<T>::name);
+    }
+
+    template <typename F>
+    inline description describe_function_type (void)
+    {
+        return description::deferred
+            (&fnk::utility::format_function_type<F>);
+    }
+
+    //
+    // the expectation of a parser of tokens of type T at the end of its
+    // input; one for each T, made when it is first needed.
+    //
+    template <typename T>
+    inline expectation expect_item (void)
+    {
+        static expectation const e
+            (expect ("[item :: " + describe_type<T> () + "]"));
+        return e;
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef DESCRIPTION_HPP
@@ -0,0 +1,150 @@
+//
+// FIRST sets of parsers over byte-sized tokens, for lookahead dispatch
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef FIRST_SET_HPP
+#define FIRST_SET_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // tokens of one byte (char, signed char, unsigned char, and so on) may
+    // index a table of 256 entries; FIRST sets are only computed for them.
+    //
+    template <typename T>
+    struct is_byte_token
+        : public std::integral_constant
+            <bool, std::is_integral<T>::value && sizeof (T) == 1>
+    {};
+
+    //
+    // What a parser may begin with: the set of tokens which may be the
+    // first that it consumes, and whether it may succeed without consuming
+    // any. A parser which is not nullable fails wherever the next token is
+    // not in its set (or there is no next token).
+    //
+    // Every parser has one. A parser whose set is not known (because it is
+    // built from a function, or parses tokens larger than a byte) has the
+    // set of everything, and is nullable; no decision is ever made on it.
+    //
+    struct first_set
+    {
+    public:
+        static inline first_set any (void) noexcept
+        {
+            auto const all (std::numeric_limits<std::uint64_t>::max ());
+            return first_set {{{all, all, all, all}}, true};
+        }
+
+        static inline first_set none (void) noexcept
+        {
+            return first_set {{{0, 0, 0, 0}}, false};
+        }
+
+        static inline first_set epsilon (void) noexcept
+        {
+            return first_set {{{0, 0, 0, 0}}, true};
+        }
+
+        inline bool test (unsigned char const b) const noexcept
+        {
+            return (bits [b >> 6] >> (b & 63)) & 1;
+        }
+
+        inline void set (unsigned char const b) noexcept
+        {
+            bits [b >> 6] |= std::uint64_t (1) << (b & 63);
+        }
+
+        //
+        // whether a parser with this set may succeed on an input beginning
+        // with b, or on the end of the input.
+        //
+        inline bool admits (unsigned char const b) const noexcept
+        {
+            return nullable || test (b);
+        }
+
+        inline bool admits_end (void) const noexcept
+        {
+            return nullable;
+        }
+
+        inline bool is_any (void) const noexcept
+        {
+            return nullable && (bits [0] & bits [1] & bits [2] & bits [3]) ==
+                std::numeric_limits<std::uint64_t>::max ();
+        }
+
+        //
+        // either of two parsers (as option).
+        //
+        friend inline first_set operator| (first_set const& a,
+                                           first_set const& b) noexcept
+        {
+            return first_set
+            {
+                {{a.bits [0] | b.bits [0], a.bits [1] | b.bits [1],
+                  a.bits [2] | b.bits [2], a.bits [3] | b.bits [3]}},
+                a.nullable || b.nullable
+            };
+        }
+
+        //
+        // one parser followed by another (as sequence): the second may only
+        // begin the pair if the first is nullable.
+        //
+        inline first_set then (first_set const& b) const noexcept
+        {
+            return nullable
+                ? first_set {(*this | b).bits, b.nullable}
+                : *this;
+        }
+
+        //
+        // the same set, but nullable (as optional and many).
+        //
+        inline first_set or_empty (void) const noexcept
+        {
+            return first_set {bits, true};
+        }
+
+        std::array<std::uint64_t, 4> bits;
+        bool nullable;
+    };
+
+    //
+    // the FIRST set of a predicate on byte-sized tokens, found by asking it
+    // of every byte; the predicate must depend on nothing but its argument
+    // (see pure, in token_parsers).
+    //
+    template <typename T, typename Pr>
+    inline first_set first_of (Pr const& predicate, std::true_type)
+    {
+        auto s (first_set::none ());
+        for (unsigned b (0); b < 256; ++b)
+            if (predicate (static_cast<T> (static_cast<unsigned char> (b))))
+                s.set (static_cast<unsigned char> (b));
+        return s;
+    }
+
+    template <typename T, typename Pr>
+    inline first_set first_of (Pr const&, std::false_type)
+    {
+        return first_set::any ();
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef FIRST_SET_HPP
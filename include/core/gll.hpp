@@ -0,0 +1,718 @@
+//
+// Generalized LL parsing of grammars whose terminals are parsers
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef GLL_HPP
+#define GLL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "accumulator.hpp"
+#include "parser.hpp"
+#include "range.hpp"
+#include "result_type.hpp"
+
+#include "../gsl/not_null.hpp"
+
+//
+// A core::parser is a function, and so a grammar built from the combinators
+// can only be run by calling it: by recursive descent with backtracking,
+// which loops forever on a left recursive rule and takes exponential time
+// to explore an ambiguous one. The GLL algorithm of Scott & Johnstone
+// (GLL Parsing, 2009; GLL Parse-Tree Generation, 2013) handles any context
+// free grammar, left recursive and ambiguous ones included, in at worst
+// cubic time (and close to linear time for grammars which are nearly
+// deterministic), but it must see the rules of the grammar as data.
+//
+// A gll::grammar is such a set of rules, whose terminals are core::parsers
+// (a token, a word, a number, or any grammar built from the combinators);
+// gll::parse runs it and returns every derivation of the start symbol as a
+// shared packed parse forest, and gll::to_parser turns it back into a
+// core::parser which may be used among the combinators.
+//
+namespace rpc
+{
+namespace core
+{
+namespace gll
+{
+    static constexpr std::size_t none = static_cast<std::size_t> (-1);
+
+    //
+    // A symbol of a grammar: a nonterminal, or a terminal parser.
+    //
+    struct symbol
+    {
+        bool terminal;
+        std::size_t id;
+    };
+
+    template <typename It, typename V, typename R = range<It>>
+    struct grammar
+    {
+    public:
+        using range_type    = R;
+        using value_type    = V;
+        using terminal_type = parser<It, V, R>;
+
+        inline symbol nonterminal (std::string const& name)
+        {
+            names_.push_back (name);
+            rules_.emplace_back ();
+            return symbol {false, names_.size () - 1};
+        }
+
+        inline symbol terminal (terminal_type const& p)
+        {
+            terminals_.push_back (p);
+            return symbol {true, terminals_.size () - 1};
+        }
+
+        //
+        // add the alternative nt ::= symbols; an empty list of symbols
+        // is the empty alternative.
+        //
+        inline void rule (symbol const nt, std::vector<symbol> symbols)
+        {
+            assert (not nt.terminal && nt.id < rules_.size () &&
+                    "left hand side must be a nonterminal (rule call)");
+
+            rules_ [nt.id].push_back (std::move (symbols));
+        }
+
+        inline void rule (symbol const nt, std::initializer_list<symbol> ss)
+        {
+            rule (nt, std::vector<symbol> (ss));
+        }
+
+        inline std::string const& name (std::size_t const nt) const
+        {
+            return names_ [nt];
+        }
+
+        inline std::size_t nonterminals (void) const noexcept
+        {
+            return rules_.size ();
+        }
+
+        inline std::vector<std::vector<symbol>> const& alternatives
+            (std::size_t const nt) const
+        {
+            return rules_ [nt];
+        }
+
+        inline terminal_type const& terminal_parser (std::size_t const t) const
+        {
+            return terminals_ [t];
+        }
+
+    private:
+        std::vector<std::string> names_;
+        std::vector<std::vector<std::vector<symbol>>> rules_;
+        std::vector<terminal_type> terminals_;
+    };
+
+    //
+    // A shared packed parse forest: a symbol node (X, i, j) stands for every
+    // derivation of X from the input between positions i and j, each one a
+    // packed child; intermediate nodes binarize the alternatives, so that
+    // the forest is at most cubic in the length of the input. Positions
+    // are offsets from the start of the input parsed.
+    //
+    template <typename V, typename R>
+    struct forest
+    {
+    public:
+        enum class kind : std::uint8_t
+        {
+            TERMINAL,
+            EPSILON,
+            SYMBOL,
+            INTERMEDIATE
+        };
+
+        struct node
+        {
+            kind k;
+            // terminal, nonterminal or slot
+            std::size_t label;
+            std::size_t left;
+            std::size_t right;
+            // first of the packed children (a list, linked by next)
+            std::size_t packed;
+            // terminals: the values parsed, and the range after them
+            std::size_t first_value;
+            std::size_t last_value;
+            std::size_t end;
+        };
+
+        struct packed_node
+        {
+            std::size_t slot;
+            std::size_t pivot;
+            std::size_t left;
+            std::size_t right;
+            std::size_t next;
+        };
+
+        std::vector<node> nodes;
+        std::vector<packed_node> packed;
+        std::vector<V> values;
+        std::vector<R> ends;
+        // the symbol nodes of the start symbol which begin at 0
+        std::vector<std::size_t> roots;
+
+        inline bool success (void) const noexcept
+        {
+            return not roots.empty ();
+        }
+
+        //
+        // the root which derives the longest prefix of the input.
+        //
+        inline std::size_t root (void) const noexcept
+        {
+            std::size_t best (none);
+            for (auto const r : roots)
+                if (best == none || nodes [r].right > nodes [best].right)
+                    best = r;
+            return best;
+        }
+
+        //
+        // the number of nodes below n with more than one derivation.
+        //
+        inline std::size_t ambiguities (std::size_t const n) const
+        {
+            std::size_t count (0);
+            std::vector<std::size_t> stack {n};
+            std::unordered_set<std::size_t> seen {n};
+
+            while (not stack.empty ()) {
+                auto const at (stack.back ());
+                stack.pop_back ();
+
+                auto p (nodes [at].packed);
+                if (p != none && packed [p].next != none)
+                    ++count;
+                for (; p != none; p = packed [p].next)
+                    for (auto const c : {packed [p].left, packed [p].right})
+                        if (c != none && seen.insert (c).second)
+                            stack.push_back (c);
+            }
+            return count;
+        }
+
+        //
+        // visit the terminals of the first derivation below n, from left
+        // to right, with f (first value, last value, range after).
+        //
+        template <typename F>
+        inline void first_derivation (std::size_t const n, F && f) const
+        {
+            std::vector<std::size_t> stack {n};
+            while (not stack.empty ()) {
+                auto const at (stack.back ());
+                stack.pop_back ();
+
+                auto const& nd (nodes [at]);
+                if (nd.k == kind::TERMINAL) {
+                    f (nd.first_value, nd.last_value, ends [nd.end]);
+                } else if (nd.packed != none) {
+                    auto const& p (packed [nd.packed]);
+                    if (p.right != none)
+                        stack.push_back (p.right);
+                    if (p.left != none)
+                        stack.push_back (p.left);
+                }
+            }
+        }
+    };
+
+namespace detail
+{
+    //
+    // The sets of the algorithm (of descriptors, stack nodes and edges,
+    // forest nodes, ...) are all keyed by small tuples of indices; they are
+    // kept in flat, open addressed tables (with linear probing), which stay
+    // cache friendly as they grow to millions of entries.
+    //
+    template <std::size_t N>
+    struct flat_index
+    {
+    public:
+        using key_type = std::array<std::size_t, N>;
+
+        //
+        // the value of the key, and whether it was absent, in which case
+        // the given value (which must not be none) is inserted.
+        //
+        inline std::pair<std::size_t, bool> insert (key_type const& k,
+                                                    std::size_t const v)
+        {
+            assert (v != none && "cannot insert none (flat_index::insert)");
+
+            if (2 * (size_ + 1) > table_.size ())
+                grow ();
+
+            auto & e (table_ [probe (k)]);
+            if (e.value != none)
+                return std::make_pair (e.value, false);
+
+            e.key   = k;
+            e.value = v;
+            ++size_;
+            return std::make_pair (v, true);
+        }
+
+        inline std::size_t find (key_type const& k) const noexcept
+        {
+            return table_.empty () ? none : table_ [probe (k)].value;
+        }
+
+    private:
+        struct entry
+        {
+            key_type key;
+            std::size_t value;
+        };
+
+        static inline std::size_t hash (key_type const& k) noexcept
+        {
+            std::uint64_t h (0x9e3779b97f4a7c15ull);
+            for (auto const x : k) {
+                h ^= x;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 32;
+            }
+            return static_cast<std::size_t> (h);
+        }
+
+        inline std::size_t probe (key_type const& k) const noexcept
+        {
+            auto const mask (table_.size () - 1);
+            auto i (hash (k) & mask);
+            while (table_ [i].value != none && table_ [i].key != k)
+                i = (i + 1) & mask;
+            return i;
+        }
+
+        inline void grow (void)
+        {
+            std::vector<entry> old (std::max<std::size_t>
+                (64, 2 * table_.size ()), entry {key_type {}, none});
+            old.swap (table_);
+            for (auto const& e : old)
+                if (e.value != none)
+                    table_ [probe (e.key)] = e;
+        }
+
+        std::vector<entry> table_;
+        std::size_t size_ = 0;
+    };
+
+    //
+    // The GLL algorithm, interpreting the grammar slot by slot. A slot
+    // X ::= a . b is a position within an alternative, and is numbered so
+    // that the slots of an alternative are consecutive.
+    //
+    template <typename It, typename V, typename R>
+    struct engine
+    {
+    public:
+        using grammar_type = grammar<It, V, R>;
+        using forest_type  = forest<V, R>;
+        using kind         = typename forest_type::kind;
+
+        explicit engine (grammar_type const& g) : g_ (g)
+        {
+            for (std::size_t x = 0; x < g_.nonterminals (); ++x) {
+                first_slot_.emplace_back ();
+                for (auto const& alt : g_.alternatives (x)) {
+                    first_slot_.back ().push_back (slots_.size ());
+                    for (std::size_t d = 0; d <= alt.size (); ++d)
+                        slots_.push_back (slot_info {x, &alt, d});
+                }
+            }
+            compute_nullable ();
+        }
+
+        inline forest_type run (std::size_t const start, R const& r)
+        {
+            length_ = static_cast<std::size_t> (r.length ());
+            start_  = start;
+
+            // the root of the stack, to which the start symbol returns.
+            gss_.push_back (gss_node {none, 0, none, none});
+            for (auto const s : first_slot_ [start])
+                add (s, 0, r, none);
+
+            while (not pending_.empty ()) {
+                auto d (std::move (pending_.back ()));
+                pending_.pop_back ();
+                process (d);
+            }
+            return std::move (f_);
+        }
+
+    private:
+        struct slot_info
+        {
+            std::size_t nt;
+            std::vector<symbol> const* alt;
+            std::size_t dot;
+        };
+
+        struct descriptor
+        {
+            std::size_t slot;
+            std::size_t gss;
+            R rng;
+            std::size_t sppf;
+        };
+
+        struct gss_node
+        {
+            std::size_t slot;
+            std::size_t pos;
+            std::size_t edges;
+            std::size_t pops;
+        };
+
+        struct gss_edge
+        {
+            std::size_t sppf;
+            std::size_t target;
+            std::size_t next;
+        };
+
+        struct gss_pop
+        {
+            std::size_t sppf;
+            R rng;
+            std::size_t next;
+        };
+
+        struct terminal_run
+        {
+            std::size_t sppf;
+            std::size_t end;
+        };
+
+        inline std::size_t offset (R const& r) const noexcept
+        {
+            return length_ - static_cast<std::size_t> (r.length ());
+        }
+
+        inline void compute_nullable (void)
+        {
+            nullable_.assign (g_.nonterminals (), false);
+            for (bool changed (true); changed; ) {
+                changed = false;
+                for (std::size_t x = 0; x < g_.nonterminals (); ++x) {
+                    if (nullable_ [x])
+                        continue;
+                    for (auto const& alt : g_.alternatives (x)) {
+                        bool all (true);
+                        for (auto const& s : alt)
+                            all = all && not s.terminal && nullable_ [s.id];
+                        if (all) {
+                            nullable_ [x] = true;
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        inline void add (std::size_t const slot, std::size_t const gss,
+                         R const& rng, std::size_t const sppf)
+        {
+            if (seen_.insert ({{slot, gss, offset (rng), sppf}}, 0).second)
+                pending_.push_back (descriptor {slot, gss, rng, sppf});
+        }
+
+        inline void process (descriptor const& d)
+        {
+            auto slot (d.slot);
+            auto w    (d.sppf);
+
+            // the range reached: that of the descriptor, until a terminal
+            // is parsed, and then the range after the last terminal.
+            auto end (none);
+            auto const rng = [&](void) -> R const&
+            {
+                return end == none ? d.rng : f_.ends [end];
+            };
+
+            auto const& alt (*slots_ [slot].alt);
+            if (alt.empty ()) {
+                auto const i (offset (d.rng));
+                auto const eps (sppf_node (kind::EPSILON, 0, i, i));
+                pop (d.gss, d.rng, node_p (slot, none, eps));
+                return;
+            }
+
+            for (auto dot (slots_ [slot].dot); dot < alt.size (); ++dot) {
+                auto const& s (alt [dot]);
+                if (s.terminal) {
+                    auto const t (terminal (s.id, rng ()));
+                    if (t.sppf == none)
+                        return;
+                    ++slot;
+                    w   = node_p (slot, w, t.sppf);
+                    end = t.end;
+                } else {
+                    auto const v (create (slot + 1, d.gss, rng (), w));
+                    for (auto const first : first_slot_ [s.id])
+                        add (first, v, rng (), none);
+                    return;
+                }
+            }
+            pop (d.gss, rng (), w);
+        }
+
+        inline std::size_t create (std::size_t const slot,
+                                   std::size_t const u,
+                                   R const& rng,
+                                   std::size_t const w)
+        {
+            auto const i (offset (rng));
+            auto const v (gss_index_.insert ({{slot, i}}, gss_.size ()));
+            if (v.second)
+                gss_.push_back (gss_node {slot, i, none, none});
+
+            if (not edge_index_.insert ({{v.first, w, u}}, 0).second)
+                return v.first;
+
+            edges_.push_back (gss_edge {w, u, gss_ [v.first].edges});
+            gss_ [v.first].edges = edges_.size () - 1;
+
+            for (auto p (gss_ [v.first].pops); p != none; p = pops_ [p].next)
+                add (slot, u, pops_ [p].rng, node_p (slot, w, pops_ [p].sppf));
+            return v.first;
+        }
+
+        inline void pop (std::size_t const u, R const& rng,
+                         std::size_t const z)
+        {
+            if (u == 0)
+                return;
+
+            if (not pop_index_.insert ({{u, z}}, 0).second)
+                return;
+
+            pops_.push_back (gss_pop {z, rng, gss_ [u].pops});
+            gss_ [u].pops = pops_.size () - 1;
+
+            auto const slot (gss_ [u].slot);
+            for (auto e (gss_ [u].edges); e != none; e = edges_ [e].next)
+                add (slot, edges_ [e].target, rng,
+                     node_p (slot, edges_ [e].sppf, z));
+        }
+
+        //
+        // the node for the alternative up to the given slot, from the node
+        // w before the last symbol and the node z of that symbol.
+        //
+        inline std::size_t node_p (std::size_t const slot,
+                                   std::size_t const w,
+                                   std::size_t const z)
+        {
+            auto const& info (slots_ [slot]);
+            bool const complete (info.dot == info.alt->size ());
+
+            if (info.dot == 1 && not complete) {
+                auto const& s ((*info.alt) [0]);
+                if (s.terminal || not nullable_ [s.id])
+                    return z;
+            }
+
+            auto const k (complete ? kind::SYMBOL : kind::INTERMEDIATE);
+            auto const label (complete ? info.nt : slot);
+            auto const pivot (f_.nodes [z].left);
+            auto const right (f_.nodes [z].right);
+            auto const left  (w == none ? pivot : f_.nodes [w].left);
+
+            auto const y (sppf_node (k, label, left, right));
+            if (not packed_index_.insert ({{y, slot, pivot}}, 0).second)
+                return y;
+
+            f_.packed.push_back (typename forest_type::packed_node
+                {slot, pivot, w, z, f_.nodes [y].packed});
+            f_.nodes [y].packed = f_.packed.size () - 1;
+            return y;
+        }
+
+        inline std::size_t sppf_node (kind const k, std::size_t const label,
+                                      std::size_t const left,
+                                      std::size_t const right)
+        {
+            auto const n (sppf_index_.insert
+                ({{static_cast<std::size_t> (k), label, left, right}},
+                 f_.nodes.size ()));
+            if (not n.second)
+                return n.first;
+
+            f_.nodes.push_back (typename forest_type::node
+                {k, label, left, right, none, 0, 0, 0});
+
+            if (k == kind::SYMBOL && label == start_ && left == 0)
+                f_.roots.push_back (n.first);
+            return n.first;
+        }
+
+        //
+        // run a terminal parser at a position, at most once.
+        //
+        inline terminal_run terminal (std::size_t const t, R const& rng)
+        {
+            using A = typename grammar_type::terminal_type::accumulator_type;
+
+            auto const i (offset (rng));
+            auto const found (terminals_.insert ({{t, i}}, runs_.size ()));
+            if (not found.second)
+                return runs_ [found.first];
+
+            terminal_run run {none, 0};
+            scratch<A> acc {rng};
+            auto const res (g_.terminal_parser (t).parse
+                (gsl::not_null_ptr<A> {acc.get ()}));
+
+            if (parse_success (*res)) {
+                auto const end (torange (*res));
+                auto const first (f_.values.size ());
+                auto const made (res->since (1));
+                for (auto it (made.first); it != made.second; ++it)
+                    if (it->first.is_value ())
+                        f_.values.push_back (it->first.to_value ());
+
+                f_.ends.push_back (end);
+                run.end  = f_.ends.size () - 1;
+                run.sppf = sppf_node (kind::TERMINAL, t, i, offset (end));
+                f_.nodes [run.sppf].first_value = first;
+                f_.nodes [run.sppf].last_value  = f_.values.size ();
+                f_.nodes [run.sppf].end         = run.end;
+            }
+            runs_.push_back (run);
+            return run;
+        }
+
+        grammar_type const& g_;
+        std::vector<slot_info> slots_;
+        std::vector<std::vector<std::size_t>> first_slot_;
+        std::vector<bool> nullable_;
+
+        std::size_t length_ = 0;
+        std::size_t start_  = 0;
+
+        std::vector<descriptor> pending_;
+        flat_index<4> seen_;
+
+        std::vector<gss_node> gss_;
+        std::vector<gss_edge> edges_;
+        std::vector<gss_pop> pops_;
+        flat_index<2> gss_index_;
+        flat_index<3> edge_index_;
+        flat_index<2> pop_index_;
+
+        forest_type f_;
+        flat_index<4> sppf_index_;
+        flat_index<3> packed_index_;
+        flat_index<2> terminals_;
+        std::vector<terminal_run> runs_;
+    };
+} // namespace detail
+
+    //
+    // Parse the input with every derivation of the start symbol.
+    //
+    template <typename It, typename V, typename R>
+    inline forest<V, R> parse (grammar<It, V, R> const& g,
+                               symbol const start,
+                               R const& r)
+    {
+        assert (not start.terminal && "start symbol must be a nonterminal");
+        return detail::engine<It, V, R> {g}.run (start.id, r);
+    }
+
+    //
+    // A core::parser which derives the longest prefix of its input that it
+    // can from the start symbol; on success it appends the values of the
+    // terminals of the first derivation, and otherwise fails, expecting the
+    // start symbol. (Which derivation is first is unspecified; for all of
+    // them, use gll::parse.)
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> to_parser (grammar<It, V, R> const& g,
+                                       symbol const start)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        assert (not start.terminal && "start symbol must be a nonterminal");
+
+        auto const shared (std::make_shared<grammar<It, V, R> const> (g));
+        description const described ("[(gll) " + g.name (start.id) + "]");
+        auto const expected (expect (described));
+
+        return parser<It, V, R>
+        {
+            .description = described,
+            .parse = [=](AccT const acc)
+            {
+                auto const f (parse (*shared, start, torange (*acc)));
+                auto const root (f.root ());
+
+                if (root == none) {
+                    acc->insert (failure {expected}, torange (*acc));
+                    return acc;
+                }
+
+                //
+                // each value is given the range after its terminal; if no
+                // value was parsed, the result is empty.
+                //
+                bool inserted (false);
+                R const* end (nullptr);
+                f.first_derivation (root,
+                    [&](std::size_t const first, std::size_t const last,
+                        R const& after)
+                    {
+                        for (auto v (first); v < last; ++v) {
+                            acc->insert (f.values [v], after);
+                            inserted = true;
+                        }
+                        end = &after;
+                    });
+
+                if (end == nullptr)
+                    acc->insert (empty<V>{}, torange (*acc));
+                else if (not inserted)
+                    acc->insert (empty<V>{}, *end);
+                else if (torange (*acc).length () != end->length ())
+                    acc->replace (*end);
+                return acc;
+            }
+        };
+    }
+} // namespace gll
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef GLL_HPP
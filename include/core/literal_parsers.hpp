@@ -0,0 +1,430 @@
+//
+// Parsers of literal strings of tokens, and of the longest of a set of
+// keywords
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef LITERAL_PARSERS_HPP
+#define LITERAL_PARSERS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "char_class.hpp"
+#include "first_set.hpp"
+#include "parser.hpp"
+#include "range.hpp"
+#include "result_type.hpp"
+#include "slice.hpp"
+
+#include "../gsl/not_null.hpp"
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // Whether literals and keywords match letters of either case; only the
+    // letters of ASCII are folded.
+    //
+    enum class letter_case : bool
+    {
+        SENSITIVE   = false,
+        INSENSITIVE = true
+    };
+
+namespace detail
+{
+    //
+    // the text of a literal (or of each keyword), in which T is not deduced
+    // but taken from the iterators, so that it may be given as a string
+    // literal (or a braced list of them).
+    //
+    template <typename T>
+    struct text_of
+    {
+        using type = std::basic_string<T>;
+        using list = std::vector<std::basic_string<T>>;
+    };
+
+    template <typename T>
+    inline T fold_case (T const& c) noexcept
+    {
+        return (c >= T ('A') && c <= T ('Z'))
+            ? T (c + (T ('a') - T ('A')))
+            : c;
+    }
+
+    template <typename T>
+    inline T other_case (T const& c) noexcept
+    {
+        if (c >= T ('A') && c <= T ('Z'))
+            return T (c + (T ('a') - T ('A')));
+        else if (c >= T ('a') && c <= T ('z'))
+            return T (c - (T ('a') - T ('A')));
+        else
+            return c;
+    }
+
+    //
+    // whether the tokens at the beginning of r are those of text, compared
+    // with memcmp where the range is over contiguous bytes and the case of
+    // letters matters, and one at a time otherwise.
+    //
+    template <typename R, typename T>
+    inline bool match_literal (R const& r, std::basic_string<T> const& text,
+                               letter_case const lc, std::true_type)
+    {
+        if (static_cast<std::size_t> (r.length ()) < text.size ())
+            return false;
+        else if (text.empty ())
+            return true;
+        else if (lc == letter_case::SENSITIVE)
+            return std::memcmp (&*r.begin (), text.data (), text.size ()) == 0;
+
+        auto const p (&*r.begin ());
+        for (std::size_t i (0); i < text.size (); ++i)
+            if (fold_case (p [i]) != fold_case (text [i]))
+                return false;
+        return true;
+    }
+
+    template <typename R, typename T>
+    inline bool match_literal (R const& r, std::basic_string<T> const& text,
+                               letter_case const lc, std::false_type)
+    {
+        auto it (r.begin ());
+        auto const e (r.end ());
+        for (auto const& t : text) {
+            if (it == e)
+                return false;
+            else if (lc == letter_case::SENSITIVE ? *it != t
+                                                  : fold_case (*it) !=
+                                                    fold_case (t))
+                return false;
+            ++it;
+        }
+        return true;
+    }
+
+    //
+    // The distinct tokens of a set of keywords, numbered from 0, so that a
+    // trie over them has a row of that many edges for each node; a token
+    // in no keyword is -1. Byte-sized tokens are numbered through a table
+    // of all 256, others by a search of the sorted tokens.
+    //
+    template <typename T, bool byte = is_byte_token<T>::value>
+    struct keyword_alphabet
+    {
+    public:
+        keyword_alphabet (std::vector<T> tokens)
+            : tokens_ (std::move (tokens))
+        {
+            std::sort (tokens_.begin (), tokens_.end ());
+            tokens_.erase (std::unique (tokens_.begin (), tokens_.end ()),
+                           tokens_.end ());
+        }
+
+        inline std::int32_t operator() (T const& t) const noexcept
+        {
+            auto const it
+                (std::lower_bound (tokens_.begin (), tokens_.end (), t));
+            return it != tokens_.end () && *it == t
+                ? static_cast<std::int32_t> (it - tokens_.begin ())
+                : -1;
+        }
+
+        inline std::size_t size (void) const noexcept
+        {
+            return tokens_.size ();
+        }
+
+    private:
+        std::vector<T> tokens_;
+    };
+
+    template <typename T>
+    struct keyword_alphabet<T, true>
+    {
+    public:
+        keyword_alphabet (std::vector<T> const& tokens)
+            : size_ (0)
+        {
+            index_.fill (-1);
+            for (auto const& t : tokens) {
+                auto& i (index_ [static_cast<unsigned char> (t)]);
+                if (i < 0)
+                    i = static_cast<std::int32_t> (size_++);
+            }
+        }
+
+        inline std::int32_t operator() (T const& t) const noexcept
+        {
+            return index_ [static_cast<unsigned char> (t)];
+        }
+
+        inline std::size_t size (void) const noexcept
+        {
+            return size_;
+        }
+
+    private:
+        std::array<std::int32_t, 256> index_;
+        std::size_t size_;
+    };
+
+    //
+    // A trie of keywords as a table of edges, one row of them for each
+    // node, indexed by the number of a token; -1 is no edge. A node where
+    // a keyword ends holds the (first) index of that keyword. Where case
+    // does not matter, tokens are folded before they are numbered.
+    //
+    template <typename T>
+    struct keyword_trie
+    {
+    public:
+        keyword_trie (std::vector<std::basic_string<T>> const& keywords,
+                      letter_case const lc)
+            : case_ (lc)
+            , alphabet_ (tokens (keywords, lc))
+            , width_ (std::max<std::size_t> (alphabet_.size (), 1))
+            , edges_ (width_, -1)
+            , accept_ (1, -1)
+        {
+            for (std::size_t k (0); k < keywords.size (); ++k) {
+                std::size_t node (0);
+                for (auto const& t : keywords [k]) {
+                    auto& edge
+                        (edges_ [node * width_ +
+                                 static_cast<std::size_t> (number (t))]);
+                    if (edge < 0) {
+                        edge = static_cast<std::int32_t> (accept_.size ());
+                        edges_.resize (edges_.size () + width_, -1);
+                        accept_.push_back (-1);
+                    }
+                    node = static_cast<std::size_t>
+                        (edges_ [node * width_ +
+                                 static_cast<std::size_t> (number (t))]);
+                }
+                if (accept_ [node] < 0)
+                    accept_ [node] = static_cast<std::int32_t> (k);
+            }
+        }
+
+        //
+        // the index of the longest keyword at the beginning of [it, e), and
+        // its length in n; -1 if there is none.
+        //
+        template <typename It>
+        inline std::int32_t match (It it, It const e, std::size_t& n) const
+        {
+            std::size_t node (0), depth (0);
+            std::int32_t found (accept_ [0]);
+            n = 0;
+
+            for (; it != e; ++it) {
+                auto const c (number (*it));
+                if (c < 0)
+                    break;
+
+                auto const next
+                    (edges_ [node * width_ + static_cast<std::size_t> (c)]);
+                if (next < 0)
+                    break;
+
+                node = static_cast<std::size_t> (next);
+                ++depth;
+                if (accept_ [node] >= 0) {
+                    found = accept_ [node];
+                    n = depth;
+                }
+            }
+            return found;
+        }
+
+        //
+        // the FIRST set of the keywords: the tokens which begin them (in
+        // either case, where case does not matter), and whether one is empty.
+        //
+        inline first_set first
+            (std::vector<std::basic_string<T>> const& keywords) const
+        {
+            auto s (first_set::none ());
+            for (auto const& k : keywords) {
+                if (k.empty ()) {
+                    s.nullable = true;
+                    continue;
+                }
+                s.set (static_cast<unsigned char> (k [0]));
+                if (case_ == letter_case::INSENSITIVE)
+                    s.set (static_cast<unsigned char> (other_case (k [0])));
+            }
+            return s;
+        }
+
+    private:
+        static inline std::vector<T> tokens
+            (std::vector<std::basic_string<T>> const& keywords,
+             letter_case const lc)
+        {
+            std::vector<T> ts;
+            for (auto const& k : keywords)
+                for (auto const& t : k)
+                    ts.push_back (lc == letter_case::INSENSITIVE
+                                  ? fold_case (t) : t);
+            return ts;
+        }
+
+        inline std::int32_t number (T const& t) const noexcept
+        {
+            return alphabet_
+                (case_ == letter_case::INSENSITIVE ? fold_case (t) : t);
+        }
+
+        letter_case case_;
+        keyword_alphabet<T> alphabet_;
+        std::size_t width_;
+        std::vector<std::int32_t> edges_;
+        std::vector<std::int32_t> accept_;
+    };
+
+    template <typename T>
+    inline std::string describe_literal (std::basic_string<T> const& text)
+    {
+        std::string s;
+        for (auto const& t : text)
+            s.push_back (static_cast<char> (t));
+        return s;
+    }
+} // namespace detail
+
+    //
+    // A literal string of tokens, matched as a whole: over contiguous bytes
+    // by a single memcmp, and otherwise in one loop, rather than by a
+    // sequence of token parsers making a result for each token. Its value
+    // is the text of the input it matched, as an S made from the iterators
+    // at its ends (as with take_while); by default a slice of the input,
+    // which a match makes without allocating (the text is known, after
+    // all).
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = core::slice<It>>
+    inline parser<It, S, R> literal
+        (typename detail::text_of<T>::type const& text,
+         letter_case const lc = letter_case::SENSITIVE)
+    {
+        using A = typename core::parser<It, S, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+        using token_type = typename std::iterator_traits<It>::value_type;
+
+        auto const dsc
+            ("[literal \"" + detail::describe_literal (text) + "\"" +
+             (lc == letter_case::INSENSITIVE ? " (any case)]" : "]"));
+        core::description const described (dsc);
+        auto const expected (core::expect (described));
+
+        auto first (text.empty () ? first_set::epsilon () : first_set::none ());
+        if (not text.empty () && is_byte_token<token_type>::value) {
+            first.set (static_cast<unsigned char> (text [0]));
+            if (lc == letter_case::INSENSITIVE)
+                first.set (static_cast<unsigned char>
+                    (detail::other_case (text [0])));
+        } else if (not text.empty ())
+            first = first_set::any ();
+
+        auto const n (static_cast<typename R::diff_type> (text.size ()));
+
+        return core::parser<It, S, R>
+        {
+            .description = described,
+            .parse =
+            [=](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                if (not detail::match_literal
+                        (rng, text, lc, is_contiguous_byte_iterator<It> {})) {
+                    acc->insert (core::failure {expected}, rng);
+                    return acc;
+                }
+
+                auto const next (rng.tail (n));
+                acc->insert
+                    (core::parse_result<S> {S (rng.begin (), next.begin ())},
+                     next);
+                return acc;
+            },
+            .lookahead = first
+        };
+    }
+
+    //
+    // The longest of a set of keywords, found by walking a trie of them
+    // built once, when the parser is; its value is the index of the
+    // keyword in the set, as a V (which may be an enumeration whose values
+    // follow the order of the keywords). Where one keyword begins another,
+    // the longer is taken, whatever their order. This replaces an option
+    // of a literal for each keyword, which tries them in turn.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename V = std::size_t>
+    inline parser<It, V, R> keywords
+        (typename detail::text_of<T>::list const& ks,
+         letter_case const lc = letter_case::SENSITIVE)
+    {
+        using A = typename core::parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+        using token_type = typename std::iterator_traits<It>::value_type;
+
+        std::string dsc ("[keyword of {");
+        for (std::size_t i (0); i < ks.size (); ++i)
+            dsc += (i == 0 ? "" : ", ") + detail::describe_literal (ks [i]);
+        dsc += lc == letter_case::INSENSITIVE ? "} (any case)]" : "}]";
+        core::description const described (dsc);
+        auto const expected (core::expect (described));
+
+        auto const trie
+            (std::make_shared<detail::keyword_trie<T> const> (ks, lc));
+        auto const first
+            (is_byte_token<token_type>::value ? trie->first (ks)
+                                              : first_set::any ());
+
+        return core::parser<It, V, R>
+        {
+            .description = described,
+            .parse =
+            [=](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                std::size_t n;
+                auto const k (trie->match (rng.begin (), rng.end (), n));
+                if (k < 0)
+                    acc->insert (core::failure {expected}, rng);
+                else
+                    acc->insert
+                        (core::parse_result<V> {static_cast<V> (k)},
+                         rng.tail (static_cast<typename R::diff_type> (n)));
+                return acc;
+            },
+            .lookahead = first
+        };
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef LITERAL_PARSERS_HPP
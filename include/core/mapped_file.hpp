@@ -0,0 +1,193 @@
+//
+// Files mapped into memory read-only, to be parsed in place
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // The bytes of a file, mapped read-only into memory and advised to be
+    // read in sequence; a range over its (pointer) iterators is contiguous,
+    // and is passed to core::parse as a string is, with no copy made:
+    //
+    //      mapped_file const file ("input.txt");
+    //      auto res (core::parse (p, file));
+    //
+    // where p is a parser over char const*. If populate, the pages are read
+    // in when the file is mapped (MAP_POPULATE, on Linux) rather than as
+    // the parse first touches them; if huge_pages, the kernel is asked to
+    // back the mapping with huge pages where it can (MADV_HUGEPAGE). Where
+    // files cannot be mapped (or mapping fails) the file is read into a
+    // buffer instead, and good () says whether it could be read at all.
+    //
+    class mapped_file
+    {
+    public:
+        using token_type     = char;
+        using size_type      = std::size_t;
+        using const_iterator = char const*;
+
+        mapped_file (mapped_file const&) = delete;
+        mapped_file & operator= (mapped_file const&) = delete;
+
+        explicit mapped_file (std::string const& path,
+                              bool const populate   = false,
+                              bool const huge_pages = false)
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            if (map (path, populate, huge_pages))
+                return;
+#else
+            (void) populate;
+            (void) huge_pages;
+#endif
+            read (path);
+        }
+
+        ~mapped_file (void)
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            if (mapped_)
+                (void) ::munmap (const_cast<char *> (data_), size_);
+#endif
+        }
+
+        inline bool good (void) const noexcept
+        {
+            return good_;
+        }
+
+        //
+        // whether the file is mapped, rather than read into a buffer.
+        //
+        inline bool mapped (void) const noexcept
+        {
+            return mapped_;
+        }
+
+        inline char const* data (void) const noexcept
+        {
+            return data_;
+        }
+
+        inline size_type size (void) const noexcept
+        {
+            return size_;
+        }
+
+        inline const_iterator begin (void) const noexcept
+        {
+            return data_;
+        }
+
+        inline const_iterator cbegin (void) const noexcept
+        {
+            return data_;
+        }
+
+        inline const_iterator end (void) const noexcept
+        {
+            return data_ + size_;
+        }
+
+        inline const_iterator cend (void) const noexcept
+        {
+            return data_ + size_;
+        }
+
+    private:
+#if defined(__unix__) || defined(__APPLE__)
+        inline bool map (std::string const& path,
+                         bool const populate,
+                         bool const huge_pages)
+        {
+            auto const fd (::open (path.c_str (), O_RDONLY));
+            if (fd < 0)
+                return false;
+
+            struct stat st;
+            if (::fstat (fd, &st) != 0 || not S_ISREG (st.st_mode)) {
+                (void) ::close (fd);
+                return false;
+            }
+
+            good_ = true;
+            size_ = static_cast<size_type> (st.st_size);
+            if (size_ == 0) {
+                (void) ::close (fd);
+                return true;
+            }
+
+            int flags (MAP_PRIVATE);
+#if defined(MAP_POPULATE)
+            if (populate)
+                flags |= MAP_POPULATE;
+#else
+            (void) populate;
+#endif
+            auto const p (::mmap (nullptr, size_, PROT_READ, flags, fd, 0));
+            (void) ::close (fd);
+            if (p == MAP_FAILED) {
+                good_ = false;
+                size_ = 0;
+                return false;
+            }
+
+            (void) ::madvise (p, size_, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+            if (huge_pages)
+                (void) ::madvise (p, size_, MADV_HUGEPAGE);
+#else
+            (void) huge_pages;
+#endif
+            data_   = static_cast<char const*> (p);
+            mapped_ = true;
+            return true;
+        }
+#endif
+
+        inline void read (std::string const& path)
+        {
+            std::ifstream file (path, std::ios::binary);
+            if (not file.good ())
+                return;
+
+            buffer_.assign ((std::istreambuf_iterator<char> (file)),
+                             std::istreambuf_iterator<char> ());
+            good_ = true;
+            data_ = buffer_.data ();
+            size_ = buffer_.size ();
+        }
+
+        char const* data_ = "";
+        size_type size_   = 0;
+        bool mapped_      = false;
+        bool good_        = false;
+        // the contents of a file which is not mapped.
+        std::vector<char> buffer_;
+    };
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef MAPPED_FILE_HPP
@@ -0,0 +1,353 @@
+//
+// Memoization of parse results by input position, for memo () and packrat
+// parsing
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef MEMO_HPP
+#define MEMO_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // SELECTIVE: only parsers wrapped in memo () are memoized.
+    // PACKRAT:   the result of every ordered choice (option) is memoized
+    //            as well, so that no alternative is ever parsed twice at
+    //            the same position.
+    //
+    enum class memo_mode : bool
+    {
+        SELECTIVE = false,
+        PACKRAT   = true
+    };
+
+namespace detail
+{
+    //
+    // each memoized parser is given an identifier, which selects its table
+    // within a memo_context; identifiers are never 0.
+    //
+    inline std::size_t next_memo_id (void) noexcept
+    {
+        static std::atomic<std::size_t> id {1};
+        return id.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    //
+    // an identifier drawn when it is first asked for, for parsers which
+    // are memoized only in some parses (as choices are, in packrat mode):
+    // those which never are use none up.
+    //
+    struct lazy_memo_id
+    {
+    public:
+        inline std::size_t get (void) const noexcept
+        {
+            auto id (id_.load (std::memory_order_acquire));
+            if (id == 0) {
+                auto const drawn (next_memo_id ());
+                id = id_.compare_exchange_strong (id, drawn) ? drawn : id;
+            }
+            return id;
+        }
+
+    private:
+        mutable std::atomic<std::size_t> id_ {0};
+    };
+} // namespace detail
+
+    //
+    // The results of one memoized parser over one input. Positions are
+    // keyed by the length of the input remaining, which indexes a flat
+    // array of slots counted from the start of the input (or from the last
+    // commit, see release), grown as the parse reaches further; a slot
+    // refers to the run of entries that the parser appended to the
+    // accumulator there, held contiguously in a single vector.
+    //
+    // E is the entry type of the accumulator, a (result, range) pair.
+    //
+    template <typename E>
+    struct memo_table
+    {
+    public:
+        struct slot
+        {
+            // index of the first entry
+            std::uint32_t first;
+            // 0 if the position has not been parsed; otherwise one more
+            // than the number of entries, with the top bit set if the
+            // parser moved the range of the entry it was called upon.
+            std::uint32_t count;
+        };
+
+        static constexpr std::uint32_t moved_bit = std::uint32_t (1) << 31;
+
+        //
+        // forget every result, and begin again at the start of an input
+        // of the given length; the storage is kept from one input to the
+        // next.
+        //
+        inline void reset (std::size_t const input_length)
+        {
+            top = input_length;
+            slots.clear ();
+            entries.clear ();
+            recorded.clear ();
+            kept = 0;
+        }
+
+        inline slot const* find (std::size_t const remaining) const noexcept
+        {
+            if (not covers (remaining) || top - remaining >= slots.size ())
+                return nullptr;
+
+            auto const& s (slots [top - remaining]);
+            return s.count == 0 ? nullptr : &s;
+        }
+
+        //
+        // whether results are kept at the given position; those before a
+        // commit are not, once released.
+        //
+        inline bool covers (std::size_t const remaining) const noexcept
+        {
+            return remaining <= top;
+        }
+
+        //
+        // whether more entries may be recorded; a table holds fewer than
+        // 2^31 of them, past which results are simply not memoized.
+        //
+        inline bool has_room (std::size_t const n) const noexcept
+        {
+            return entries.size () + n < moved_bit - 1;
+        }
+
+        inline void record (std::size_t const remaining,
+                            std::size_t const first,
+                            bool const moved)
+        {
+            assert (covers (remaining) &&
+                    "position outside of the table (memo_table::record)");
+
+            auto const i (top - remaining);
+            if (i >= slots.size ())
+                slots.resize (i + 1, slot {0, 0});
+
+            auto const n (entries.size () - first);
+            slots [i] = slot
+            {
+                static_cast<std::uint32_t> (first),
+                static_cast<std::uint32_t> (n + 1) | (moved ? moved_bit : 0)
+            };
+            recorded.push_back (remaining);
+        }
+
+        //
+        // forget the results at every position before the one with the
+        // given length remaining (i.e. with more remaining). Their slots
+        // are the front of the array, and are dropped at once (those
+        // after them are few: only the positions parsed ahead of the
+        // commit). Their entries are dropped once the table holds twice as
+        // many as it kept when it last did so, by copying those still
+        // referred to together, in the order they were recorded; so the
+        // work is proportional to the entries recorded.
+        //
+        inline void release (std::size_t const remaining)
+        {
+            if (remaining >= top)
+                return;
+
+            auto const dropped
+                (std::min<std::size_t> (top - remaining, slots.size ()));
+            slots.erase (slots.begin (),
+                         slots.begin () + static_cast<std::ptrdiff_t> (dropped));
+            top = remaining;
+
+            if (entries.size () < 2 * kept + 64)
+                return;
+
+            std::vector<E> live;
+            std::vector<std::size_t> positions;
+            for (auto const r : recorded) {
+                if (not covers (r))
+                    continue;
+
+                auto & s (slots [top - r]);
+                auto const first (s.first);
+                auto const last  (first + (s.count & ~moved_bit) - 1);
+                s.first = static_cast<std::uint32_t> (live.size ());
+                for (auto i (first); i < last; ++i)
+                    live.push_back (entries [i]);
+                positions.push_back (r);
+            }
+
+            entries.swap (live);
+            recorded.swap (positions);
+            kept = entries.size ();
+        }
+
+        inline std::size_t capacity (void) const noexcept
+        {
+            return slots.capacity () * sizeof (slot) +
+                entries.capacity () * sizeof (E) +
+                recorded.capacity () * sizeof (std::size_t);
+        }
+
+        // the length remaining at the position of the first slot.
+        std::size_t top = 0;
+        std::vector<slot> slots;
+        std::vector<E> entries;
+        // the positions recorded, in the order of their entries (as lengths
+        // remaining, which over a stream may be counted from far beyond 4
+        // GiB).
+        std::vector<std::size_t> recorded;
+        // the number of entries after the last release.
+        std::size_t kept = 0;
+    };
+
+    //
+    // The state shared by the memoized parsers of a parse: a table for each
+    // of them, over the positions of the input, made when the parser is
+    // first memoized in the context (so a context holds tables only for the
+    // parsers its parses memoized). A context is carried by the accumulator
+    // (and passed on to the scratch accumulators of lift and friends); it
+    // may be reused from parse to parse, in which case its tables are
+    // cleared, but their storage is kept.
+    //
+    struct memo_context
+    {
+    public:
+        memo_context (memo_context const&) = delete;
+        memo_context & operator= (memo_context const&) = delete;
+
+        explicit memo_context (memo_mode const mode = memo_mode::SELECTIVE)
+            : mode_ (mode)
+        {}
+
+        inline bool packrat (void) const noexcept
+        {
+            return mode_ == memo_mode::PACKRAT;
+        }
+
+        //
+        // begin a parse of an input of the given length; results from
+        // any previous parse are forgotten.
+        //
+        inline void begin (std::size_t const input_length) noexcept
+        {
+            length_ = input_length;
+            live_.clear ();
+            ++generation_;
+        }
+
+        inline std::size_t input_length (void) const noexcept
+        {
+            return length_;
+        }
+
+        template <typename E>
+        inline memo_table<E> & table (std::size_t const id)
+        {
+            holder_base * t;
+            if (id == last_id_) {
+                t = last_;
+            } else {
+                auto & slot (tables_ [id]);
+                if (not slot)
+                    slot.reset (new holder<E> {});
+                t = slot.get ();
+                last_id_ = id;
+                last_    = t;
+            }
+
+            auto & h (static_cast<holder<E> &> (*t));
+            if (h.generation != generation_) {
+                h.generation = generation_;
+                h.table.reset (length_);
+                live_.push_back (t);
+            }
+            return h.table;
+        }
+
+        //
+        // the parse has committed at the position with the given length of
+        // input remaining (see commit), and does not expect to return before
+        // it; the tables in use release their results there, so that they
+        // hold no more than the input still to parse, and what was parsed
+        // since the last commit. A position whose results were released is
+        // simply parsed again if the parse does return to it.
+        //
+        inline void cut (std::size_t const remaining)
+        {
+            for (auto const t : live_)
+                t->release (remaining);
+        }
+
+        //
+        // bytes held by the tables of the context.
+        //
+        inline std::size_t capacity (void) const noexcept
+        {
+            std::size_t total (tables_.bucket_count () * sizeof (void *) +
+                               live_.capacity () * sizeof (live_[0]));
+            for (auto const& t : tables_)
+                total += sizeof (t) + t.second->capacity ();
+            return total;
+        }
+
+    private:
+        struct holder_base
+        {
+            virtual ~holder_base (void) = default;
+            virtual std::size_t capacity (void) const noexcept = 0;
+            virtual void release (std::size_t const remaining) = 0;
+
+            std::size_t generation = 0;
+        };
+
+        template <typename E>
+        struct holder : public holder_base
+        {
+            inline std::size_t capacity (void) const noexcept override
+            {
+                return table.capacity ();
+            }
+
+            inline void release (std::size_t const remaining) override
+            {
+                table.release (remaining);
+            }
+
+            memo_table<E> table;
+        };
+
+        memo_mode const mode_;
+        std::size_t length_     = 0;
+        std::size_t generation_ = 1;
+        std::unordered_map<std::size_t, std::unique_ptr<holder_base>> tables_;
+        // the table last looked up, which is looked up again as often as
+        // not (by a memoized parser at successive positions).
+        std::size_t last_id_  = 0;
+        holder_base * last_   = nullptr;
+        // the tables in use in this parse.
+        std::vector<holder_base *> live_;
+    };
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef MEMO_HPP
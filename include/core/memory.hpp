@@ -0,0 +1,371 @@
+//
+// Memory resources for parsing: a type-erased allocator, and a monotonic
+// arena which is released in one shot when a parse is finished with
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // The interface through which parsing storage is obtained; a small
+    // counterpart of C++17's std::pmr::memory_resource.
+    //
+    struct memory_resource
+    {
+    public:
+        virtual ~memory_resource (void) = default;
+
+        virtual void * allocate (std::size_t const bytes,
+                                 std::size_t const align) = 0;
+        virtual void deallocate (void * const p,
+                                 std::size_t const bytes,
+                                 std::size_t const align) noexcept = 0;
+
+        inline bool is_equal (memory_resource const& other) const noexcept
+        {
+            return this == &other;
+        }
+
+        //
+        // a number which no other resource shares, and which changes
+        // whenever every allocation made from the resource is returned at
+        // once (as by monotonic_arena::release); what was drawn from the
+        // resource may be kept, and used again, while it is unchanged.
+        //
+        inline std::size_t generation (void) const noexcept
+        {
+            return generation_;
+        }
+
+        //
+        // whether deallocate does nothing, every allocation being returned
+        // at once when the generation changes (as for monotonic_arena); what
+        // is drawn from such a resource may be forgotten, not returned.
+        //
+        virtual bool monotonic (void) const noexcept
+        {
+            return false;
+        }
+
+    protected:
+        memory_resource (void) noexcept
+            : generation_ (next_generation ())
+        {}
+
+        memory_resource (memory_resource const&) noexcept
+            : generation_ (next_generation ())
+        {}
+
+        memory_resource & operator= (memory_resource const&) noexcept
+        {
+            return *this;
+        }
+
+        inline void renew (void) noexcept
+        {
+            generation_ = next_generation ();
+        }
+
+    private:
+        static inline std::size_t next_generation (void) noexcept
+        {
+            static std::atomic<std::size_t> next {1};
+            return next.fetch_add (1, std::memory_order_relaxed);
+        }
+
+        std::size_t generation_;
+    };
+
+    //
+    // The resource used when none is given: global operator new and delete.
+    //
+    struct new_delete_resource : public memory_resource
+    {
+    public:
+        inline void * allocate (std::size_t const bytes,
+                                std::size_t const) override
+        {
+            return ::operator new (bytes);
+        }
+
+        inline void deallocate (void * const p,
+                                std::size_t const,
+                                std::size_t const) noexcept override
+        {
+            ::operator delete (p);
+        }
+    };
+
+    inline memory_resource * default_resource (void) noexcept
+    {
+        static new_delete_resource r;
+        return &r;
+    }
+
+    //
+    // A monotonic arena: allocation is a pointer bump into the current
+    // block, deallocation does nothing, and release () returns every byte
+    // at once. Released blocks are kept (coalesced into one of the total
+    // size) so that an arena reused from parse to parse settles into
+    // making no calls to the system allocator at all.
+    //
+    // If huge_pages is set (and the platform is Linux), blocks are mapped
+    // directly and advised to be backed by transparent huge pages.
+    //
+    struct monotonic_arena : public memory_resource
+    {
+    public:
+        static constexpr std::size_t default_block_size = 64 * 1024;
+        static constexpr std::size_t huge_page_size     = 2 * 1024 * 1024;
+
+        monotonic_arena (monotonic_arena const&) = delete;
+        monotonic_arena & operator= (monotonic_arena const&) = delete;
+
+        explicit monotonic_arena
+            (std::size_t const initial_size = default_block_size,
+             bool const huge_pages = false)
+            : huge_pages_ (huge_pages)
+            , next_size_  (initial_size ? initial_size : default_block_size)
+        {
+            grow (0);
+        }
+
+        ~monotonic_arena (void) override
+        {
+            for (auto const& b : blocks_)
+                free_block (b);
+        }
+
+        inline void * allocate (std::size_t const bytes,
+                                std::size_t const align) override
+        {
+            auto p (bump (bytes, align));
+            if (p == nullptr) {
+                grow (bytes + align);
+                p = bump (bytes, align);
+                assert (p != nullptr && "arena block too small (allocate)");
+            }
+            allocated_ += bytes;
+            return p;
+        }
+
+        inline void deallocate (void * const,
+                                std::size_t const,
+                                std::size_t const) noexcept override
+        {}
+
+        inline bool monotonic (void) const noexcept override
+        {
+            return true;
+        }
+
+        //
+        // return every allocation made from the arena at once; anything
+        // which still refers into the arena must not be used afterwards.
+        //
+        inline void release (void)
+        {
+            if (blocks_.size () > 1) {
+                std::size_t total (0);
+                for (auto const& b : blocks_) {
+                    total += b.size;
+                    free_block (b);
+                }
+                blocks_.clear ();
+                next_size_ = total;
+                grow (0);
+            } else {
+                current_ = blocks_.back ().data;
+                end_     = current_ + blocks_.back ().size;
+            }
+            allocated_ = 0;
+            renew ();
+        }
+
+        //
+        // bytes handed out since construction or the last release.
+        //
+        inline std::size_t allocated (void) const noexcept
+        {
+            return allocated_;
+        }
+
+        //
+        // bytes obtained from the system and held by the arena.
+        //
+        inline std::size_t capacity (void) const noexcept
+        {
+            std::size_t total (0);
+            for (auto const& b : blocks_)
+                total += b.size;
+            return total;
+        }
+
+    private:
+        struct block
+        {
+            unsigned char * data;
+            std::size_t size;
+            bool mapped;
+        };
+
+        inline void * bump (std::size_t const bytes, std::size_t const align)
+        {
+            auto const addr (reinterpret_cast<std::uintptr_t> (current_));
+            auto const pad  ((align - addr % align) % align);
+
+            if (static_cast<std::size_t> (end_ - current_) < pad + bytes)
+                return nullptr;
+
+            auto p (current_ + pad);
+            current_ = p + bytes;
+            return p;
+        }
+
+        inline void grow (std::size_t const at_least)
+        {
+            auto size (next_size_);
+            while (size < at_least)
+                size *= 2;
+
+            blocks_.push_back (make_block (size));
+            current_   = blocks_.back ().data;
+            end_       = current_ + blocks_.back ().size;
+            next_size_ = size * 2;
+        }
+
+        inline block make_block (std::size_t size) const
+        {
+#if defined(__linux__)
+            if (huge_pages_) {
+                size = (size + huge_page_size - 1) / huge_page_size *
+                    huge_page_size;
+                auto p (::mmap (nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+                if (p != MAP_FAILED) {
+#if defined(MADV_HUGEPAGE)
+                    (void) ::madvise (p, size, MADV_HUGEPAGE);
+#endif
+                    return block
+                        {static_cast<unsigned char *> (p), size, true};
+                }
+            }
+#endif
+            return block
+            {
+                static_cast<unsigned char *> (::operator new (size)),
+                size,
+                false
+            };
+        }
+
+        static inline void free_block (block const& b) noexcept
+        {
+#if defined(__linux__)
+            if (b.mapped) {
+                (void) ::munmap (b.data, b.size);
+                return;
+            }
+#endif
+            ::operator delete (b.data);
+        }
+
+        bool const huge_pages_;
+        std::size_t next_size_;
+        std::size_t allocated_ = 0;
+        unsigned char * current_ = nullptr;
+        unsigned char * end_     = nullptr;
+        std::vector<block> blocks_;
+    };
+
+    //
+    // A standard allocator which draws from a memory_resource; it is what
+    // makes the accumulator's backing container allocator aware.
+    //
+    template <typename T>
+    struct resource_allocator
+    {
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = resource_allocator<U>;
+        };
+
+        template <typename U>
+        friend struct resource_allocator;
+
+        resource_allocator (void) noexcept
+            : resource_ (default_resource ())
+        {}
+
+        resource_allocator (memory_resource * const r) noexcept
+            : resource_ (r)
+        {
+            assert (r != nullptr && "null memory resource (allocator)");
+        }
+
+        template <typename U>
+        resource_allocator (resource_allocator<U> const& other) noexcept
+            : resource_ (other.resource_)
+        {}
+
+        inline T * allocate (std::size_t const n)
+        {
+            return static_cast<T *>
+                (resource_->allocate (n * sizeof (T), alignof (T)));
+        }
+
+        inline void deallocate (T * const p, std::size_t const n) noexcept
+        {
+            resource_->deallocate (p, n * sizeof (T), alignof (T));
+        }
+
+        inline memory_resource * resource (void) const noexcept
+        {
+            return resource_;
+        }
+
+        template <typename U>
+        inline bool operator== (resource_allocator<U> const& other)
+            const noexcept
+        {
+            return resource_->is_equal (*other.resource_);
+        }
+
+        template <typename U>
+        inline bool operator!= (resource_allocator<U> const& other)
+            const noexcept
+        {
+            return not (*this == other);
+        }
+
+    private:
+        memory_resource * resource_;
+    };
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef MEMORY_HPP
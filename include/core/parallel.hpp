@@ -0,0 +1,476 @@
+//
+// Parsing independent records of an input in parallel, on a pool of
+// threads
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "combinators.hpp"
+#include "memo.hpp"
+#include "parser.hpp"
+#include "range.hpp"
+#include "../gsl/not_null.hpp"
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // A fixed set of worker threads, to which a parallel parse hands its
+    // chunks. run (n, f) calls f (i) for each i in [0, n), on the workers
+    // and on the calling thread at once, and returns when every call has;
+    // the first exception thrown by one of them is thrown again from run.
+    // One run proceeds at a time; a run made from within another (from a
+    // worker) is carried out on its own thread alone.
+    //
+    class task_pool
+    {
+    public:
+        task_pool (task_pool const&) = delete;
+        task_pool & operator= (task_pool const&) = delete;
+
+        //
+        // a pool of the given number of threads, counting the thread which
+        // calls run; by default, one for each hardware thread.
+        //
+        explicit task_pool
+            (std::size_t const threads = std::thread::hardware_concurrency ())
+        {
+            for (std::size_t i (1); i < threads; ++i)
+                workers_.emplace_back ([this] (void) { work (); });
+        }
+
+        ~task_pool (void)
+        {
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all ();
+            for (auto & w : workers_)
+                w.join ();
+        }
+
+        inline std::size_t size (void) const noexcept
+        {
+            return workers_.size () + 1;
+        }
+
+        template <typename F>
+        inline void run (std::size_t const n, F const& f)
+        {
+            if (inside () || workers_.empty () || n < 2) {
+                for (std::size_t i (0); i < n; ++i)
+                    f (i);
+                return;
+            }
+
+            std::lock_guard<std::mutex> running (run_mutex_);
+            std::function<void (std::size_t)> const task (std::cref (f));
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                task_     = &task;
+                count_    = n;
+                next_     = 0;
+                finished_ = 0;
+                error_    = nullptr;
+                ++generation_;
+            }
+            wake_.notify_all ();
+
+            inside () = true;
+            drain ();
+            inside () = false;
+
+            std::unique_lock<std::mutex> lock (mutex_);
+            done_.wait (lock, [this] { return finished_ == workers_.size (); });
+            task_ = nullptr;
+            if (error_)
+                std::rethrow_exception (error_);
+        }
+
+    private:
+        //
+        // whether this thread is running a task of a pool.
+        //
+        static inline bool & inside (void) noexcept
+        {
+            static thread_local bool in_task = false;
+            return in_task;
+        }
+
+        inline void drain (void)
+        {
+            for (auto i (next_++); i < count_; i = next_++) {
+                try {
+                    (*task_) (i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock (mutex_);
+                    if (not error_)
+                        error_ = std::current_exception ();
+                }
+            }
+        }
+
+        inline void work (void)
+        {
+            inside () = true;
+            std::size_t seen (0);
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock (mutex_);
+                    wake_.wait (lock, [&] {
+                        return stop_ || generation_ != seen;
+                    });
+                    if (stop_)
+                        return;
+                    seen = generation_;
+                }
+
+                drain ();
+
+                std::lock_guard<std::mutex> lock (mutex_);
+                if (++finished_ == workers_.size ())
+                    done_.notify_one ();
+            }
+        }
+
+        std::vector<std::thread> workers_;
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        std::function<void (std::size_t)> const* task_ = nullptr;
+        std::size_t count_ = 0;
+        std::atomic<std::size_t> next_ {0};
+        std::size_t finished_   = 0;
+        std::size_t generation_ = 0;
+        std::exception_ptr error_;
+        bool stop_ = false;
+    };
+
+    //
+    // The pool used when none is given, of one thread for each hardware
+    // thread, made when first used.
+    //
+    inline task_pool & default_pool (void)
+    {
+        static task_pool pool;
+        return pool;
+    }
+
+namespace detail
+{
+    //
+    // the least input a chunk of a parallel parse is given.
+    //
+    constexpr std::size_t min_parallel_chunk = std::size_t (1) << 14;
+
+    //
+    // the records of p from the beginning of r, as by many (p), until one
+    // would begin at or past stop (or, if stop is the end of r, until one
+    // fails); an accumulator of a parse of its own. As with many, a record
+    // which fails leaves no failure, but what it had made before failing
+    // is kept; failed is whether one did (and so where many (p) stops).
+    //
+    template <typename It, typename V, typename R>
+    inline typename parser<It, V, R>::accumulator_type parse_records
+        (parser<It, V, R> const& p, R const& r, It const stop, bool & failed)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+
+        memo_context ctx;
+        A acc {empty<V>{}, r};
+        ctx.begin (r.length ());
+        acc.attach (&ctx);
+
+        failed = false;
+        while (stop == r.end () || torange (acc).begin () < stop) {
+            auto const mark (acc.mark ());
+            auto res (p.parse (gsl::not_null_ptr<A> {&acc}));
+            if (parse_fatal (*res))
+                break;
+            if (not parse_success (*res)) {
+                res->ignore_previous ();
+                failed = true;
+                break;
+            }
+            if (torange (*res).length () == mark.range.length ())
+                break;
+        }
+
+        acc.attach (nullptr);
+        return acc;
+    }
+} // namespace detail
+
+    //
+    // Zero or more successful parses of p, as by many (p), over an input
+    // split into chunks which are parsed on the given pool of threads. The
+    // chunks are split at the positions given by boundary, which is called
+    // as boundary (from, end) with iterators into the input, and gives the
+    // first position at or after from (or end) at which a record of p may
+    // begin. Each chunk is parsed as by many (p), from its split point
+    // until a record would begin at or past the next (a record may run on
+    // past it), and their results are appended to the accumulator in the
+    // order of the input. A chunk is kept only if the one before it ended
+    // at its split point, so that each kept chunk begins where a record of
+    // many (p) over the whole does, and the values are always those of
+    // many (p) over the whole.
+    //
+    // A chunk whose records end past its end (because the boundary split a
+    // record within it) hands the rest of the input to many (p), so such a
+    // boundary costs the rest of the input its parallelism, but not its
+    // results. A record which fails in a chunk, or a fatal failure, ends
+    // the parse there, as it would end many (p).
+    //
+    // The input must be over random access iterators. An input too short
+    // to give each thread a chunk of some size is parsed by many (p).
+    //
+    template <typename It, typename V, typename R, typename B>
+    inline parser<It, V, R> parallel_many (parser<It, V, R> const& p,
+                                           B && boundary,
+                                           task_pool & pool = default_pool ())
+    {
+        static_assert (is_random_access_iterator<It>::value,
+                       "parallel_many requires random access iterators");
+
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        auto const serial (many (p));
+        auto const pool_ (&pool);
+
+        return parser<It, V, R>
+        {
+            .description = "[(parallel_many) " + p.description + "]",
+            .parse = [=, split = std::decay_t<B> (boundary)]
+                (AccT const acc) -> AccT
+            {
+                auto const rng (torange (*acc));
+                auto const length
+                    (static_cast<std::size_t> (rng.length ()));
+                auto const chunks (std::min
+                    (4 * pool_->size (),
+                     length / detail::min_parallel_chunk));
+                if (chunks < 2)
+                    return serial.parse (acc);
+
+                std::vector<It> splits {rng.begin ()};
+                for (std::size_t i (1); i < chunks; ++i) {
+                    auto const at (std::max
+                        (splits.back (),
+                         rng.begin () + static_cast<typename R::diff_type>
+                            (length / chunks * i)));
+                    auto const s (split (at, rng.end ()));
+                    if (s != splits.back () && s != rng.end ())
+                        splits.push_back (s);
+                }
+                splits.push_back (rng.end ());
+
+                //
+                // whether a record failed in each chunk (as char, not bool,
+                // so that the chunks' threads write apart).
+                //
+                std::vector<std::unique_ptr<A>> parsed (splits.size () - 1);
+                std::vector<char> failed (parsed.size ());
+                pool_->run (parsed.size (), [&](std::size_t const i)
+                {
+                    bool stopped (false);
+                    parsed [i].reset (new A (detail::parse_records
+                        (p, R (splits [i], rng.end ()), splits [i + 1],
+                         stopped)));
+                    failed [i] = stopped;
+                });
+
+                for (std::size_t i (0); i < parsed.size (); ++i) {
+                    auto const& chunk (*parsed [i]);
+                    auto const entries (chunk.since (std::size_t (0)));
+                    auto const last (torange (chunk).begin ());
+
+                    //
+                    // the first entry is the one the chunk was parsed
+                    // from, whose range p may have moved on.
+                    //
+                    auto it (entries.first);
+                    if (it->second.begin () != splits [i])
+                        acc->replace (it->second);
+                    for (++it; it != entries.second; ++it)
+                        acc->insert (*it);
+
+                    if (parse_fatal (chunk) || failed [i])
+                        return acc;
+                    if (last != splits [i + 1])
+                        return serial.parse (acc);
+                }
+                return acc;
+            },
+            .lookahead = p.lookahead.or_empty ()
+        };
+    }
+
+    //
+    // Zero or more successful parses of p, as by many (p), over an input in
+    // which no split point can be found without knowing how the input
+    // before it was read (as in CSV, where a newline may be within a quoted
+    // field). The input is split into chunks at arbitrary positions, and
+    // each chunk is parsed from each of the given number of lexical states
+    // it might begin in: boundary (state, from, end) gives the first
+    // position at or after from at which a record may begin, supposing the
+    // input is read in that state at from (which is never the beginning of
+    // the input). For CSV, the states are outside and inside quotes.
+    //
+    // Every guess is parsed on the given pool at once, each until a record
+    // would begin past the end of its chunk. The chunks are then joined in
+    // order: the true state at the beginning of a chunk is known once the
+    // chunk before it is, as the position at which its records ended, and
+    // the guess which began there is kept; the others are thrown away. If
+    // no guess began there, the chunk is parsed again from there on the
+    // calling thread. Since each kept guess parsed from a true record
+    // boundary, the values are always those of many (p) over the whole; a
+    // boundary which guesses badly costs parallelism, not results.
+    //
+    // The input must be over random access iterators. An input too short
+    // to give each thread a chunk of some size is parsed by many (p).
+    //
+    template <typename It, typename V, typename R, typename B>
+    inline parser<It, V, R> speculative_many
+        (parser<It, V, R> const& p,
+         std::size_t const states,
+         B && boundary,
+         task_pool & pool = default_pool ())
+    {
+        static_assert (is_random_access_iterator<It>::value,
+                       "speculative_many requires random access iterators");
+        assert (states > 0 && "no lexical states given (speculative_many)");
+
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        struct guess
+        {
+            std::size_t chunk;
+            It begin;
+        };
+
+        auto const serial (many (p));
+        auto const pool_ (&pool);
+
+        return parser<It, V, R>
+        {
+            .description = "[(speculative_many) " + p.description + "]",
+            .parse = [=, scan = std::decay_t<B> (boundary)]
+                (AccT const acc) -> AccT
+            {
+                auto const rng (torange (*acc));
+                auto const length
+                    (static_cast<std::size_t> (rng.length ()));
+                auto const chunks (std::min
+                    (4 * pool_->size (),
+                     length / detail::min_parallel_chunk));
+                if (chunks < 2)
+                    return serial.parse (acc);
+
+                std::vector<It> splits {rng.begin ()};
+                for (std::size_t i (1); i < chunks; ++i)
+                    splits.push_back
+                        (rng.begin () + static_cast<typename R::diff_type>
+                            (length / chunks * i));
+                splits.push_back (rng.end ());
+
+                std::vector<guess> guesses {guess {0, rng.begin ()}};
+                for (std::size_t i (1); i < chunks; ++i) {
+                    auto const earlier (guesses.size ());
+                    for (std::size_t s (0); s < states; ++s) {
+                        auto const b (scan (s, splits [i], rng.end ()));
+                        auto const seen (std::find_if
+                            (guesses.begin () + earlier, guesses.end (),
+                             [&](guess const& g) { return g.begin == b; }));
+                        if (seen == guesses.end ())
+                            guesses.push_back (guess {i, b});
+                    }
+                }
+
+                //
+                // whether a record failed in each guess (as char, not bool,
+                // so that the guesses' threads write apart).
+                //
+                std::vector<std::unique_ptr<A>> parsed (guesses.size ());
+                std::vector<char> failed (guesses.size ());
+                pool_->run (parsed.size (), [&](std::size_t const i)
+                {
+                    auto const& g (guesses [i]);
+                    bool stopped (false);
+                    parsed [i].reset (new A (detail::parse_records
+                        (p, R (g.begin, rng.end ()), splits [g.chunk + 1],
+                         stopped)));
+                    failed [i] = stopped;
+                });
+
+                auto at (rng.begin ());
+                std::size_t next (0);
+                for (std::size_t i (0); i < chunks; ++i) {
+                    std::unique_ptr<A> redone;
+                    A const* chunk (nullptr);
+                    bool stopped (false);
+                    for (; next < guesses.size () &&
+                           guesses [next].chunk == i; ++next)
+                        if (guesses [next].begin == at) {
+                            chunk = parsed [next].get ();
+                            stopped = failed [next];
+                        }
+
+                    if (not chunk) {
+                        redone.reset (new A (detail::parse_records
+                            (p, R (at, rng.end ()), splits [i + 1],
+                             stopped)));
+                        chunk = redone.get ();
+                    }
+
+                    //
+                    // the first entry is the one the chunk was parsed
+                    // from, whose range p may have moved on.
+                    //
+                    auto const entries (chunk->since (std::size_t (0)));
+                    auto it (entries.first);
+                    if (it->second.begin () != at)
+                        acc->replace (it->second);
+                    for (++it; it != entries.second; ++it)
+                        acc->insert (*it);
+
+                    //
+                    // a record which failed ends the parse as it ends
+                    // many (p), even if what it made reaches the next chunk.
+                    //
+                    at = torange (*chunk).begin ();
+                    if (parse_fatal (*chunk) || stopped || at < splits [i + 1])
+                        return acc;
+                }
+                return acc;
+            },
+            .lookahead = p.lookahead.or_empty ()
+        };
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef PARALLEL_HPP
@@ -14,6 +14,10 @@
 #include <type_traits>
 
 #include "accumulator.hpp"
+#include "description.hpp"
+#include "first_set.hpp"
+#include "memo.hpp"
+#include "memory.hpp"
 #include "range.hpp"
 #include "result_type.hpp"
 
@@ -66,10 +70,15 @@ namespace core
         parser  (void) = delete;
         ~parser (void) = default;
 
-        std::string const description;
+        core::description const description;
         std::function
             <gsl::not_null_ptr<accumulator_type> const
             (gsl::not_null_ptr<accumulator_type> const)> const parse;
+        //
+        // what the parser may begin with (see first_set); unless given, a
+        // parser may begin with anything.
+        //
+        core::first_set const lookahead = core::first_set::any ();
     };
 
     template <typename T>
@@ -116,26 +125,81 @@ namespace core
 
     template <typename It, typename V, typename R>
     inline parser<It, V, R>
-    override_description (parser<It, V, R> const& p, std::string const& new_des)
+    override_description (parser<It, V, R> const& p, description const& new_des)
     {
         return parser<It, V, R>
         {
             .description = new_des,
-            .parse = p.parse
+            .parse = p.parse,
+            .lookahead = p.lookahead
         };
     }
 
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R>
+    override_lookahead (parser<It, V, R> const& p, first_set const& first)
+    {
+        return parser<It, V, R>
+        {
+            .description = p.description,
+            .parse = p.parse,
+            .lookahead = first
+        };
+    }
+
+    //
+    // Parse with the results drawn from the given memory resource (by
+    // default, global operator new and delete) and memoized in the given
+    // context; each parse begins the context afresh, but a context which
+    // is reused keeps the storage of its tables.
+    //
+    // With a monotonic_arena, the returned accumulator must not outlive the
+    // arena, and must be done with before the arena is released.
+    //
     template <typename It, typename V, typename R>
     inline typename parser<It, V, R>::accumulator_type parse
-        (parser<It,V,R> const& p, typename parser<It,V,R>::range_type const& r)
+        (parser<It,V,R> const& p,
+         typename parser<It,V,R>::range_type const& r,
+         memory_resource & mem,
+         memo_context & ctx)
     {
         using A = typename parser<It, V, R>::accumulator_type;
  
-        A acc {empty<V>{}, r};
+        A acc {empty<V>{}, r, &mem};
+        ctx.begin (r.length ());
+        acc.attach (&ctx);
         (void) p.parse (gsl::not_null_ptr<A> {&acc});
+        acc.attach (nullptr);
         return acc;
     }
 
+    template <typename It, typename V, typename R>
+    inline typename parser<It, V, R>::accumulator_type parse
+        (parser<It,V,R> const& p,
+         typename parser<It,V,R>::range_type const& r,
+         memo_context & ctx)
+    {
+        return parse (p, r, *default_resource (), ctx);
+    }
+
+    template <typename It, typename V, typename R>
+    inline typename parser<It, V, R>::accumulator_type parse
+        (parser<It,V,R> const& p,
+         typename parser<It,V,R>::range_type const& r,
+         memory_resource & mem)
+    {
+        memo_context ctx;
+        return parse (p, r, mem, ctx);
+    }
+
+    template <typename It, typename V, typename R>
+    inline typename parser<It, V, R>::accumulator_type parse
+        (parser<It,V,R> const& p, typename parser<It,V,R>::range_type const& r)
+    {
+        memo_context ctx;
+        return parse (p, r, *default_resource (), ctx);
+    }
+
     template <typename A>
     static inline bool parse_success (A const& acc)
     {
@@ -160,6 +224,23 @@ namespace core
         return not p.first.is_success ();
     }
 
+    //
+    // whether the parse failed past a commit (see commit); such a failure
+    // is not backtracked over by any choice or repetition.
+    //
+    template <typename A>
+    static inline bool parse_fatal (A const& acc)
+    {
+        auto const& r (acc.result ());
+        return r.is_failure () && r.to_failure ().is_fatal ();
+    }
+
+    template <typename V, typename R>
+    static inline bool parse_fatal (std::pair<parse_result<V>, R> const& p)
+    {
+        return p.first.is_failure () && p.first.to_failure ().is_fatal ();
+    }
+
     template <typename A>
     inline auto torange (A const& acc, std::size_t const n = 0)
         -> decltype(acc.range(n))
@@ -214,14 +295,13 @@ namespace core
 
     template <typename A>
     inline auto toresult_value (A const& acc, std::size_t const n = 0)
-        -> decltype(acc.result(n).to_value())
+        -> std::decay_t<decltype(acc.view(n).first.to_value())>
     {
-        return acc.result (n).to_value ();
+        return acc.view (n).first.to_value ();
     }
 
     template <typename V, typename R>
-    inline auto toresult_value (std::pair<parse_result<V>, R> const& p)
-        -> decltype(p.first.to_value())
+    inline V toresult_value (std::pair<parse_result<V>, R> const& p)
     {
         return p.first.to_value ();
     }
@@ -272,6 +352,29 @@ namespace core
     {
         return acc.values ();
     }
+
+namespace detail
+{
+    //
+    // Parse by f from where the accumulator stands, as a point to which the
+    // parse returns if f fails: the input from there is held while f parses
+    // (so that the commits within f do not drop it), and if f fails, but
+    // not fatally, what those commits released is taken back (see
+    // hold_input and rewind_input). Every combinator which goes on from
+    // its starting point after a failure parses through this.
+    //
+    template <typename P, typename F>
+    inline P const backtrack_point (P const acc, F const& f)
+    {
+        auto const rng (torange (*acc));
+        hold_input (rng);
+        auto res (f (acc));
+        if (not parse_success (*res) && not parse_fatal (*res))
+            rewind_input (rng);
+        unhold_input (rng);
+        return res;
+    }
+} // namespace detail
 } // namespace core
 } // namespace rpc
 
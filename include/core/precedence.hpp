@@ -0,0 +1,303 @@
+//
+// Operator precedence parsing, driven by a table of operators
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef PRECEDENCE_HPP
+#define PRECEDENCE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "accumulator.hpp"
+#include "combinators.hpp"
+#include "parser.hpp"
+#include "range.hpp"
+#include "result_type.hpp"
+
+#include "../gsl/not_null.hpp"
+
+//
+// An expression grammar written with the combinators has a rule for each
+// level of precedence, and parses every operand through all of them; with
+// chainl1 and chainr1 the levels are at least parsed in loops. A Pratt
+// parser (also known as precedence climbing) instead reads operands and
+// operators in turn, and decides from a table of their precedences and
+// associativities when to apply each operator: the whole expression is
+// parsed by a single loop, with the operands and the operators waiting
+// upon them held on explicit stacks, whatever its depth of nesting.
+//
+namespace rpc
+{
+namespace core
+{
+    //
+    // The operators of an expression over values of type V, recognized by
+    // parsers of value type T (e.g. a token or a literal); their values
+    // are not used. Higher precedences bind more tightly. Operators of
+    // each kind are tried in the order they were added, so that where one
+    // symbol begins another (as * begins **), the longer one must be added
+    // first.
+    //
+    template <typename It, typename V, typename T, typename R = range<It>>
+    struct operator_table
+    {
+    public:
+        using symbol_type = parser<It, T, R>;
+        using unary       = std::function<V (V)>;
+        using binary      = std::function<V (V, V)>;
+
+        struct entry
+        {
+            symbol_type symbol;
+            unsigned precedence;
+            bool right;
+            unary apply1;
+            binary apply2;
+        };
+
+        inline operator_table & prefix (symbol_type const& symbol,
+                                        unsigned const precedence,
+                                        unary f)
+        {
+            prefixes.push_back
+                (entry {symbol, precedence, true, std::move (f), nullptr});
+            return *this;
+        }
+
+        inline operator_table & postfix (symbol_type const& symbol,
+                                         unsigned const precedence,
+                                         unary f)
+        {
+            postfixes.push_back
+                (entry {symbol, precedence, false, std::move (f), nullptr});
+            return *this;
+        }
+
+        inline operator_table & infixl (symbol_type const& symbol,
+                                        unsigned const precedence,
+                                        binary f)
+        {
+            infixes.push_back
+                (entry {symbol, precedence, false, nullptr, std::move (f)});
+            return *this;
+        }
+
+        inline operator_table & infixr (symbol_type const& symbol,
+                                        unsigned const precedence,
+                                        binary f)
+        {
+            infixes.push_back
+                (entry {symbol, precedence, true, nullptr, std::move (f)});
+            return *this;
+        }
+
+        std::vector<entry> prefixes;
+        std::vector<entry> postfixes;
+        std::vector<entry> infixes;
+    };
+
+    //
+    // Parse an expression of operands p and the operators of the table:
+    // any number of prefix operators, an operand, and any number of postfix
+    // operators, then optionally an infix operator and another expression.
+    // Operators are applied as soon as the precedence of the next one shows
+    // that they may be, so that values are folded as they are parsed.
+    //
+    // As with chainl1, the expression ends before an infix operator which
+    // is not followed by an operand (that operator is backtracked over),
+    // and an operand which succeeds without making a value is not parsed;
+    // an operator or operand which fails fatally (see commit) fails it.
+    //
+    template <typename It, typename V, typename T, typename R>
+    inline parser<It, V, R> pratt (parser<It, V, R> const& p,
+                                   operator_table<It, V, T, R> const& table)
+    {
+        using A = typename parser<It, V, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        using SymA = typename parser<It, T, R>::accumulator_type;
+        using SymAccT = gsl::not_null_ptr<SymA>;
+
+        using entry = typename operator_table<It, V, T, R>::entry;
+
+        auto const ops (std::make_shared<operator_table<It, V, T, R> const>
+            (table));
+
+        return parser<It, V, R>
+        {
+            .description = "[(pratt) " + p.description + "]",
+            .parse = [=](AccT const acc)
+            {
+                scratch<SymA> sym {torange (*acc), acc->context (),
+                                   acc->resource ()};
+
+                //
+                // the result of the expression is placed at once, and its
+                // range moved on past each operator and operand parsed.
+                //
+                acc->insert (empty<V> {}, torange (*acc));
+
+                //
+                // set if an operator or operand failed fatally (see
+                // commit), whose failure is then on the accumulator.
+                //
+                bool fatal (false);
+
+                //
+                // the first operator of the given kind to be recognized;
+                // it is consumed if found.
+                //
+                auto const match = [&](std::vector<entry> const& es)
+                    -> entry const*
+                {
+                    for (auto const& e : es) {
+                        sym->reset (empty<T> {}, torange (*acc));
+                        auto res (detail::backtrack_point
+                            (SymAccT {sym.get ()}, e.symbol.parse));
+                        if (parse_success (*res)) {
+                            acc->replace (torange (*res));
+                            return &e;
+                        } else if (parse_fatal (*res)) {
+                            acc->insert (failure {toresult_failure (*res)},
+                                         torange (*res));
+                            fatal = true;
+                            return nullptr;
+                        }
+                    }
+                    return nullptr;
+                };
+
+                std::vector<V> xs;
+                std::vector<entry const*> pending;
+
+                //
+                // parse the prefix operators and the operand which follows
+                // them; the operand is parsed after the result, and its
+                // results are discarded once its value is taken.
+                //
+                auto const operand_parse = [&](void) -> bool
+                {
+                    while (auto const e = match (ops->prefixes))
+                        pending.push_back (e);
+                    if (fatal)
+                        return false;
+
+                    auto const tip (acc->mark ());
+                    auto res (p.parse (acc));
+                    fatal = parse_fatal (*res);
+                    auto const x (parse_success (*res)
+                        ? detail::last_value (*res, tip.size) : nullptr);
+                    if (x == nullptr)
+                        return false;
+
+                    xs.push_back (x->to_value ());
+                    R const next (torange (*res));
+                    res->ignore_previous (res->size () - tip.size);
+                    res->replace (next);
+                    return true;
+                };
+
+                auto const apply_top = [&](void)
+                {
+                    auto const e (pending.back ());
+                    pending.pop_back ();
+
+                    if (e->apply1) {
+                        xs.back () = e->apply1 (std::move (xs.back ()));
+                    } else {
+                        V y (std::move (xs.back ()));
+                        xs.pop_back ();
+                        xs.back () = e->apply2
+                            (std::move (xs.back ()), std::move (y));
+                    }
+                };
+
+                //
+                // without a first operand, the expression fails where the
+                // operand did (or is empty, if the operand made no value).
+                //
+                auto const start (acc->mark ());
+                if (not operand_parse ()) {
+                    if (fatal)
+                        return acc;
+
+                    R const end (torange (*acc));
+                    auto const r (toresult (*acc));
+                    acc->ignore_previous (acc->size () - start.size + 1);
+                    acc->insert (r.is_failure () ? r : empty<V> {}, end);
+                    return acc;
+                }
+
+                for (;;) {
+                    while (auto const e = match (ops->postfixes)) {
+                        while (not pending.empty () &&
+                               pending.back ()->precedence >= e->precedence)
+                            apply_top ();
+                        xs.back () = e->apply1 (std::move (xs.back ()));
+                    }
+                    if (fatal)
+                        return acc;
+
+                    //
+                    // the operator and the operand after it are parsed
+                    // from a point of backtracking (see backtrack_point).
+                    //
+                    R const before (torange (*acc));
+                    hold_input (before);
+                    auto const e (match (ops->infixes));
+                    if (fatal || e == nullptr) {
+                        unhold_input (before);
+                        if (fatal)
+                            return acc;
+                        break;
+                    }
+
+                    while (not pending.empty () &&
+                           (pending.back ()->precedence > e->precedence ||
+                            (pending.back ()->precedence == e->precedence &&
+                             not e->right)))
+                        apply_top ();
+
+                    //
+                    // without an operand after it, the operator (and any
+                    // prefix operators read since) is backtracked over.
+                    //
+                    auto const depth (pending.size ());
+                    pending.push_back (e);
+                    auto const tip (acc->mark ());
+                    if (not operand_parse ()) {
+                        if (fatal) {
+                            unhold_input (before);
+                            return acc;
+                        }
+
+                        acc->truncate (tip);
+                        acc->replace (before);
+                        rewind_input (before);
+                        unhold_input (before);
+                        pending.resize (depth);
+                        break;
+                    }
+                    unhold_input (before);
+                }
+
+                while (not pending.empty ())
+                    apply_top ();
+
+                acc->replace
+                    (typename A::result_type {std::move (xs.back ())});
+                return acc;
+            }
+        };
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef PRECEDENCE_HPP
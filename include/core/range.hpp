@@ -9,7 +9,10 @@
 #ifndef RANGE_HPP
 #define RANGE_HPP
 
+#include <algorithm>
 #include <iterator>
+#include <sstream>
+#include <string>
 #include <type_traits>
 
 #include "funktional/include/type_support/container_traits.hpp"
@@ -24,14 +27,20 @@ namespace core
     // to handle parse errors, simply inherit from this struct
     // and define the appropriate methods.
     //
-    template <typename It,
-        typename = std::enable_if_t
-            <std::is_base_of
-                <std::bidirectional_iterator_tag,
-                typename std::iterator_traits<It>::iterator_category>
-            ::value>>
+    // Ranges over random access iterators (std::string, std::vector, raw
+    // buffers, ...) are given by the specialization below. Otherwise, the
+    // remaining length is counted once when a range is made from its
+    // source, and is carried along from then on; no range operation ever
+    // walks the input beyond the tokens it consumes, so parsing is linear
+    // over forward iterators (std::forward_list, std::list, ...) as well.
+    //
+    template <typename It, typename = void>
     struct range
     {
+        static_assert (std::is_base_of
+                <std::forward_iterator_tag,
+                typename std::iterator_traits<It>::iterator_category>
+            ::value, "range requires forward iterators");
     public:
         using type        = range<It>;
         using iter_type   = It;
@@ -68,16 +77,14 @@ namespace core
         //
         template <typename C>
         range (C const& c) noexcept
-            : valid_  (not c.empty()),
-              begin_  (c.cbegin()),
+            : begin_  (c.cbegin()),
               end_    (c.cend()),
               length_ (std::distance(begin_, end_))
         {}
 
         template <typename I>
         range (I const& b, I const& e) noexcept
-            : valid_  (0 < std::distance(b, e)),
-              begin_  (b),
+            : begin_  (b),
               end_    (e),
               length_ (std::distance(begin_, end_))
         {}
@@ -101,21 +108,27 @@ namespace core
  
         inline type tail (diff_type const n = 1) const noexcept
         {
-            return length_ >= n ? range (std::next(begin_, n), end_)
-                                : range (end_, end_);
+            return length_ >= n
+                ? range (std::next(begin_, n), end_, length_ - n)
+                : range (end_, end_, 0);
         }
 
-        inline diff_type length (void) const noexcept
-            { return std::distance (begin_, end_); }
+        inline constexpr diff_type length (void) const noexcept
+            { return length_; }
 
-        inline diff_type distance (range<It> const& other)
-            { return std::distance (begin(), other.begin()); }
+        //
+        // the number of tokens from the beginning of this range to that of
+        // other, a later range into the same sequence.
+        //
+        inline constexpr diff_type distance (range<It> const& other)
+            const noexcept
+            { return length_ - other.length_; }
 
         inline constexpr bool empty (void) const noexcept
-            { return not (valid_ && length_ > 0); }
+            { return not (length_ > 0); }
 
         inline constexpr bool valid (void) const noexcept
-            { return valid_; }
+            { return length_ > 0; }
 
         inline std::basic_string<token_type> grab (void) const
         {
@@ -135,12 +148,157 @@ namespace core
         }
 
     private:
-        bool const valid_;
+        range (iter_type const& b, iter_type const& e, diff_type const len)
+            noexcept
+            : begin_  (b),
+              end_    (e),
+              length_ (len)
+        {}
+
         iter_type const begin_;
         iter_type const end_;
         diff_type const length_;
     };
 
+    template <typename It>
+    using is_random_access_iterator = std::is_base_of
+        <std::random_access_iterator_tag,
+         typename std::iterator_traits<It>::iterator_category>;
+
+    //
+    // A range over random access iterators is just its two ends: the
+    // length, head and tail are all computed in constant time, and (for
+    // iterators which are themselves trivially copyable, as pointers and
+    // the iterators of std::string and std::vector are) so is the range.
+    //
+    template <typename It>
+    struct range<It, std::enable_if_t<is_random_access_iterator<It>::value>>
+    {
+    public:
+        using type        = range<It>;
+        using iter_type   = It;
+        using iter_traits = std::iterator_traits<iter_type>;
+        using token_type  = typename iter_traits::value_type;
+        using diff_type   = typename iter_traits::difference_type;
+
+        struct is_range_type : public std::true_type {};
+
+        //
+        // no default construction for a range.
+        //
+        range (void) = delete;
+
+        //
+        // okay to copy construct ranges.
+        //
+        range (range &)               = default;
+        range (range const&)          = default;
+
+        //
+        // okay to move ranges.
+        //
+        range (range &&) = default;
+
+        //
+        // NOT okay to copy or move assign
+        //
+        range & operator= (range &&)     = delete;
+        range & operator= (range const&) = delete;
+
+        //
+        // valid constructors
+        //
+        template <typename C>
+        range (C const& c) noexcept
+            : begin_ (c.cbegin()),
+              end_   (c.cend())
+        {}
+
+        template <typename I>
+        range (I const& b, I const& e) noexcept
+            : begin_ (b),
+              end_   (e)
+        {}
+
+        inline constexpr iter_type begin (void) const noexcept
+            { return begin_; }
+
+        inline constexpr iter_type cbegin (void) const noexcept
+            { return begin_; }
+
+        inline constexpr iter_type end (void) const noexcept
+            { return end_; }
+
+        inline constexpr iter_type cend (void) const noexcept
+            { return end_; }
+
+        inline constexpr auto head (void)
+            const noexcept(noexcept(*std::declval<const iter_type>()))
+            -> decltype(*std::declval<const iter_type>())
+        { return *begin_; }
+ 
+        inline type tail (diff_type const n = 1) const noexcept
+        {
+            return length () >= n ? range (begin_ + n, end_)
+                                  : range (end_, end_);
+        }
+
+        inline constexpr diff_type length (void) const noexcept
+            { return end_ - begin_; }
+
+        inline constexpr diff_type distance (range<It> const& other)
+            const noexcept
+            { return other.begin () - begin_; }
+
+        inline constexpr bool empty (void) const noexcept
+            { return not (begin_ < end_); }
+
+        inline constexpr bool valid (void) const noexcept
+            { return begin_ < end_; }
+
+        inline std::basic_string<token_type> grab (void) const
+        {
+            return std::basic_string<token_type> (begin_, end_);
+        }
+
+        inline std::basic_string<token_type> grab
+            (std::size_t const n) const
+        {
+            auto const m (std::min (static_cast<std::size_t> (length ()), n));
+            return std::basic_string<token_type> (begin_, begin_ + m);
+        }
+
+    private:
+        iter_type const begin_;
+        iter_type const end_;
+    };
+
+    //
+    // Hooks for ranges over input which is read as it is parsed (see
+    // core/stream): release_input (r) tells the input that the parse will
+    // not return before r, as at a commit; hold_input (r) and
+    // unhold_input (r) bracket a parse which may return to r whatever it
+    // commits to, as an attempt (or any point of backtracking); and
+    // rewind_input (r), made within them, tells the input that the parse
+    // has returned to r after all, and so goes on from there. Ranges over
+    // resident sequences have nothing to do.
+    //
+    template <typename R>
+    inline void release_input (R const&) noexcept
+    {}
+
+    template <typename R>
+    inline void hold_input (R const&) noexcept
+    {}
+
+    template <typename R>
+    inline void unhold_input (R const&) noexcept
+    {}
+
+    template <typename R>
+    inline void rewind_input (R const&) noexcept
+    {}
+
     template <typename R>
     struct range_traits
     {
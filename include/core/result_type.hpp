@@ -9,10 +9,15 @@
 #ifndef RESULT_TYPE_HPP
 #define RESULT_TYPE_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_set>
 #include <utility>
 
-#include "funktional/include/algebraic.hpp"
 #include "funktional/include/type_support/container_traits.hpp"
 
 namespace rpc
@@ -29,25 +34,204 @@ namespace detail
     };
 } // namespace detail
     
+    //
+    // The messages of parsers are interned when the parsers are built: each
+    // distinct message is stored once, for the life of the program, and
+    // failures refer to it by pointer. Messages made while parsing are not
+    // interned (see failure_message).
+    //
+    inline std::string const* intern (std::string const& s)
+    {
+        static std::mutex m;
+        static std::unordered_set<std::string> table;
+
+        std::lock_guard<std::mutex> lock (m);
+        return &*table.insert (s).first;
+    }
+
+    //
+    // A message of a parser which is made once, when the parser is built
+    // (e.g. that a number is out of range).
+    //
+    struct fixed_text
+    {
+        std::string const* what;
+    };
+
+    inline fixed_text fixed_message (std::string const& s)
+    {
+        return fixed_text {intern (s)};
+    }
+
+namespace detail
+{
+    //
+    // the text of a message which is not interned: one made while parsing,
+    // or one rendered from a description only when it is asked for (see
+    // expect). It is shared by the failures made from it, and freed with
+    // the last of them.
+    //
+    struct message_source
+    {
+        message_source (void) noexcept : refs (1) {}
+        virtual ~message_source (void) = default;
+
+        virtual std::string text (void) const = 0;
+
+        std::atomic<std::size_t> refs;
+    };
+
+    struct shared_text : public message_source
+    {
+        explicit shared_text (std::string s) : text_ (std::move (s)) {}
+
+        inline std::string text (void) const override
+        {
+            return text_;
+        }
+
+    private:
+        std::string const text_;
+    };
+} // namespace detail
+
+    //
+    // A failure is a reference to a message, and whether that message is
+    // an expectation; making one from an expectation (or a fixed message)
+    // neither allocates nor locks. A fixed message is interned text, which
+    // a failure copies by pointer. Any other message has a source, counted
+    // by the failures which share it: the text of a failure made from a
+    // string while parsing, or the description of what a parser expected.
+    // The position of a failure is the range it is stored with in the
+    // accumulator. The text of the message is only rendered by message (),
+    // and so only when someone asks for it (e.g. through
+    // toresult_failure_message).
+    //
+    // A failure may also be fatal: one made by a parser under commit (),
+    // from which no choice or repetition recovers (see commit).
+    //
     struct failure_message
     {
-        failure_message (void) : msg("failure") {}
+        failure_message (void)
+            : what_ (default_message ()), source_ (nullptr)
+            , expected_ (false), fatal_ (false)
+        {}
+
+        failure_message (fixed_text const t) noexcept
+            : what_ (t.what), source_ (nullptr)
+            , expected_ (false), fatal_ (false)
+        {}
 
-        failure_message (std::string && s)     : msg(s) {}
-        failure_message (std::string const& s) : msg(s) {}
+        failure_message (std::string const& s)
+            : what_ (nullptr), source_ (new detail::shared_text {s})
+            , expected_ (false), fatal_ (false)
+        {}
 
-        failure_message (failure_message && f)      : msg(std::move(f.msg)) {}
-        failure_message (failure_message const&& f) : msg(std::move(f.msg)) {} 
+        failure_message (char const* s)
+            : failure_message (std::string (s))
+        {}
 
-        failure_message (failure_message & f)      : msg(f.msg) {}
-        failure_message (failure_message const& f) : msg(f.msg) {}
+        failure_message (failure_message const& other) noexcept
+            : what_ (other.what_), source_ (other.source_)
+            , expected_ (other.expected_), fatal_ (other.fatal_)
+        {
+            if (source_)
+                source_->refs.fetch_add (1, std::memory_order_relaxed);
+        }
 
-        std::string const msg;
+        failure_message & operator= (failure_message other) noexcept
+        {
+            std::swap (what_, other.what_);
+            std::swap (source_, other.source_);
+            expected_ = other.expected_;
+            fatal_    = other.fatal_;
+            return *this;
+        }
+
+        ~failure_message (void)
+        {
+            if (source_ &&
+                source_->refs.fetch_sub (1, std::memory_order_acq_rel) == 1)
+                delete source_;
+        }
+
+        //
+        // an expectation, of interned text or of a source (whose reference
+        // the expectation takes over); see expect.
+        //
+        static inline failure_message expected
+            (std::string const* const what) noexcept
+        {
+            return failure_message {what, nullptr};
+        }
+
+        static inline failure_message expected
+            (detail::message_source * const source) noexcept
+        {
+            return failure_message {nullptr, source};
+        }
+
+        inline std::string message (void) const
+        {
+            auto const text (source_ ? source_->text () : *what_);
+            return expected_ ? "expected " + text : text;
+        }
+
+        inline bool is_expectation (void) const noexcept
+        {
+            return expected_;
+        }
+
+        inline bool is_fatal (void) const noexcept
+        {
+            return fatal_;
+        }
+
+        //
+        // the same failure, made fatal (or recoverable again).
+        //
+        inline failure_message fatal (bool const f = true) const noexcept
+        {
+            failure_message copy (*this);
+            copy.fatal_ = f;
+            return copy;
+        }
+
+    private:
+        failure_message (std::string const* const what,
+                         detail::message_source * const source) noexcept
+            : what_ (what), source_ (source)
+            , expected_ (true), fatal_ (false)
+        {}
+
+        static inline std::string const* default_message (void)
+        {
+            static std::string const* const m (intern ("failure"));
+            return m;
+        }
+
+        std::string const* what_;
+        detail::message_source * source_;
+        bool expected_;
+        bool fatal_;
     };
 
-    std::ostream& operator<< (std::ostream& os, failure_message const& f)
+    //
+    // What a parser expected to find: a failure made once, when the parser
+    // is built, and copied into the accumulator whenever the parser fails.
+    // Here from text in hand; core/description makes them from the
+    // description of the parser, which is only rendered if asked for.
+    //
+    using expectation = failure_message;
+
+    inline expectation expect (std::string const& description)
     {
-        return (os << f.msg);
+        return failure_message::expected (intern (description));
+    }
+
+    inline std::ostream& operator<< (std::ostream& os, failure_message const& f)
+    {
+        return (os << f.message ());
     }
 
     //
@@ -131,32 +315,85 @@ namespace detail
     //
     template <typename V>
     struct parse_result
-        : public fnk::adt <value_result<V>, empty_result<V>, failure>
     {
-        //
-        // inherit adt constructors
-        //
     private:
-        using A = fnk::adt <value_result<V>, empty_result<V>, failure>;
-    public: 
-        using A::A;
+        using value_type = value_result<V>;
+    public:
+        parse_result (value_result<V> const& v)
+            : tag_ (detail::result_tags::PARSE_VALUE)
+        {
+            new (&value_) value_result<V> (v);
+        }
+
+        parse_result (value_result<V> && v)
+            : tag_ (detail::result_tags::PARSE_VALUE)
+        {
+            new (&value_) value_result<V> (std::move (v));
+        }
+
+        parse_result (empty_result<V> const&) noexcept
+            : tag_ (detail::result_tags::PARSE_EMPTY), none_ (nullptr)
+        {}
+
+        parse_result (failure const& f) noexcept
+            : tag_ (detail::result_tags::PARSE_FAILURE)
+        {
+            new (&failure_) failure (f);
+        }
+
+        parse_result (parse_result const& other)
+            : tag_ (other.tag_)
+        {
+            construct_from (other);
+        }
+
+        parse_result (parse_result && other)
+            : tag_ (other.tag_)
+        {
+            construct_from (std::move (other));
+        }
+
+        parse_result & operator= (parse_result const& other)
+        {
+            if (this != &other) {
+                destroy ();
+                tag_ = other.tag_;
+                construct_from (other);
+            }
+            return *this;
+        }
+
+        parse_result & operator= (parse_result && other)
+        {
+            if (this != &other) {
+                destroy ();
+                tag_ = other.tag_;
+                construct_from (std::move (other));
+            }
+            return *this;
+        }
+
+        ~parse_result (void)
+        {
+            destroy ();
+        }
 
         //
         // views and accesses
         //
         inline bool is_value (void) const noexcept
         {
-            return this->A::type_index() == detail::result_tags::PARSE_VALUE;
+            return tag_ == detail::result_tags::PARSE_VALUE;
         }
 
         inline bool is_empty (void) const noexcept
         {
-            return this->A::type_index() == detail::result_tags::PARSE_EMPTY;
+            return tag_ == detail::result_tags::PARSE_EMPTY;
         }
 
         inline bool is_failure (void) const noexcept
         {
-            return this->A::type_index() == detail::result_tags::PARSE_FAILURE;
+            return tag_ == detail::result_tags::PARSE_FAILURE;
         }
 
         inline bool is_success (void) const noexcept
@@ -164,25 +401,63 @@ namespace detail
             return not is_failure ();
         }
 
-        inline value_result<V> to_value (void) const noexcept
+        inline value_result<V> const& to_value (void) const noexcept
         {
-            return this->A::template value <value_result<V>>();
+            return value_;
         }
 
         inline empty_result<V> to_empty (void) const noexcept
         {
-            return this->A::template value <empty_result<V>>();
+            return empty_result<V> {};
         }
 
         inline failure to_failure (void) const noexcept
         {
-            return this->A::template value <failure>();
+            return failure_;
         }
 
-        inline std::string to_failure_message (void) const noexcept
+        inline std::string to_failure_message (void) const
         {
-            return this->A::template value <failure>().msg;
+            return failure_.message ();
         }
+
+    private:
+        inline void construct_from (parse_result const& other)
+        {
+            if (other.is_value ())
+                new (&value_) value_result<V> (other.value_);
+            else if (other.is_failure ())
+                new (&failure_) failure (other.failure_);
+        }
+
+        inline void construct_from (parse_result && other)
+        {
+            if (other.is_value ())
+                new (&value_) value_result<V> (std::move (other.value_));
+            else if (other.is_failure ())
+                new (&failure_) failure (other.failure_);
+        }
+
+        inline void destroy (void) noexcept
+        {
+            if (is_value ())
+                value_.~value_type ();
+            else if (is_failure ())
+                failure_.~failure ();
+        }
+
+        detail::result_tags tag_;
+        //
+        // an empty result writes none_, so that its storage is never left
+        // wholly uninitialized (which some compilers warn of when an empty
+        // result is destroyed, being unable to see that it holds no value).
+        //
+        union
+        {
+            value_result<V> value_;
+            failure failure_;
+            void const* none_;
+        };
     };
 } // namespace core
 } // namespace rpc
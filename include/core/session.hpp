@@ -0,0 +1,210 @@
+//
+// Parse sessions, fed their input in chunks as it arrives
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "parser.hpp"
+#include "range.hpp"
+#include "stream.hpp"
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // NEED_MORE: every record of the input fed so far has been parsed, but
+    //            the input ended in (or just before) the next one.
+    // DONE:      the input is finished, and every record of it was parsed.
+    // FAILED:    a record failed to parse; the session parses no further.
+    //
+    enum class session_status
+    {
+        NEED_MORE,
+        DONE,
+        FAILED
+    };
+
+    //
+    // A session parses an input fed to it in chunks, as by many (record)
+    // over the whole of it, parsing each record as soon as the input holds
+    // all of it:
+    //
+    //      parse_session<V> s (record);
+    //      while (s.feed (next_chunk ()) == session_status::NEED_MORE)
+    //          consume (s.take ());
+    //      if (s.finish () == session_status::FAILED) ...
+    //
+    // The input is held in a stream_buffer which is pushed each chunk. A
+    // record whose parse looks past the end of the input fed so far (as the
+    // buffer tells) may parse otherwise when more arrives, so its outcome is
+    // dropped, and it is parsed again from its beginning as soon as more
+    // input arrives, or the input is finished. Records which have been
+    // parsed are never parsed again, and their input is released, so
+    // the session holds the input of the record in progress (and the rest
+    // of the last chunk). The parsers of the record are over
+    // stream_iterator<T>; their values must not be slices of the input,
+    // which is released once they are taken.
+    //
+    template <typename V, typename T = char>
+    class parse_session
+    {
+    public:
+        using iter_type     = stream_iterator<T>;
+        using range_type    = range<iter_type>;
+        using parser_type   = parser<iter_type, V, range_type>;
+        using size_type     = std::size_t;
+        using position_type = typename stream_buffer<T>::position_type;
+
+        parse_session (parse_session const&) = delete;
+        parse_session & operator= (parse_session const&) = delete;
+
+        explicit parse_session
+            (parser_type const& record,
+             size_type const chunk = stream_buffer<T>::default_chunk)
+            : record_ (record)
+            , buffer_ (chunk)
+        {
+            buffer_.hold (0);
+        }
+
+        //
+        // feed the next n tokens of the input, and parse the records they
+        // complete.
+        //
+        inline session_status feed (T const* const p, size_type const n)
+        {
+            if (status_ == session_status::NEED_MORE) {
+                buffer_.push (p, n);
+                parse_records ();
+            }
+            return status_;
+        }
+
+        inline session_status feed (std::basic_string<T> const& s)
+        {
+            return feed (s.data (), s.size ());
+        }
+
+        //
+        // the input is finished: parse the records remaining.
+        //
+        inline session_status finish (void)
+        {
+            if (status_ == session_status::NEED_MORE) {
+                buffer_.close ();
+                parse_records ();
+            }
+            return status_;
+        }
+
+        inline session_status status (void) const noexcept
+        {
+            return status_;
+        }
+
+        //
+        // the values of the records parsed since they were last taken.
+        //
+        inline std::deque<V> take (void)
+        {
+            std::deque<V> vs;
+            vs.swap (values_);
+            return vs;
+        }
+
+        //
+        // the position in the input of the record in progress (or which
+        // failed).
+        //
+        inline position_type position (void) const noexcept
+        {
+            return position_;
+        }
+
+        inline std::string const& failure_message (void) const noexcept
+        {
+            return message_;
+        }
+
+        //
+        // bytes held by the input buffer.
+        //
+        inline size_type capacity (void) const noexcept
+        {
+            return buffer_.capacity ();
+        }
+
+    private:
+        inline void parse_records (void)
+        {
+            while (true) {
+                buffer_.clear_starved ();
+                if (not buffer_.reaches (position_)) {
+                    if (buffer_.closed ())
+                        status_ = session_status::DONE;
+                    return;
+                }
+
+                if (not buffer_.closed () && buffer_.available () == tried_)
+                    return;
+
+                range_type const r (iter_type (&buffer_, position_),
+                                    buffer_.cend ());
+                auto const res (core::parse (record_, r));
+                if (buffer_.starved ()) {
+                    tried_ = buffer_.available ();
+                    return;
+                }
+
+                if (not parse_success (res)) {
+                    message_ = toresult_failure_message (res);
+                    position_ = torange (res).position ();
+                    status_ = session_status::FAILED;
+                    return;
+                }
+
+                auto const next (torange (res).position ());
+                if (next == position_) {
+                    message_ = record_.description.str () +
+                        " succeeded without consuming input";
+                    status_ = session_status::FAILED;
+                    return;
+                }
+
+                for (auto & v : values (res))
+                    values_.push_back (std::move (v));
+
+                position_ = next;
+                tried_ = 0;
+                buffer_.unhold ();
+                buffer_.hold (position_);
+                buffer_.release (position_);
+            }
+        }
+
+        parser_type const record_;
+        stream_buffer<T> buffer_;
+        session_status status_ = session_status::NEED_MORE;
+        // the beginning of the record in progress.
+        position_type position_ = 0;
+        // the end of the input when the record in progress last starved
+        // (zero if it has not).
+        position_type tried_ = 0;
+        std::deque<V> values_;
+        std::string message_;
+    };
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef SESSION_HPP
@@ -0,0 +1,130 @@
+//
+// Slice type, a view of a run of tokens of the input
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef SLICE_HPP
+#define SLICE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace rpc
+{
+namespace core
+{
+    //
+    // A run of tokens of the input, held as the iterators at its ends, which
+    // a parser makes in the place of a string copied out of the input:
+    // take_while and its kin, literal, regexparser, recognize and the text
+    // parsers of basic make one when it is asked for as their value type.
+    // A slice is valid only as long as the input it views; str () (or an
+    // explicit conversion) makes an owning string where one must outlive it.
+    //
+    template <typename It>
+    class slice
+    {
+    public:
+        using iter_type   = It;
+        using token_type  = typename std::iterator_traits<It>::value_type;
+        using size_type   = std::size_t;
+        using string_type = std::basic_string<token_type>;
+
+        slice (void)
+            : begin_ ()
+            , end_ ()
+        {}
+
+        slice (It const begin, It const end)
+            : begin_ (begin)
+            , end_ (end)
+        {}
+
+        inline It begin (void) const noexcept
+        {
+            return begin_;
+        }
+
+        inline It end (void) const noexcept
+        {
+            return end_;
+        }
+
+        inline bool empty (void) const noexcept
+        {
+            return begin_ == end_;
+        }
+
+        inline size_type size (void) const
+        {
+            return static_cast<size_type> (std::distance (begin_, end_));
+        }
+
+        inline string_type str (void) const
+        {
+            return string_type (begin_, end_);
+        }
+
+        explicit inline operator string_type (void) const
+        {
+            return str ();
+        }
+
+        friend inline bool operator== (slice const& a, slice const& b)
+        {
+            return a.size () == b.size () &&
+                   std::equal (a.begin_, a.end_, b.begin_);
+        }
+
+        friend inline bool operator== (slice const& a, string_type const& s)
+        {
+            return a.size () == s.size () &&
+                   std::equal (a.begin_, a.end_, s.begin ());
+        }
+
+        friend inline bool operator== (string_type const& s, slice const& a)
+        {
+            return a == s;
+        }
+
+        template <typename U>
+        friend inline bool operator!= (slice const& a, U const& b)
+        {
+            return not (a == b);
+        }
+
+        friend inline std::basic_ostream<token_type>& operator<<
+            (std::basic_ostream<token_type>& os, slice const& s)
+        {
+            std::copy (s.begin_, s.end_,
+                       std::ostreambuf_iterator<token_type> (os));
+            return os;
+        }
+
+        //
+        // the same, for string streams, where it is a better match than the
+        // printer of containers which fnk::utility::to_string would pick.
+        //
+        friend inline std::basic_stringstream<token_type>& operator<<
+            (std::basic_stringstream<token_type>& os, slice const& s)
+        {
+            std::copy (s.begin_, s.end_,
+                       std::ostreambuf_iterator<token_type> (os));
+            return os;
+        }
+
+    private:
+        It begin_;
+        It end_;
+    };
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef SLICE_HPP
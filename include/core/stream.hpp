@@ -0,0 +1,602 @@
+//
+// Input read from a stream as it is parsed, through a buffer holding only
+// what the parse may still return to
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include "range.hpp"
+
+namespace rpc
+{
+namespace core
+{
+    template <typename T>
+    class stream_iterator;
+
+    //
+    // A buffer of the input read from a std::basic_istream (or, on POSIX
+    // systems, a file descriptor of bytes), filled a chunk at a time as the
+    // parse reaches past what it holds. Positions are counted from where the
+    // stream stood when the buffer was made. The buffer holds the input from
+    // the position of the last commit (see commit and release), or of the
+    // earliest point the parse may yet backtrack to (see hold), to the
+    // furthest read; what lies before it is dropped once it is at least half
+    // of what is held, when the buffer next needs room, and the buffer grows
+    // only when the input still held fills it. So a parse which commits as
+    // it goes holds about a chunk (and the longest stretch between commits)
+    // of the input at once, however long the input is.
+    //
+    // A buffer is parsed through the range over its iterators, which it
+    // converts to: core::parse (p, buffer) where p is a parser over
+    // stream_iterator<T>. The stream (or descriptor) is neither owned nor
+    // closed by the buffer, and must outlive it, as the buffer must outlive
+    // the ranges into it; slices of a stream are valid only until the input
+    // they view is released.
+    //
+    // A descriptor which fails to read (other than by an interrupted call,
+    // which is tried again) throws std::system_error from the read, and so
+    // from the parse which asked for the input; the buffer is not to be
+    // parsed again afterwards. The end of the input is only ever a read of
+    // nothing.
+    //
+    // A buffer made without a stream is pushed its input instead, as it
+    // arrives, and closed at its end (see core/session). A parse which looks
+    // past the input pushed so far finds it ended there, and the buffer is
+    // marked starved: the parse's outcome may change with more input.
+    //
+    template <typename T>
+    class stream_buffer
+    {
+    public:
+        using token_type    = T;
+        using size_type     = std::size_t;
+        using position_type = std::ptrdiff_t;
+        using iterator      = stream_iterator<T>;
+
+        static constexpr size_type default_chunk = size_type (1) << 16;
+
+        //
+        // the end of an input whose length is not known (as that of a pipe):
+        // the ranges into it then count their lengths from here, and only
+        // the differences of those lengths mean anything.
+        //
+        static constexpr position_type unbounded =
+            std::numeric_limits<position_type>::max ();
+
+        stream_buffer (stream_buffer const&) = delete;
+        stream_buffer & operator= (stream_buffer const&) = delete;
+
+        explicit stream_buffer (std::basic_istream<T> & is,
+                                size_type const chunk = default_chunk)
+            : read_ ([&is](T * const p, size_type const n)
+                {
+                    return static_cast<size_type>
+                        (is.rdbuf ()->sgetn
+                            (p, static_cast<std::streamsize> (n)));
+                })
+            , chunk_ (std::max<size_type> (chunk, 1))
+            , extent_ (length_of (is))
+        {}
+
+        explicit stream_buffer (size_type const chunk = default_chunk)
+            : read_ ()
+            , chunk_ (std::max<size_type> (chunk, 1))
+            , extent_ (unbounded)
+        {}
+
+#if defined(__unix__) || defined(__APPLE__)
+        explicit stream_buffer (int const fd,
+                                size_type const chunk = default_chunk)
+            : read_ ([fd](T * const p, size_type const n)
+                {
+                    static_assert (sizeof (T) == 1,
+                        "a file descriptor is read as bytes (stream_buffer)");
+
+                    ssize_t got;
+                    do {
+                        got = ::read (fd, p, n);
+                    } while (got < 0 && errno == EINTR);
+                    if (got < 0)
+                        throw std::system_error
+                            (errno, std::generic_category (),
+                             "stream_buffer: read");
+                    return size_type (got);
+                })
+            , chunk_ (std::max<size_type> (chunk, 1))
+            , extent_ (length_of (fd))
+        {}
+#endif
+
+        inline iterator cbegin (void) const noexcept
+        {
+            return iterator (this, 0);
+        }
+
+        inline iterator cend (void) const noexcept
+        {
+            return iterator (this, extent_);
+        }
+
+        //
+        // the length of the input, if it was known when the buffer was made
+        // (that of a regular file); otherwise unbounded.
+        //
+        inline position_type extent (void) const noexcept
+        {
+            return extent_;
+        }
+
+        //
+        // whether the input has a token at position p, reading up to it if
+        // need be.
+        //
+        inline bool reaches (position_type const p) const
+        {
+            return p < base_ + filled_ || (p < extent_ && fill (p));
+        }
+
+        //
+        // the least of p and the length of the input, reading up to p if
+        // need be.
+        //
+        inline position_type bound (position_type const p) const
+        {
+            auto const q (std::min (p, extent_));
+            return q <= base_ + filled_ || reaches (q - 1) ? q
+                                                           : base_ + filled_;
+        }
+
+        inline T at (position_type const p) const
+        {
+            assert (p >= base_ &&
+                    "input before the last commit (stream_buffer::at)");
+            auto const held (reaches (p));
+            assert (held && "input past its end (stream_buffer::at)");
+            (void) held;
+            return buffer_ [static_cast<size_type> (p - base_)];
+        }
+
+        //
+        // the parse will not return before position p: the input there may
+        // be dropped, unless it is held.
+        //
+        inline void release (position_type const p) const noexcept
+        {
+            floor_ = std::max (floor_, p);
+        }
+
+        //
+        // hold the input from position p on against release, until the
+        // matching unhold; holds are nested, as the parsers making them.
+        //
+        inline void hold (position_type const p) const
+        {
+            holds_.push_back (p);
+        }
+
+        inline void unhold (void) const noexcept
+        {
+            assert (not holds_.empty () && "unmatched unhold (stream_buffer)");
+            holds_.pop_back ();
+        }
+
+        //
+        // the parse has returned to position p, which it holds: the input
+        // released since (by commits which were backtracked over) is taken
+        // back, as the parse goes on from p.
+        //
+        inline void rewind (position_type const p) const noexcept
+        {
+            assert (not holds_.empty () && holds_.back () <= p &&
+                    "rewind to input not held (stream_buffer::rewind)");
+            floor_ = std::min (floor_, p);
+        }
+
+        //
+        // append n tokens to the input of a buffer made without a stream.
+        //
+        inline void push (T const* const p, size_type const n)
+        {
+            assert (not read_ && not ended_ &&
+                    "push to a stream, or past the end (stream_buffer)");
+            make_room (n);
+            std::copy (p, p + n, buffer_.begin () + filled_);
+            filled_ += static_cast<position_type> (n);
+        }
+
+        //
+        // end the input of a buffer made without a stream.
+        //
+        inline void close (void) noexcept
+        {
+            ended_ = true;
+        }
+
+        inline bool closed (void) const noexcept
+        {
+            return ended_;
+        }
+
+        //
+        // whether a parse has looked past the input pushed so far, since the
+        // buffer was last cleared of it.
+        //
+        inline bool starved (void) const noexcept
+        {
+            return starved_;
+        }
+
+        inline void clear_starved (void) const noexcept
+        {
+            starved_ = false;
+        }
+
+        //
+        // the position after the last token read (or pushed).
+        //
+        inline position_type available (void) const noexcept
+        {
+            return base_ + filled_;
+        }
+
+        //
+        // bytes held by the buffer.
+        //
+        inline size_type capacity (void) const noexcept
+        {
+            return buffer_.capacity () * sizeof (T) +
+                holds_.capacity () * sizeof (position_type);
+        }
+
+    private:
+        static inline position_type length_of (std::basic_istream<T> & is)
+        {
+            auto const here (is.tellg ());
+            if (here == decltype (here) (-1))
+                return unbounded;
+
+            is.seekg (0, std::ios::end);
+            auto const there (is.tellg ());
+            is.clear ();
+            is.seekg (here);
+            return there == decltype (there) (-1) || there < here
+                ? unbounded
+                : static_cast<position_type> (there - here);
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        static inline position_type length_of (int const fd)
+        {
+            struct stat st;
+            if (::fstat (fd, &st) != 0 || not S_ISREG (st.st_mode))
+                return unbounded;
+
+            auto const here (::lseek (fd, 0, SEEK_CUR));
+            return here < 0 || here > st.st_size
+                ? unbounded
+                : static_cast<position_type> (st.st_size - here);
+        }
+#endif
+
+        //
+        // make room for n more tokens: the input released is dropped if it
+        // is at least half of what is held (or the buffer is too full), and
+        // the buffer grows if it is still too full. The first hold (the
+        // outermost) is the earliest.
+        //
+        inline void make_room (size_type const n) const
+        {
+            auto const floor
+                (holds_.empty () ? floor_ : std::min (floor_, holds_.front ()));
+            auto const dead (std::min<position_type>
+                (std::max<position_type> (floor - base_, 0), filled_));
+            auto const full (size_type (filled_) + n > buffer_.size ());
+
+            if (dead > 0 && (2 * dead >= filled_ || full)) {
+                std::copy (buffer_.begin () + dead,
+                           buffer_.begin () + filled_,
+                           buffer_.begin ());
+                base_   += dead;
+                filled_ -= dead;
+            }
+
+            auto size (std::max (chunk_, buffer_.size ()));
+            while (size_type (filled_) + n > size)
+                size *= 2;
+            if (size != buffer_.size ())
+                buffer_.resize (size);
+        }
+
+        //
+        // read until position p is held or the input ends; whether it is.
+        // Without a stream, there is nothing more to read until more is
+        // pushed.
+        //
+        inline bool fill (position_type const p) const
+        {
+            if (not read_) {
+                starved_ = starved_ || not ended_;
+                return false;
+            }
+
+            while (not ended_ && p >= base_ + filled_) {
+                make_room (1);
+                auto const got
+                    (read_ (buffer_.data () + filled_,
+                            buffer_.size () - size_type (filled_)));
+                if (got == 0)
+                    ended_ = true;
+                filled_ += static_cast<position_type> (got);
+            }
+            return p < base_ + filled_;
+        }
+
+        std::function<size_type (T *, size_type)> const read_;
+        size_type const chunk_;
+        position_type const extent_;
+
+        // the input from position base_ on, of which filled_ tokens are read.
+        mutable std::vector<T> buffer_;
+        mutable position_type base_   = 0;
+        mutable position_type filled_ = 0;
+        mutable position_type floor_  = 0;
+        mutable std::vector<position_type> holds_;
+        mutable bool ended_   = false;
+        mutable bool starved_ = false;
+    };
+
+    template <typename T>
+    constexpr typename stream_buffer<T>::size_type
+        stream_buffer<T>::default_chunk;
+
+    template <typename T>
+    constexpr typename stream_buffer<T>::position_type
+        stream_buffer<T>::unbounded;
+
+    //
+    // A position in a stream_buffer. Dereferencing it reads the input up to
+    // it if need be, and gives the token by value, as the buffer may move
+    // it when next filled. An iterator compares equal to the end of the
+    // buffer once the input ends before it.
+    //
+    template <typename T>
+    class stream_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T const*;
+        using reference         = T;
+
+        stream_iterator (void) noexcept
+            : buffer_ (nullptr)
+            , position_ (0)
+        {}
+
+        stream_iterator (stream_buffer<T> const* const buffer,
+                         difference_type const position) noexcept
+            : buffer_ (buffer)
+            , position_ (position)
+        {}
+
+        inline T operator* (void) const
+        {
+            return buffer_->at (position_);
+        }
+
+        inline stream_iterator & operator++ (void) noexcept
+        {
+            ++position_;
+            return *this;
+        }
+
+        inline stream_iterator operator++ (int) noexcept
+        {
+            auto const it (*this);
+            ++position_;
+            return it;
+        }
+
+        inline stream_buffer<T> const* buffer (void) const noexcept
+        {
+            return buffer_;
+        }
+
+        inline difference_type position (void) const noexcept
+        {
+            return position_;
+        }
+
+        friend inline bool operator== (stream_iterator const& a,
+                                       stream_iterator const& b)
+        {
+            return a.position_ == b.position_ ||
+                (a.buffer_ != nullptr &&
+                 not a.buffer_->reaches (std::min (a.position_, b.position_)));
+        }
+
+        friend inline bool operator!= (stream_iterator const& a,
+                                       stream_iterator const& b)
+        {
+            return not (a == b);
+        }
+
+    private:
+        stream_buffer<T> const* buffer_;
+        difference_type position_;
+    };
+
+    //
+    // A range over a stream_buffer. Its length is counted to the end of the
+    // buffer, which is the end of the input where that is known and
+    // stream_buffer::unbounded otherwise; only empty () says whether any
+    // input remains. Its head and tail read the input as far as they look.
+    //
+    template <typename T>
+    struct range<stream_iterator<T>, void>
+    {
+    public:
+        using type        = range<stream_iterator<T>>;
+        using iter_type   = stream_iterator<T>;
+        using iter_traits = std::iterator_traits<iter_type>;
+        using token_type  = typename iter_traits::value_type;
+        using diff_type   = typename iter_traits::difference_type;
+
+        struct is_range_type : public std::true_type {};
+
+        //
+        // no default construction for a range.
+        //
+        range (void) = delete;
+
+        //
+        // okay to copy construct ranges.
+        //
+        range (range &)               = default;
+        range (range const&)          = default;
+
+        //
+        // okay to move ranges.
+        //
+        range (range &&) = default;
+
+        //
+        // NOT okay to copy or move assign
+        //
+        range & operator= (range &&)     = delete;
+        range & operator= (range const&) = delete;
+
+        //
+        // valid constructors
+        //
+        template <typename C>
+        range (C const& c) noexcept
+            : begin_ (c.cbegin()),
+              end_   (c.cend())
+        {}
+
+        template <typename I>
+        range (I const& b, I const& e) noexcept
+            : begin_ (b),
+              end_   (e)
+        {}
+
+        inline iter_type begin (void) const noexcept
+            { return begin_; }
+
+        inline iter_type cbegin (void) const noexcept
+            { return begin_; }
+
+        inline iter_type end (void) const noexcept
+            { return end_; }
+
+        inline iter_type cend (void) const noexcept
+            { return end_; }
+
+        inline token_type head (void) const
+            { return *begin_; }
+
+        inline type tail (diff_type const n = 1) const
+        {
+            auto const p (begin_.buffer ()->bound
+                (begin_.position () + std::min (n, length ())));
+            return range (iter_type (begin_.buffer (), p), end_);
+        }
+
+        inline diff_type length (void) const noexcept
+            { return end_.position () - begin_.position (); }
+
+        inline diff_type distance (range const& other) const noexcept
+            { return other.begin_.position () - begin_.position (); }
+
+        inline bool empty (void) const
+        {
+            return not (begin_.position () < end_.position () &&
+                        begin_.buffer ()->reaches (begin_.position ()));
+        }
+
+        inline bool valid (void) const
+            { return not empty (); }
+
+        inline std::basic_string<token_type> grab (void) const
+        {
+            std::basic_stringstream<token_type> st;
+            for (auto it = begin_; it != end_; ++it)
+                st << *it;
+            return st.str ();
+        }
+
+        inline std::basic_string<token_type> grab
+            (std::size_t n) const
+        {
+            std::basic_stringstream<token_type> st;
+            for (auto it = begin_; it != end_ && n-- != 0; ++it)
+                st << *it;
+            return st.str ();
+        }
+
+        //
+        // the position of the range in the input.
+        //
+        inline diff_type position (void) const noexcept
+            { return begin_.position (); }
+
+    private:
+        iter_type const begin_;
+        iter_type const end_;
+    };
+
+    template <typename T>
+    inline void release_input (range<stream_iterator<T>> const& r) noexcept
+    {
+        r.begin ().buffer ()->release (r.position ());
+    }
+
+    template <typename T>
+    inline void hold_input (range<stream_iterator<T>> const& r)
+    {
+        r.begin ().buffer ()->hold (r.position ());
+    }
+
+    template <typename T>
+    inline void unhold_input (range<stream_iterator<T>> const& r) noexcept
+    {
+        r.begin ().buffer ()->unhold ();
+    }
+
+    template <typename T>
+    inline void rewind_input (range<stream_iterator<T>> const& r) noexcept
+    {
+        r.begin ().buffer ()->rewind (r.position ());
+    }
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef STREAM_HPP
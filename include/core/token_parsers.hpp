@@ -9,11 +9,15 @@
 #ifndef TOKEN_PARSERS_HPP
 #define TOKEN_PARSERS_HPP
 
+#include <cstddef>
 #include <type_traits>
 #include <iterator>
 #include <list>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "core/char_class.hpp"
 #include "core/range.hpp"
 #include "core/parser.hpp"
 
@@ -26,39 +30,99 @@ namespace rpc
 {
 namespace core
 {
-    template <typename It, typename V, typename R = core::range<It>>
-    parser<It, V, R> const fail = core::parser<It, V, R>
+    //
+    // A predicate which depends on nothing but its argument (made so by
+    // pure), and so may be asked of every byte once, when a parser of it
+    // is built: satisfy compiles it into a table of 256 bits, and satisfy,
+    // take_while, skip_while and the rest dispatch on the bytes it accepts.
+    // Any other predicate is called on each token as it is parsed, and its
+    // parser may begin with any token.
+    //
+    template <typename Pr>
+    struct pure_predicate
     {
-        .description = "[failure]",
-        .parse = []
-            (gsl::not_null_ptr
-                <typename core::parser<It, V, R>::accumulator_type> const acc)
+        using argument_type = typename fnk::type_support::function_traits
+            <Pr>::template argument<0>::type;
+
+        inline bool operator() (argument_type t) const
         {
-            auto rng (core::torange (*acc));
-            acc->insert
-                (core::parse_result<V> {core::failure {"[failure]"}},
-                 rng);
-            return acc;
+            return bool (fnk::eval (predicate, t));
         }
+
+        Pr predicate;
     };
 
+    template <typename Pr>
+    inline pure_predicate<std::decay_t<Pr>> pure (Pr && predicate)
+    {
+        return pure_predicate<std::decay_t<Pr>> {std::forward<Pr> (predicate)};
+    }
+
+    template <typename Pr>
+    struct is_pure_predicate : public std::false_type {};
+
+    template <typename Pr>
+    struct is_pure_predicate<pure_predicate<Pr>> : public std::true_type {};
+
+namespace detail
+{
+    //
+    // `fail` and `pass` are built by functions so that combinators which need
+    // them while other parser variable templates are being initialized do not
+    // depend on the (unordered) initialization of variable templates.
+    //
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> make_fail
+        (core::description const& dsc,
+         core::failure const failed = core::fixed_message ("[failure]"))
+    {
+        return core::parser<It, V, R>
+        {
+            .description = dsc,
+            .parse = [failed]
+                (gsl::not_null_ptr
+                    <typename core::parser<It, V, R>::accumulator_type> const acc)
+            {
+                auto rng (core::torange (*acc));
+                acc->insert (core::parse_result<V> {failed}, rng);
+                return acc;
+            },
+            .lookahead = core::first_set::none ()
+        };
+    }
+
+    template <typename It, typename V, typename R>
+    inline parser<It, V, R> make_pass (void)
+    {
+        return core::parser<It, V, R>
+        {
+            .description = "[pass]",
+            .parse = []
+                (gsl::not_null_ptr
+                    <typename core::parser<It, V, R>::accumulator_type> const acc)
+            {
+                return acc;
+            },
+            .lookahead = core::first_set::epsilon ()
+        };
+    }
+} // namespace detail
+
     template <typename It, typename V, typename R = core::range<It>>
-    inline parser<It, V, R> failwith (std::string const& description)
+    parser<It, V, R> const fail = detail::make_fail<It, V, R> ("[failure]");
+
+    //
+    // A parser which always fails, expecting what dsc describes (as some
+    // does where its parser fails the first time).
+    //
+    template <typename It, typename V, typename R = core::range<It>>
+    inline parser<It, V, R> failwith (core::description const& dsc)
     {
-        return core::override_description (fail<It, V, R>, description);
+        return detail::make_fail<It, V, R> (dsc, core::failure {expect (dsc)});
     }
     
     template <typename It, typename V, typename R = core::range<It>>
-    parser<It, V, R> const pass = core::parser<It, V, R>
-    {
-        .description = "[pass]",
-        .parse = []
-            (gsl::not_null_ptr
-                <typename core::parser<It, V, R>::accumulator_type> const acc)
-        {
-            return acc;
-        }
-    };
+    parser<It, V, R> const pass = detail::make_pass<It, V, R> ();
  
     template <typename It, typename V, typename R = core::range<It>>
     inline parser<It, V, R> unit (V const& v)
@@ -74,7 +138,7 @@ namespace core
                 "[pure: " +
                 fnk::utility::to_string<V> (v) +
                 " :: " +
-                fnk::utility::type_name<V>::name() +
+                core::describe_type<V> () +
                 "]",
             .parse =
             [=](AccT const acc)
@@ -83,25 +147,22 @@ namespace core
                 acc->insert
                     (core::parse_result<U> {static_cast<U> (v)}, rng);
                 return acc;
-            }
+            },
+            .lookahead = core::first_set::epsilon ()
         };
     }
 
     template <typename It, typename V, typename R = core::range<It>>
     parser<It, V, R> const item = core::parser<It, V, R>
     {
-        .description = "[item :: " + fnk::utility::type_name<V>::name() + "]",
-        .parse = []
+        .description = "[item :: " + core::describe_type<V> () + "]",
+        .parse = [expected = core::expect_item<V> ()]
             (gsl::not_null_ptr
                 <typename core::parser<It, V, R>::accumulator_type> const acc)
         {
             if (acc->range_empty ()) {
                 auto rng (core::torange (*acc));
-                acc->insert
-                    (core::failure {"expected [item :: " +
-                                   fnk::utility::type_name<V>::name() +
-                                   "]"},
-                     rng);
+                acc->insert (core::failure {expected}, rng);
                 return acc;
             } else {
                 auto rng (core::torange_tail (*acc));
@@ -114,36 +175,34 @@ namespace core
         }
     };
 
-    template <typename It, typename T, typename R, typename Pr, 
-        typename = std::enable_if_t
-            <std::is_same
-                <typename fnk::type_support::function_traits<Pr>::return_type,
-                bool>::value>,
-        typename = std::enable_if_t
-            <std::is_convertible
-                <typename std::iterator_traits<It>::value_type,
-                typename fnk::type_support::function_traits<Pr>
-                    ::template argument<0>::type>
-                ::value>>
-    inline parser<It, T, R> satisfy (Pr && predicate, std::string const dsc)
+namespace detail
+{
+    //
+    // satisfy of a test of the next token, which the parse calls as is.
+    //
+    template <typename It, typename T, typename R, typename Test>
+    inline parser<It, T, R> make_satisfy (Test const& test,
+                                          std::string const& dsc,
+                                          core::first_set const& first)
     {
         using A = typename core::parser<It, T, R>::accumulator_type;
         using AccT = gsl::not_null_ptr<A>;
 
+        auto const expected_item (core::expect_item<T> ());
+        core::description const described ("['" + dsc + "']");
+        auto const expected (core::expect (described));
+
         return core::parser<It, T, R>
         {
-            .description = "['" + dsc + "']",
+            .description = described,
             .parse =
             [=](AccT const acc)
             {
                 if (acc->range_empty()) {
                     acc->insert
-                        (core::failure {"expected [item :: " +
-                                       fnk::utility::type_name<T>::name() +
-                                       "]"},
-                        core::torange (*acc));
+                        (core::failure {expected_item}, core::torange (*acc));
                     return acc;
-                } else if (fnk::eval (predicate, core::torange_head (*acc))) {
+                } else if (test (core::torange_head (*acc))) {
                     acc->insert
                         (core::parse_result<T>
                             {static_cast<T> (core::torange_head (*acc))},
@@ -151,14 +210,94 @@ namespace core
                     return acc;
                 } else {
                     acc->insert
-                        (core::failure {"expected ['" + dsc + "']"},
-                        core::torange (*acc));
+                        (core::failure {expected}, core::torange (*acc));
                     return acc;
                 }
-            }
+            },
+            .lookahead = first
         };
     }
 
+    //
+    // over byte-sized tokens a pure predicate is asked of every byte once,
+    // here, and the parse tests a bit of the table; over wider tokens (and
+    // for any predicate which is not pure) it is called for each token.
+    //
+    template <typename It, typename T, typename R, typename Pr>
+    inline parser<It, T, R> compile_satisfy (Pr && predicate,
+                                             std::string const& dsc,
+                                             std::true_type)
+    {
+        using token_type = typename std::iterator_traits<It>::value_type;
+        auto const table (core::byte_class::of<token_type> (predicate));
+        return make_satisfy<It, T, R> (table, dsc, table.first ());
+    }
+
+    template <typename It, typename T, typename R, typename Pr>
+    inline parser<It, T, R> compile_satisfy (Pr && predicate,
+                                             std::string const& dsc,
+                                             std::false_type)
+    {
+        using token_type = typename std::iterator_traits<It>::value_type;
+        return make_satisfy<It, T, R>
+            ([pred = std::forward<Pr> (predicate)](token_type const& t)
+                { return bool (fnk::eval (pred, t)); },
+             dsc,
+             core::first_set::any ());
+    }
+} // namespace detail
+
+    template <typename It, typename T, typename R, typename Pr, 
+        typename = std::enable_if_t
+            <std::is_same
+                <typename fnk::type_support::function_traits<Pr>::return_type,
+                bool>::value>,
+        typename = std::enable_if_t
+            <std::is_convertible
+                <typename std::iterator_traits<It>::value_type,
+                typename fnk::type_support::function_traits<Pr>
+                    ::template argument<0>::type>
+                ::value>,
+        typename = std::enable_if_t
+            <not std::is_same<std::decay_t<Pr>, core::byte_class>::value>,
+        typename = std::enable_if_t
+            <not core::is_pure_predicate<std::decay_t<Pr>>::value>>
+    inline parser<It, T, R> satisfy (Pr && predicate, std::string const dsc)
+    {
+        return detail::compile_satisfy<It, T, R>
+            (std::forward<Pr> (predicate), dsc, std::false_type {});
+    }
+
+    //
+    // satisfy of a pure predicate (see pure), compiled over byte-sized
+    // tokens into a table of the bytes it accepts.
+    //
+    template <typename It, typename T, typename R, typename Pr>
+    inline parser<It, T, R> satisfy (core::pure_predicate<Pr> const& predicate,
+                                     std::string const dsc)
+    {
+        using token_type = typename std::iterator_traits<It>::value_type;
+        return detail::compile_satisfy<It, T, R>
+            (predicate, dsc, core::is_byte_token<token_type> {});
+    }
+
+    //
+    // satisfy of a set of bytes, which may be composed of others with |, &
+    // and ~; the tokens must be byte-sized.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>>
+    inline parser<It, T, R> satisfy (core::byte_class const& table,
+                                     std::string const dsc)
+    {
+        using token_type = typename std::iterator_traits<It>::value_type;
+        static_assert (core::is_byte_token<token_type>::value,
+                       "a byte_class only classifies byte-sized tokens.");
+
+        return detail::make_satisfy<It, T, R> (table, dsc, table.first ());
+    }
+
     template <typename It,
              typename T = typename std::iterator_traits<It>::value_type,
              typename R = core::range<It>>
@@ -166,7 +305,7 @@ namespace core
     {
         auto pred ([t_ = std::forward<T>(t)] (T const& e) { return t_ == e; }); 
         return satisfy<It, T, R>
-            (pred,
+            (core::pure (pred),
             "pure: " +
             fnk::utility::to_string<T>(t) +
             " :: " +
@@ -214,7 +353,7 @@ namespace detail
                 return false;
             });
         return satisfy<It, T, R>
-            (pred,
+            (core::pure (pred),
             "pure: (one of) " +
             detail::list_to_string (l) +
             " :: " +
@@ -239,7 +378,7 @@ namespace detail
                 return is_okay;
             });
         return satisfy<It, T, R>
-            (pred,
+            (core::pure (pred),
             "pure: (none of) " +
             detail::list_to_string (l) +
             " :: " +
@@ -253,7 +392,7 @@ namespace detail
     {
         auto pred ([=](T const& t) { return start <= t && t <= end; });
         return satisfy<It, T, R>
-            (pred,
+            (core::pure (pred),
              "pure: (in) ["
              + fnk::utility::to_string<T>(start)
              + ", "
@@ -261,6 +400,263 @@ namespace detail
              + "] :: "
              + fnk::utility::type_name<T>::name());
     }
+
+namespace detail
+{
+    //
+    // the length of the longest run of tokens at the beginning of r which
+    // satisfy the predicate (or which do not, if until), counted in one
+    // loop over its iterators.
+    //
+    template <bool until, typename R, typename Pr>
+    inline typename R::diff_type scan_while (R const& r, Pr const& predicate)
+    {
+        typename R::diff_type n (0);
+        auto const e (r.end ());
+        for (auto it (r.begin ()); it != e && bool (predicate (*it)) != until;
+             ++it)
+            ++n;
+        return n;
+    }
+
+    //
+    // a run of a class of characters over contiguous bytes is scanned by
+    // the kernels of class_run, many bytes at a time.
+    //
+    template <bool until, typename R>
+    inline typename R::diff_type scan_class (R const& r,
+                                             class_predicate const& predicate,
+                                             std::true_type)
+    {
+        using T = typename R::token_type;
+        if (r.empty ())
+            return 0;
+
+        return static_cast<typename R::diff_type>
+            (class_run<T> (predicate,
+                           reinterpret_cast<unsigned char const*> (&*r.begin ()),
+                           static_cast<std::size_t> (r.length ()),
+                           until));
+    }
+
+    template <bool until, typename R>
+    inline typename R::diff_type scan_class (R const& r,
+                                             class_predicate const& predicate,
+                                             std::false_type)
+    {
+        typename R::diff_type n (0);
+        auto const e (r.end ());
+        for (auto it (r.begin ()); it != e && predicate (*it) != until; ++it)
+            ++n;
+        return n;
+    }
+
+    template <bool until, typename R>
+    inline typename R::diff_type scan_while (R const& r,
+                                             class_predicate const& predicate)
+    {
+        return scan_class<until>
+            (r, predicate,
+             is_contiguous_byte_iterator<typename R::iter_type> {});
+    }
+
+    //
+    // the bytes which may begin a run of tokens satisfying the predicate
+    // (or, until, not satisfying it): found by asking every byte of a pure
+    // predicate, a class of characters or a byte_class, and otherwise any.
+    //
+    template <typename T, bool until, typename Pr>
+    inline first_set predicate_first (Pr const&)
+    {
+        return first_set::any ();
+    }
+
+    template <typename T, bool until>
+    inline first_set bytes_first (first_set s)
+    {
+        if (until && not s.is_any ())
+            for (auto& b : s.bits)
+                b = ~b;
+        return s;
+    }
+
+    template <typename T, bool until, typename Pr>
+    inline first_set predicate_first (pure_predicate<Pr> const& predicate)
+    {
+        return bytes_first<T, until>
+            (first_of<T> (predicate, is_byte_token<T> {}));
+    }
+
+    template <typename T, bool until>
+    inline first_set predicate_first (class_predicate const& predicate)
+    {
+        return bytes_first<T, until>
+            (first_of<T> (predicate, is_byte_token<T> {}));
+    }
+
+    template <typename T, bool until>
+    inline first_set predicate_first (byte_class const& table)
+    {
+        return bytes_first<T, until>
+            (first_of<T> (table, is_byte_token<T> {}));
+    }
+
+    //
+    // a run of tokens (of at least min) as a single result of value type S,
+    // made from the iterators at its ends.
+    //
+    template <bool until, typename It, typename T, typename R, typename S,
+        typename Pr>
+    inline parser<It, S, R> make_take (Pr && predicate,
+                                       std::string const& dsc,
+                                       std::string const& name,
+                                       std::size_t const min)
+    {
+        using A = typename core::parser<It, S, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        auto const expected_item (core::expect_item<T> ());
+        auto const expected (core::expect (core::description::deferred
+            ([dsc] { return "['" + dsc + "']"; })));
+
+        using token_type = typename std::iterator_traits<It>::value_type;
+        auto const first (predicate_first<token_type, until> (predicate));
+
+        return core::parser<It, S, R>
+        {
+            .description = "[(" + name + ") '" + dsc + "']",
+            .parse =
+            [=, pred = std::forward<Pr> (predicate)](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                auto const n (scan_while<until> (rng, pred));
+                if (static_cast<std::size_t> (n) < min) {
+                    acc->insert
+                        (core::failure
+                            {rng.empty () ? expected_item : expected},
+                         rng);
+                    return acc;
+                }
+
+                auto const next (rng.tail (n));
+                acc->insert
+                    (core::parse_result<S> {S (rng.begin (), next.begin ())},
+                     next);
+                return acc;
+            },
+            .lookahead = min > 0 ? first : first.or_empty ()
+        };
+    }
+
+    template <typename It, typename T, typename R, typename Pr>
+    inline parser<It, T, R> make_skip (Pr && predicate,
+                                       std::string const& dsc,
+                                       std::string const& name,
+                                       std::size_t const min)
+    {
+        using A = typename core::parser<It, T, R>::accumulator_type;
+        using AccT = gsl::not_null_ptr<A>;
+
+        auto const expected_item (core::expect_item<T> ());
+        auto const expected (core::expect (core::description::deferred
+            ([dsc] { return "['" + dsc + "']"; })));
+
+        using token_type = typename std::iterator_traits<It>::value_type;
+        auto const first (predicate_first<token_type, false> (predicate));
+
+        return core::parser<It, T, R>
+        {
+            .description = "[(" + name + ") '" + dsc + "']",
+            .parse =
+            [=, pred = std::forward<Pr> (predicate)](AccT const acc)
+            {
+                auto const rng (core::torange (*acc));
+                auto const n (scan_while<false> (rng, pred));
+                if (static_cast<std::size_t> (n) < min)
+                    acc->insert
+                        (core::failure
+                            {rng.empty () ? expected_item : expected},
+                         rng);
+                else
+                    acc->replace (rng.tail (n));
+                return acc;
+            },
+            .lookahead = min > 0 ? first : first.or_empty ()
+        };
+    }
+} // namespace detail
+
+    //
+    // The longest run of tokens satisfying the predicate, found in a single
+    // loop over the range and made into a single result: by default the
+    // string of its tokens, or any S constructible from the iterators at its
+    // ends. This is the same as fold_many (or fold_some) of satisfy pushing
+    // each token onto a string, without a result being made (and a range
+    // copied) for every token. take_while succeeds on an empty run;
+    // take_while1 fails as satisfy does where the run would be empty.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>,
+             typename Pr>
+    inline parser<It, S, R> take_while (Pr && predicate, std::string const dsc)
+    {
+        return detail::make_take<false, It, T, R, S>
+            (std::forward<Pr> (predicate), dsc, "take_while", 0);
+    }
+
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>,
+             typename Pr>
+    inline parser<It, S, R> take_while1 (Pr && predicate, std::string const dsc)
+    {
+        return detail::make_take<false, It, T, R, S>
+            (std::forward<Pr> (predicate), dsc, "take_while1", 1);
+    }
+
+    //
+    // The run of tokens up to (but not including) the first which satisfies
+    // the predicate, or to the end of the input, as a single result.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename S = std::basic_string<T>,
+             typename Pr>
+    inline parser<It, S, R> take_until (Pr && predicate, std::string const dsc)
+    {
+        return detail::make_take<true, It, T, R, S>
+            (std::forward<Pr> (predicate), dsc, "take_until", 0);
+    }
+
+    //
+    // The longest run of tokens satisfying the predicate, skipped: as with
+    // skip_many, the range of the result the parser is called upon is moved
+    // on past them, and nothing is added to the accumulator. skip_while1
+    // fails as satisfy does where the run would be empty.
+    //
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename Pr>
+    inline parser<It, T, R> skip_while (Pr && predicate, std::string const dsc)
+    {
+        return detail::make_skip<It, T, R>
+            (std::forward<Pr> (predicate), dsc, "skip_while", 0);
+    }
+
+    template <typename It,
+             typename T = typename std::iterator_traits<It>::value_type,
+             typename R = core::range<It>,
+             typename Pr>
+    inline parser<It, T, R> skip_while1 (Pr && predicate, std::string const dsc)
+    {
+        return detail::make_skip<It, T, R>
+            (std::forward<Pr> (predicate), dsc, "skip_while1", 1);
+    }
 } // namespace core
 } // namespace rpc
 
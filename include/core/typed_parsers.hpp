@@ -0,0 +1,690 @@
+//
+// Statically-typed parser expressions
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#ifndef TYPED_PARSERS_HPP
+#define TYPED_PARSERS_HPP
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "range.hpp"
+#include "parser.hpp"
+#include "accumulator.hpp"
+#include "token_parsers.hpp"
+
+#include "../funktional/include/eval.hpp"
+#include "../funktional/include/type_support/function_traits.hpp"
+#include "../funktional/include/utility/type_utils.hpp"
+
+#include "../gsl/not_null.hpp"
+
+//
+// The parsers in this file mirror the combinators of `core/combinators.hpp`,
+// but where a `core::parser` hides its children behind a `std::function`, a
+// typed parser carries its children by value and encodes the structure of the
+// grammar in its type. A whole expression is therefore visible to (and may be
+// inlined by) the compiler. Typed parsers thread the same accumulators as
+// `core::parser`, and produce the same results; use `erase` to obtain a
+// `core::parser` at API boundaries, and `embed` to use a `core::parser` inside
+// of a typed expression.
+//
+namespace rpc
+{
+namespace core
+{
+namespace typed
+{
+namespace detail
+{
+    struct typed_parser_tag {};
+} // namespace detail
+
+    template <typename It, typename V, typename R>
+    struct typed_parser : public detail::typed_parser_tag
+    {
+        using iter_type  = It;
+        using range_type = R;
+        using token_type = typename std::iterator_traits<It>::value_type;
+        using value_type = V;
+        using result_type      = parse_result <V>;
+        using accumulator_type = accumulator <It, V, R>;
+        using acc_ptr          = gsl::not_null_ptr<accumulator_type>;
+    };
+
+    template <typename P>
+    struct is_typed_parser
+        : public std::is_base_of<detail::typed_parser_tag, std::decay_t<P>> {};
+
+    template <typename P>
+    using typed_traits = std::decay_t<P>;
+
+    //
+    // core::parser => typed parser
+    //
+    template <typename It, typename V, typename R>
+    struct embedded : public typed_parser<It, V, R>
+    {
+        using acc_ptr = typename typed_parser<It, V, R>::acc_ptr;
+
+        embedded (parser<It, V, R> const& p_) : p (p_) {}
+
+        parser<It, V, R> const p;
+
+        inline std::string description (void) const
+        {
+            return p.description;
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            return p.parse (acc);
+        }
+    };
+
+    template <typename It, typename V, typename R>
+    inline embedded<It, V, R> embed (parser<It, V, R> const& p)
+    {
+        return embedded<It, V, R> {p};
+    }
+
+    //
+    // typed parser => core::parser
+    //
+    template <typename P,
+              typename = std::enable_if_t<is_typed_parser<P>::value>>
+    inline auto erase (P const& p)
+        -> parser
+            <typename typed_traits<P>::iter_type,
+             typename typed_traits<P>::value_type,
+             typename typed_traits<P>::range_type>
+    {
+        using T = typed_traits<P>;
+        using AccT = typename T::acc_ptr;
+
+        return parser
+            <typename T::iter_type,
+             typename T::value_type,
+             typename T::range_type>
+        {
+            .description = description::deferred
+                ([p] { return p.description (); }),
+            .parse = [p](AccT const acc) { return p.parse (acc); }
+        };
+    }
+
+    template <typename It, typename T, typename R, typename Pr>
+    struct satisfier : public typed_parser<It, T, R>
+    {
+        using acc_ptr = typename typed_parser<It, T, R>::acc_ptr;
+
+        satisfier (Pr const& predicate_, std::string const& dsc_)
+            : predicate (predicate_), dsc (dsc_)
+            , expected_item (expect_item<T> ())
+            , expected (expect (core::description::deferred
+                ([d = dsc_] { return "['" + d + "']"; })))
+        {}
+
+        Pr const predicate;
+        std::string const dsc;
+        expectation const expected_item;
+        expectation const expected;
+
+        inline std::string description (void) const
+        {
+            return "['" + dsc + "']";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            if (acc->range_empty ()) {
+                acc->insert (failure {expected_item}, torange (*acc));
+            } else if (predicate (torange_head (*acc))) {
+                acc->insert
+                    (parse_result<T> {static_cast<T> (torange_head (*acc))},
+                     torange_tail (*acc));
+            } else {
+                acc->insert (failure {expected}, torange (*acc));
+            }
+            return acc;
+        }
+    };
+
+    template <typename It,
+              typename T = typename std::iterator_traits<It>::value_type,
+              typename R = range<It>,
+              typename Pr>
+    inline satisfier<It, T, R, std::decay_t<Pr>> satisfy
+        (Pr && predicate, std::string const& dsc)
+    {
+        return satisfier<It, T, R, std::decay_t<Pr>>
+            {std::forward<Pr> (predicate), dsc};
+    }
+
+    template <typename It,
+              typename T = typename std::iterator_traits<It>::value_type,
+              typename R = range<It>>
+    inline auto token (T const& t)
+    {
+        return satisfy<It, T, R>
+            ([t](T const& e) { return t == e; },
+             "pure: " +
+             fnk::utility::to_string<T>(t) +
+             " :: " +
+             fnk::utility::type_name<T>::name());
+    }
+
+    //
+    // The longest run of tokens satisfying the predicate (of at least min),
+    // scanned as core::take_while scans it: as a single result of value
+    // type S made from the iterators at its ends (Take), or skipped.
+    //
+    template <typename It, typename T, typename R, typename S, typename Pr,
+              bool Take>
+    struct scanner : public typed_parser<It, std::conditional_t<Take, S, T>, R>
+    {
+        using acc_ptr = typename typed_parser
+            <It, std::conditional_t<Take, S, T>, R>::acc_ptr;
+
+        scanner (Pr const& predicate_, std::string const& dsc_,
+                 std::string const& name_, std::size_t const min_)
+            : predicate (predicate_), dsc (dsc_), name (name_), min (min_)
+            , expected_item (expect_item<T> ())
+            , expected (expect (core::description::deferred
+                ([d = dsc_] { return "['" + d + "']"; })))
+        {}
+
+        Pr const predicate;
+        std::string const dsc;
+        std::string const name;
+        std::size_t const min;
+        expectation const expected_item;
+        expectation const expected;
+
+        inline std::string description (void) const
+        {
+            return "[(" + name + ") '" + dsc + "']";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            auto const rng (torange (*acc));
+            auto const n (core::detail::scan_while<false> (rng, predicate));
+            if (static_cast<std::size_t> (n) < min)
+                acc->insert
+                    (failure {rng.empty () ? expected_item : expected}, rng);
+            else
+                made (acc, rng, rng.tail (n));
+            return acc;
+        }
+
+    private:
+        template <bool K = Take, typename = std::enable_if_t<K>>
+        inline void made (acc_ptr const acc, R const& rng, R const& next) const
+        {
+            acc->insert
+                (parse_result<S> {S (rng.begin (), next.begin ())}, next);
+        }
+
+        template <bool K = Take, typename = std::enable_if_t<not K>,
+                  bool _ = bool{}>
+        inline void made (acc_ptr const acc, R const&, R const& next) const
+        {
+            acc->replace (next);
+        }
+    };
+
+    template <typename It,
+              typename T = typename std::iterator_traits<It>::value_type,
+              typename R = range<It>,
+              typename S = std::basic_string<T>,
+              typename Pr>
+    inline scanner<It, T, R, S, std::decay_t<Pr>, true> take_while
+        (Pr && predicate, std::string const& dsc)
+    {
+        return scanner<It, T, R, S, std::decay_t<Pr>, true>
+            {std::forward<Pr> (predicate), dsc, "take_while", 0};
+    }
+
+    template <typename It,
+              typename T = typename std::iterator_traits<It>::value_type,
+              typename R = range<It>,
+              typename S = std::basic_string<T>,
+              typename Pr>
+    inline scanner<It, T, R, S, std::decay_t<Pr>, true> take_while1
+        (Pr && predicate, std::string const& dsc)
+    {
+        return scanner<It, T, R, S, std::decay_t<Pr>, true>
+            {std::forward<Pr> (predicate), dsc, "take_while1", 1};
+    }
+
+    template <typename It,
+              typename T = typename std::iterator_traits<It>::value_type,
+              typename R = range<It>,
+              typename Pr>
+    inline scanner<It, T, R, T, std::decay_t<Pr>, false> skip_while
+        (Pr && predicate, std::string const& dsc)
+    {
+        return scanner<It, T, R, T, std::decay_t<Pr>, false>
+            {std::forward<Pr> (predicate), dsc, "skip_while", 0};
+    }
+
+    template <typename It,
+              typename T = typename std::iterator_traits<It>::value_type,
+              typename R = range<It>,
+              typename Pr>
+    inline scanner<It, T, R, T, std::decay_t<Pr>, false> skip_while1
+        (Pr && predicate, std::string const& dsc)
+    {
+        return scanner<It, T, R, T, std::decay_t<Pr>, false>
+            {std::forward<Pr> (predicate), dsc, "skip_while1", 1};
+    }
+
+    template <typename P, typename Q>
+    struct sequenced : public typed_parser
+        <typename typed_traits<P>::iter_type,
+         typename typed_traits<P>::value_type,
+         typename typed_traits<P>::range_type>
+    {
+        static_assert (std::is_same<typename typed_traits<P>::accumulator_type,
+                                    typename typed_traits<Q>::accumulator_type>
+                        ::value,
+                      "sequenced parsers must agree in type");
+
+        using acc_ptr = typename typed_traits<P>::acc_ptr;
+
+        sequenced (P const& p_, Q const& q_) : p (p_), q (q_) {}
+
+        P const p;
+        Q const q;
+
+        inline std::string description (void) const
+        {
+            return "[" + p.description () + " //then// " +
+                q.description () + "]";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            auto pres (p.parse (acc));
+            if (parse_success (*pres))
+                return q.parse (pres);
+            else
+                return pres;
+        }
+    };
+
+    template <typename P, typename Q>
+    inline sequenced<P, Q> sequence (P const& p, Q const& q)
+    {
+        return sequenced<P, Q> {p, q};
+    }
+
+    template <typename P, typename ... Qs,
+              typename = std::enable_if_t<sizeof...(Qs) >= 2>>
+    inline auto sequence (P const& p, Qs const& ... qs)
+    {
+        return sequence (p, sequence (qs...));
+    }
+
+    template <typename P, typename Q>
+    struct optioned : public typed_parser
+        <typename typed_traits<P>::iter_type,
+         typename typed_traits<P>::value_type,
+         typename typed_traits<P>::range_type>
+    {
+        static_assert (std::is_same<typename typed_traits<P>::accumulator_type,
+                                    typename typed_traits<Q>::accumulator_type>
+                        ::value,
+                      "alternative parsers must agree in type");
+
+        using A       = typename typed_traits<P>::accumulator_type;
+        using acc_ptr = typename typed_traits<P>::acc_ptr;
+        using V       = typename typed_traits<P>::value_type;
+
+        optioned (P const& p_, Q const& q_) : p (p_), q (q_) {}
+
+        P const p;
+        Q const q;
+
+        inline std::string description (void) const
+        {
+            return "[" + p.description () + " //or// " +
+                q.description () + "]";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            auto mark (acc->mark ());
+            auto pres (core::detail::backtrack_point
+                (acc, [this](acc_ptr const a) { return p.parse (a); }));
+
+            if (parse_success (*pres) || parse_fatal (*pres)) {
+                acc->commit (mark);
+                return acc;
+            } else {
+                acc->truncate (mark);
+                return q.parse (acc);
+            }
+        }
+    };
+
+    template <typename P, typename Q>
+    inline optioned<P, Q> option (P const& p, Q const& q)
+    {
+        return optioned<P, Q> {p, q};
+    }
+
+    template <typename P, typename ... Qs,
+              typename = std::enable_if_t<sizeof...(Qs) >= 2>>
+    inline auto option (P const& p, Qs const& ... qs)
+    {
+        return option (p, option (qs...));
+    }
+
+    //
+    // Zero or more (many) or at least one but at most n (some; no upper
+    // bound if n == 0) successful parses.
+    //
+    template <typename P, bool AtLeastOne>
+    struct iterated : public typed_parser
+        <typename typed_traits<P>::iter_type,
+         typename typed_traits<P>::value_type,
+         typename typed_traits<P>::range_type>
+    {
+        using A       = typename typed_traits<P>::accumulator_type;
+        using acc_ptr = typename typed_traits<P>::acc_ptr;
+        using V       = typename typed_traits<P>::value_type;
+
+        //
+        // a first parse which fails is reported as core::some reports it,
+        // by failwith of the description of p.
+        //
+        iterated (P const& p_, std::size_t const n_)
+            : p (p_), n (n_)
+            , failed (expect (core::description (p_.description ())))
+        {}
+
+        P const p;
+        std::size_t const n;
+        failure const failed;
+
+        inline std::string description (void) const
+        {
+            return (AtLeastOne ? "[(some) " : "[(many) ") +
+                p.description () + "]";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            auto const step = [this](acc_ptr const a) { return p.parse (a); };
+
+            auto mark (acc->mark ());
+            auto pres (core::detail::backtrack_point (acc, step));
+
+            if (parse_fatal (*pres))
+                return acc;
+            if (not parse_success (*pres)) {
+                acc->truncate (mark);
+                if (AtLeastOne)
+                    acc->insert (failed, torange (*acc));
+                return acc;
+            }
+
+            acc->commit (mark);
+            auto res (acc);
+            for (std::size_t i = 1; n == 0 || i < n; ++i) {
+                res = core::detail::backtrack_point (res, step);
+                if (not parse_success (*res)) {
+                    if (not parse_fatal (*res))
+                        res->ignore_previous ();
+                    break;
+                }
+            }
+            return res;
+        }
+    };
+
+    template <typename P>
+    inline iterated<P, false> many (P const& p)
+    {
+        return iterated<P, false> {p, 0};
+    }
+
+    template <typename P>
+    inline iterated<P, true> some (P const& p, std::size_t const n = 0)
+    {
+        return iterated<P, true> {p, n};
+    }
+
+    //
+    // Run a parser, keeping only the range it consumed; the results are
+    // ignored and the parser takes on the value type U.
+    //
+    template <typename U, typename P>
+    struct ignored : public typed_parser
+        <typename typed_traits<P>::iter_type,
+         U,
+         typename typed_traits<P>::range_type>
+    {
+        using PA      = typename typed_traits<P>::accumulator_type;
+        using PAccT   = typename typed_traits<P>::acc_ptr;
+        using acc_ptr = typename typed_parser
+            <typename typed_traits<P>::iter_type,
+             U,
+             typename typed_traits<P>::range_type>::acc_ptr;
+        using V       = typename typed_traits<P>::value_type;
+
+        ignored (P const& p_) : p (p_) {}
+
+        P const p;
+
+        inline std::string description (void) const
+        {
+            return p.description ();
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            scratch<PA> mock {torange (*acc), acc->context (),
+                              acc->resource ()};
+            auto pres (p.parse (PAccT {mock.get ()}));
+
+            if (parse_success (*pres))
+                acc->replace (torange (*pres));
+            else
+                acc->insert
+                    (failure {toresult_failure (*pres)}, torange (*pres));
+            return acc;
+        }
+    };
+
+    template <typename U, typename P>
+    inline ignored<U, P> liftignore (P const& p)
+    {
+        return ignored<U, P> {p};
+    }
+
+    template <typename P, typename Q>
+    inline auto ignorel (P const& p, Q const& q)
+    {
+        return sequence
+            (liftignore<typename typed_traits<Q>::value_type> (p), q);
+    }
+
+    template <typename P, typename Q>
+    inline auto ignorer (P const& p, Q const& q)
+    {
+        return sequence
+            (p, liftignore<typename typed_traits<P>::value_type> (q));
+    }
+
+    template <typename P, typename F>
+    struct lifted : public typed_parser
+        <typename typed_traits<P>::iter_type,
+         typename fnk::type_support::function_traits<F>::return_type,
+         typename typed_traits<P>::range_type>
+    {
+        using U       = typename fnk::type_support::function_traits<F>
+            ::return_type;
+        using PA      = typename typed_traits<P>::accumulator_type;
+        using PAccT   = typename typed_traits<P>::acc_ptr;
+        using acc_ptr = typename typed_parser
+            <typename typed_traits<P>::iter_type,
+             U,
+             typename typed_traits<P>::range_type>::acc_ptr;
+        using V       = typename typed_traits<P>::value_type;
+
+        lifted (P const& p_, F const& f_) : p (p_), f (f_) {}
+
+        P const p;
+        F const f;
+
+        inline std::string description (void) const
+        {
+            return "[" + p.description () + " //fmap// " +
+                fnk::utility::format_function_type<F>() + "]";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            scratch<PA> mock {torange (*acc), acc->context (),
+                              acc->resource ()};
+            auto res (p.parse (PAccT {mock.get ()}));
+
+            if (parse_success (*res)) {
+                auto made (res->since (1));
+                for (auto it (made.first); it != made.second; ++it) {
+                    auto const& r (it->first);
+                    if (r.is_value ())
+                        acc->insert (f (r.to_value ()), torange (*it));
+                    else if (r.is_empty ())
+                        acc->insert (empty<U>{}, torange (*it));
+                }
+                // as for core::lift, a parse which only moved its range on
+                // moves on the range of this one.
+                if (made.first == made.second)
+                    acc->replace (torange (*res));
+            } else {
+                acc->insert
+                    (failure {toresult_failure (*res)}, torange (*res));
+            }
+            return acc;
+        }
+    };
+
+    template <typename P, typename F>
+    inline lifted<P, std::decay_t<F>> lift (P const& p, F && f)
+    {
+        return lifted<P, std::decay_t<F>> {p, std::forward<F> (f)};
+    }
+
+    template <typename U, typename P>
+    inline auto lift (P const& p)
+    {
+        using V = typename typed_traits<P>::value_type;
+        return lift (p, [](V const& v) { return static_cast<U> (v); });
+    }
+
+    //
+    // Reduce over the values of a parse with a foldl (Left == true) or a
+    // foldr (Left == false) of the function f from the initial value b.
+    //
+    template <typename P, typename F, typename B, bool Left>
+    struct reduced : public typed_parser
+        <typename typed_traits<P>::iter_type,
+         typename fnk::type_support::function_traits<F>::return_type,
+         typename typed_traits<P>::range_type>
+    {
+        using W       = typename fnk::type_support::function_traits<F>
+            ::return_type;
+        using PA      = typename typed_traits<P>::accumulator_type;
+        using PAccT   = typename typed_traits<P>::acc_ptr;
+        using acc_ptr = typename typed_parser
+            <typename typed_traits<P>::iter_type,
+             W,
+             typename typed_traits<P>::range_type>::acc_ptr;
+        using V       = typename typed_traits<P>::value_type;
+
+        reduced (P const& p_, F const& f_, B const& b_)
+            : p (p_), f (f_), b (b_)
+        {}
+
+        P const p;
+        F const f;
+        B const b;
+
+        inline std::string description (void) const
+        {
+            return (Left ? "[(reducel'd by" : "[(reducer'd by") +
+                fnk::utility::format_function_type<F>() + ") " +
+                p.description () + "]";
+        }
+
+        inline acc_ptr parse (acc_ptr const acc) const
+        {
+            scratch<PA> mock {torange (*acc), acc->context (),
+                              acc->resource ()};
+            auto res (p.parse (PAccT {mock.get ()}));
+
+            if (parse_success (*res)) {
+                acc->insert (fold (*res), torange (*res));
+            } else {
+                acc->insert
+                    (failure {toresult_failure (*res)}, torange (*res));
+            }
+            return acc;
+        }
+
+    private:
+        //
+        // folded as the values are visited (from the back, for a foldr),
+        // rather than through fnk::foldl or fnk::foldr of a copy of them.
+        //
+        template <bool L = Left, typename = std::enable_if_t<L>>
+        inline W fold (PA const& res) const
+        {
+            W w (b);
+            for (auto it (res.cbegin ()); it != res.cend (); ++it)
+                if (it->first.is_value ())
+                    w = f (it->first.to_value (), w);
+            return w;
+        }
+
+        template <bool L = Left, typename = std::enable_if_t<not L>,
+                  bool _ = bool{}>
+        inline W fold (PA const& res) const
+        {
+            W w (b);
+            for (auto it (res.crbegin ()); it != res.crend (); ++it)
+                if (it->first.is_value ())
+                    w = f (it->first.to_value (), w);
+            return w;
+        }
+    };
+
+    template <typename P, typename F, typename B>
+    inline reduced<P, std::decay_t<F>, std::decay_t<B>, true> reducel
+        (P const& p, F && f, B && b)
+    {
+        return reduced<P, std::decay_t<F>, std::decay_t<B>, true>
+            {p, std::forward<F> (f), std::forward<B> (b)};
+    }
+
+    template <typename P, typename F, typename B>
+    inline reduced<P, std::decay_t<F>, std::decay_t<B>, false> reducer
+        (P const& p, F && f, B && b)
+    {
+        return reduced<P, std::decay_t<F>, std::decay_t<B>, false>
+            {p, std::forward<F> (f), std::forward<B> (b)};
+    }
+} // namespace typed
+} // namespace core
+} // namespace rpc
+
+#endif // ifndef TYPED_PARSERS_HPP
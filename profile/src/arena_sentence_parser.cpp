@@ -0,0 +1,196 @@
+//
+// Profiling the sentence grammar with and without a monotonic arena
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <streambuf>
+#include <utility>
+
+#include "core/memory.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+//
+// count every call to the global allocator.
+//
+#if defined(__GNUC__) && not defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::size_t allocation_count = 0;
+static std::size_t allocation_bytes = 0;
+
+void * operator new (std::size_t bytes)
+{
+    ++allocation_count;
+    allocation_bytes += bytes;
+    if (auto p = std::malloc (bytes ? bytes : 1))
+        return p;
+    throw std::bad_alloc ();
+}
+
+void operator delete (void * p) noexcept
+{
+    std::free (p);
+}
+
+void operator delete (void * p, std::size_t) noexcept
+{
+    std::free (p);
+}
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+using sentence_type = std::deque<std::string>;
+
+static auto const accumulate_front =
+    [](std::string const& t, std::deque<std::string> & c)
+{
+    c.push_front (t);
+    return c;
+};
+
+static auto const char_to_string = [](char c) { return std::string (1, c); };
+
+auto grammar (void)
+{
+    auto wordsep  = ignorer (basic::word<iter>, basic::spacem<iter>);
+    auto punctstr = lift (basic::punct<iter>, char_to_string);
+    auto sentence = lift<sentence_type>
+        (reducer (sequence (some (wordsep), punctstr),
+                  accumulate_front,
+                  std::deque<std::string>{}));
+    auto sentencesep = ignorer (sentence, basic::spacem<iter>);
+    return some (sentencesep);
+}
+
+std::string read_in_file (std::string const& filename)
+{
+    std::ifstream file (filename);
+    std::string out;
+
+    file.seekg (0, std::ios::end);
+    out.reserve (file.tellg());
+    file.seekg (0, std::ios::beg);
+
+    out.assign ((std::istreambuf_iterator<char>(file)),
+                 std::istreambuf_iterator<char>());
+    out.erase  (1 + out.find_last_not_of (" \v\n\r\t"));
+    return out;
+}
+
+struct run_summary
+{
+    long long total;
+    std::size_t allocations;
+    std::size_t bytes;
+    std::size_t results;
+};
+
+//
+// parse the text `runs` times, as a service parsing one document after
+// another would; with an arena, it is released after each document.
+//
+template <typename P>
+run_summary profile (P const& p, std::string const& text, int runs,
+                     monotonic_arena * const arena)
+{
+    run_summary s {0, 0, 0, 0};
+    core::range<iter> const r {text};
+
+    auto const count  (allocation_count);
+    auto const bytes  (allocation_bytes);
+    auto const start  (std::chrono::high_resolution_clock::now());
+    for (int i = 0; i < runs; ++i) {
+        if (arena) {
+            {
+                auto res (core::parse (p, r, *arena));
+                s.results = res.size ();
+            }
+            arena->release ();
+        } else {
+            auto res (core::parse (p, r));
+            s.results = res.size ();
+        }
+    }
+    auto const end (std::chrono::high_resolution_clock::now());
+
+    s.total       = std::chrono::duration_cast<std::chrono::microseconds>
+        (end - start).count();
+    s.allocations = allocation_count - count;
+    s.bytes       = allocation_bytes - bytes;
+    return s;
+}
+
+void report (std::string const& name, run_summary const& s,
+             std::size_t const length, int runs)
+{
+    auto const mb (static_cast<double> (length) * runs / (1024 * 1024));
+    std::cout << name << ": "
+              << s.results << " results; "
+              << s.allocations / runs << " allocations ("
+              << s.bytes / runs << " bytes) per parse; mean "
+              << s.total / runs << " microsec., "
+              << mb / (static_cast<double> (s.total) / 1e6) << " MB/s"
+              << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    if (argc == 1) {
+        std::cout << "Need file name for text to parse!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 10;
+    std::string const filename (argv[1]);
+
+    if (not std::ifstream (filename).good ()) {
+        std::cout << "File: "
+                  << filename
+                  << " does not exist (or cannot be read)!"
+                  << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    auto const parse_text (read_in_file (filename));
+    auto const sentences  (grammar ());
+
+    std::cout << "Parsing: " << filename << " for sentences ("
+              << runs << " runs)\n..." << std::endl;
+
+    monotonic_arena arena;
+    monotonic_arena huge_arena {monotonic_arena::huge_page_size, true};
+
+    // warm up the arenas (and the scratch accumulator pools) with one parse.
+    (void) profile (sentences, parse_text, 1, &arena);
+    (void) profile (sentences, parse_text, 1, &huge_arena);
+
+    auto const d (profile (sentences, parse_text, runs, nullptr));
+    auto const a (profile (sentences, parse_text, runs, &arena));
+    auto const h (profile (sentences, parse_text, runs, &huge_arena));
+
+    report ("operator new      ", d, parse_text.size (), runs);
+    report ("arena             ", a, parse_text.size (), runs);
+    report ("arena, huge pages ", h, parse_text.size (), runs);
+    std::cout << "arena capacity: " << arena.capacity ()
+              << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+//
+// Profiling runs of a class of characters scanned a byte at a time through
+// a predicate, and many bytes at a time by the kernels of char_class
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core/char_class.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter   = typename std::basic_string<char>::const_iterator;
+using cparse = parser<iter, char>;
+
+//
+// runs of w characters of the class, each followed by one which is not,
+// parsed as many (ignorel (skip_while1 (class), sep)).
+//
+template <typename Pr>
+cparse runs_of (Pr const& predicate, char const sep)
+{
+    return many (ignorel (skip_while1<iter> (predicate, "class"),
+                          token<iter> (char (sep))));
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const length = argc > 1 ? std::atol (argv[1]) : 1 << 22;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    struct test
+    {
+        std::string name;
+        cparse bytewise;
+        cparse kernel;
+        std::string letters;
+        char sep;
+    };
+
+    test const tests []
+    {
+        {"space",
+         runs_of ([](char const& c) -> bool { return std::isspace (c); }, 'x'),
+         runs_of (class_predicate {char_class::space}, 'x'),
+         " \t\n ", 'x'},
+        {"digit",
+         runs_of ([](char const& c) -> bool { return std::isdigit (c); }, 'x'),
+         runs_of (class_predicate {char_class::digit}, 'x'),
+         "0123456789", 'x'},
+        {"alpha",
+         runs_of ([](char const& c) -> bool { return std::isalpha (c); }, ' '),
+         runs_of (class_predicate {char_class::alpha}, ' '),
+         "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ", ' '},
+        {"punct",
+         runs_of ([](char const& c) -> bool { return std::ispunct (c); }, 'x'),
+         runs_of (class_predicate {char_class::punct}, 'x'),
+         "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~", 'x'},
+        {"xdigit",
+         runs_of ([](char const& c) -> bool { return std::isxdigit (c); }, 'x'),
+         runs_of (class_predicate {char_class::xdigit}, 'x'),
+         "0123456789abcdefABCDEF", 'x'}
+    };
+
+    std::cout << "Scanning " << length << " characters in runs (best of "
+              << runs << " runs)\n..." << std::endl;
+
+    for (auto const& t : tests) {
+        for (std::size_t w = 16; w <= 4096; w *= 16) {
+            std::string text;
+            while (text.size () < length) {
+                for (std::size_t i = 0; i < w; ++i)
+                    text += t.letters [i % t.letters.size ()];
+                text += t.sep;
+            }
+            core::range<iter> const r {text};
+
+            auto const profile = [&](cparse const& p)
+            {
+                long long best (0);
+                for (int i = 0; i < runs; ++i) {
+                    auto start = std::chrono::high_resolution_clock::now();
+                    auto res   = core::parse (p, r);
+                    auto end   = std::chrono::high_resolution_clock::now();
+                    auto us    = std::chrono::duration_cast
+                        <std::chrono::microseconds> (end - start).count();
+
+                    if (not torange (res).empty ())
+                        std::cout << "incomplete parse!" << std::endl;
+                    best = i == 0 ? us : std::min (best, (long long) us);
+                }
+                return best;
+            };
+
+            auto const bytewise_us (profile (t.bytewise));
+            auto const kernel_us   (profile (t.kernel));
+
+            std::cout << t.name << " runs of " << w << ": bytewise "
+                      << bytewise_us << " microsec. ("
+                      << text.size () / std::max (1ll, bytewise_us)
+                      << " MB/s), kernel " << kernel_us << " microsec. ("
+                      << text.size () / std::max (1ll, kernel_us)
+                      << " MB/s)" << std::endl;
+        }
+    }
+    return 0;
+}
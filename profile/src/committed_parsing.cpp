@@ -0,0 +1,194 @@
+//
+// Profiling commit: memo tables and error reporting on a long document
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+
+#include "core/memo.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter   = typename std::basic_string<char>::const_iterator;
+using cparse = parser<iter, char>;
+
+//
+// the bytes held from the global heap, and the most held at once; each
+// block is prefixed with its size.
+//
+static std::size_t live_bytes = 0;
+static std::size_t peak_bytes = 0;
+
+void * operator new (std::size_t bytes)
+{
+    auto const header (alignof (std::max_align_t));
+    auto const block (static_cast<char *> (std::malloc (bytes + header)));
+    if (block == nullptr)
+        throw std::bad_alloc {};
+
+    *reinterpret_cast<std::size_t *> (block) = bytes;
+    live_bytes += bytes;
+    peak_bytes  = std::max (peak_bytes, live_bytes);
+    return block + header;
+}
+
+void operator delete (void * p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    auto const block
+        (static_cast<char *> (p) - alignof (std::max_align_t));
+    live_bytes -= *reinterpret_cast<std::size_t *> (block);
+    std::free (block);
+}
+
+void operator delete (void * p, std::size_t) noexcept
+{
+    operator delete (p);
+}
+
+//
+// The grammar
+//
+//      document := stmt*           (skipped, so that only the memo tables
+//                                   grow with the input)
+//      stmt     := name '=' number ';'
+//                | name '(' number ')' ';'
+//                | name ';'
+//
+// whose alternatives share the name with which they begin; a name or a
+// number is one letter or digit followed by any more, which are skipped.
+// In packrat mode every choice is memoized, at every position it is tried.
+//
+// If committed, each statement commits once the token after its name has
+// decided which it is; the rest of it must then parse.
+//
+cparse document (bool const committed)
+{
+    auto const name   (sequence (in_range<iter> ('a', 'z'),
+                                 skip_many (in_range<iter> ('a', 'z'))));
+    auto const number (sequence (in_range<iter> ('0', '9'),
+                                 skip_many (in_range<iter> ('0', '9'))));
+
+    auto const cut = [committed](cparse const& p)
+    {
+        return committed ? commit (p) : p;
+    };
+
+    auto const assign
+        (sequence (name, token<iter> ('='),
+                   cut (sequence (number, token<iter> (';')))));
+    auto const call
+        (sequence (name, token<iter> ('('),
+                   cut (sequence (number, token<iter> (')'),
+                                  token<iter> (';')))));
+    auto const bare (sequence (name, token<iter> (';')));
+
+    return skip_many (option (assign, call, bare));
+}
+
+//
+// n statements, of each kind in turn; if broken, the number of the middle
+// assignment is missing.
+//
+std::string statements (std::size_t const n, bool const broken)
+{
+    std::string out;
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const number (broken && i == n / 2 / 3 * 3
+            ? std::string () : std::to_string (i));
+        switch (i % 3) {
+            case 0:  out += "count=" + number + ";"; break;
+            case 1:  out += "emit(" + number + ");"; break;
+            default: out += "flush;"; break;
+        }
+    }
+    return out;
+}
+
+struct run_summary
+{
+    long long best;
+    std::string outcome;
+    std::size_t peak;
+};
+
+//
+// the best time of the given number of runs, the outcome of the parse, and
+// the most heap memory held above that held before it (by the accumulator
+// and the memo tables of a new context).
+//
+run_summary profile (cparse const& p, std::string const& text, int runs)
+{
+    run_summary s {0, "", 0};
+
+    for (int i = 0; i < runs; ++i) {
+        auto const before (live_bytes);
+        peak_bytes = live_bytes;
+
+        memo_context ctx {memo_mode::PACKRAT};
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, core::range<iter> {text}, ctx);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best = i == 0 ? us : std::min (s.best, (long long) us);
+        s.peak = peak_bytes - before;
+        auto const r (torange (res));
+        auto const at (text.size () -
+            static_cast<std::size_t> (std::distance (r.begin (), r.end ())));
+        s.outcome = parse_fatal (res)
+            ? "fatal failure at " + std::to_string (at) + ": " +
+              toresult_failure_message (res)
+            : r.empty ()
+                ? std::string ("success")
+                : "success, stopped at " + std::to_string (at);
+    }
+    return s;
+}
+
+void report (std::string const& name, std::size_t n, run_summary const& s)
+{
+    std::cout << name << " " << n << " statements: " << s.outcome
+              << "; best " << s.best << " microsec., peak "
+              << s.peak / 1024 << " KiB" << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_stmts = argc > 1 ? std::atol (argv[1]) : 65536;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 3;
+
+    auto const backtracking (document (false));
+    auto const committed    (document (true));
+
+    std::cout << "Parsing statements in packrat mode (best of "
+              << runs << " runs)\n..." << std::endl;
+
+    for (bool const broken : {false, true}) {
+        for (std::size_t n = max_stmts / 64; n <= max_stmts; n *= 4) {
+            auto const text (statements (n, broken));
+            report ("backtracking", n, profile (backtracking, text, runs));
+            report ("committed   ", n, profile (committed, text, runs));
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+//
+// Profiling arithmetic expressions parsed by reduction, by chains, and by
+// an operator precedence table
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/precedence.hpp"
+#include "core/token_parsers.hpp"
+
+#include "basic/numeric_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter   = typename std::basic_string<char>::const_iterator;
+using num_t  = unsigned long;
+using binop  = std::function<num_t (num_t, num_t)>;
+
+//
+// n numbers between 1 and max joined by +, - and *; the arithmetic is that
+// of unsigned long, and so wraps around rather than overflowing.
+//
+std::string expression (std::size_t n, int max, std::mt19937 & gen)
+{
+    std::uniform_int_distribution<int> number (1, max);
+    std::uniform_int_distribution<int> op (0, 2);
+
+    std::string out (std::to_string (number (gen)));
+    for (std::size_t i = 1; i < n; ++i) {
+        out += "+-*" [op (gen)];
+        out += std::to_string (number (gen));
+    }
+    return out;
+}
+
+template <typename F>
+long long best_of (int runs, F && f)
+{
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f ();
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+        best = i == 0 ? us : std::min (best, (long long) us);
+    }
+    return best;
+}
+
+//
+// parse expressions of the given operands in three ways, and check that
+// their values agree:
+//
+//      expr := term (('+' term) | ('-' term))*
+//      term := num ('*' num)*
+//
+void profile (parser<iter, num_t> const& num, int const max,
+              std::size_t const max_terms, int const runs)
+{
+    //
+    // by reduction: every operand of a term, then every term of the
+    // expression (negated after a '-'), is pushed into an accumulator and
+    // folded once the whole list has been parsed.
+    //
+    auto const reduced_term
+        (reducel (sequence (num, many (ignorel (token<iter> ('*'), num))),
+                  [](num_t x, num_t & acc) { return acc * x; },
+                  num_t (1)));
+    auto const reduced
+        (reducel (sequence (reduced_term,
+                            many (option
+                                (ignorel (token<iter> ('+'), reduced_term),
+                                 lift (ignorel (token<iter> ('-'), reduced_term),
+                                       [](num_t x) { return num_t (0) - x; })))),
+                  [](num_t x, num_t & acc) { return acc + x; },
+                  num_t (0)));
+
+    //
+    // by chains: each level of precedence is a chainl1 of the one above.
+    //
+    auto const op = [](parser<iter, char> const& symbol, binop f)
+    {
+        return lift (symbol, [f](char) { return f; });
+    };
+    auto const addop (option (op (token<iter> ('+'), std::plus<num_t> {}),
+                              op (token<iter> ('-'), std::minus<num_t> {})));
+    auto const mulop (op (token<iter> ('*'), std::multiplies<num_t> {}));
+    auto const chained (chainl1 (chainl1 (num, mulop), addop));
+
+    //
+    // by a table of operators.
+    //
+    operator_table<iter, num_t, char> table;
+    table.infixl (token<iter> ('+'), 1, std::plus<num_t> {})
+         .infixl (token<iter> ('-'), 1, std::minus<num_t> {})
+         .infixl (token<iter> ('*'), 2, std::multiplies<num_t> {});
+    auto const climbing (pratt (num, table));
+
+    std::mt19937 gen (42);
+    for (std::size_t n = max_terms / 256; n <= max_terms; n *= 4) {
+        auto const text (expression (n, max, gen));
+        core::range<iter> const r {text};
+
+        num_t values [3] = {0, 0, 0};
+        auto const run = [&](parser<iter, num_t> const& p, num_t & v)
+        {
+            return best_of (runs, [&]
+            {
+                auto res (core::parse (p, r));
+                v = parse_success (res) && torange (res).empty ()
+                    ? toresult (res).to_value () : 0;
+            });
+        };
+
+        auto const reduced_us  (run (reduced,  values [0]));
+        auto const chained_us  (run (chained,  values [1]));
+        auto const climbing_us (run (climbing, values [2]));
+
+        std::cout << n << " terms (" << text.size () << " bytes): "
+                  << "reducel " << reduced_us << " microsec., "
+                  << "chainl1 " << chained_us << " microsec., "
+                  << "pratt " << climbing_us << " microsec."
+                  << (values [0] == values [1] && values [1] == values [2]
+                        ? "" : "; values differ!")
+                  << std::endl;
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_terms = argc > 1 ? std::atol (argv[1]) : 262144;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    std::cout << "Parsing and evaluating arithmetic expressions of numbers "
+              << "(best of " << runs << " runs)\n..." << std::endl;
+    profile (basic::natural<iter>, 999, max_terms, runs);
+
+    std::cout << "\nParsing and evaluating arithmetic expressions of digits "
+              << "(best of " << runs << " runs)\n..." << std::endl;
+    profile (lift (basic::digit<iter>, [](char c) { return num_t (c - '0'); }),
+             9, max_terms, runs);
+    return 0;
+}
@@ -0,0 +1,146 @@
+//
+// Profiling GLL parsing of left recursive and ambiguous grammars
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "core/gll.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+//
+// n terms of `a` separated by `+`.
+//
+std::string terms (std::size_t n)
+{
+    std::string out ("a");
+    for (std::size_t i = 1; i < n; ++i)
+        out += "+a";
+    return out;
+}
+
+template <typename F>
+long long best_of (int runs, F && f)
+{
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f ();
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+        best = i == 0 ? us : std::min (best, (long long) us);
+    }
+    return best;
+}
+
+//
+// The left recursive grammar
+//
+//      list := list '+' 'a' | 'a'
+//
+// which the combinators cannot parse as written (it recurses forever), and
+// which must be factored by hand into 'a' ('+' 'a')*.
+//
+void profile_left_recursion (std::size_t const max_terms, int runs)
+{
+    gll::grammar<iter, char> g;
+    auto const list (g.nonterminal ("list"));
+    auto const a    (g.terminal (token<iter> ('a')));
+    auto const plus (g.terminal (token<iter> ('+')));
+    g.rule (list, {list, plus, a});
+    g.rule (list, {a});
+
+    auto const gll_list  (gll::to_parser (g, list));
+    auto const hand_list (sequence (token<iter> ('a'),
+                                    many (sequence (token<iter> ('+'),
+                                                    token<iter> ('a')))));
+
+    std::cout << "list := list '+' 'a' | 'a'\n..." << std::endl;
+    for (std::size_t n = max_terms / 64; n <= max_terms; n *= 4) {
+        auto const text (terms (n));
+        core::range<iter> const r {text};
+
+        std::size_t gll_results (0), hand_results (0);
+        auto const gll_us (best_of (runs, [&]
+        {
+            gll_results = core::parse (gll_list, r).size ();
+        }));
+        auto const hand_us (best_of (runs, [&]
+        {
+            hand_results = core::parse (hand_list, r).size ();
+        }));
+
+        std::cout << n << " terms: gll " << gll_us << " microsec. ("
+                  << 1000.0 * gll_us / text.size () << " ns/token), "
+                  << "factored by hand " << hand_us << " microsec. ("
+                  << 1000.0 * hand_us / text.size () << " ns/token)"
+                  << (gll_results == hand_results ? "" : "; results differ!")
+                  << std::endl;
+    }
+}
+
+//
+// The ambiguous grammar
+//
+//      expr := expr '+' expr | 'a'
+//
+// with a Catalan number of derivations of n terms, all of which are kept in
+// the forest, in space and time at most cubic in n.
+//
+void profile_ambiguity (std::size_t const max_terms, int runs)
+{
+    gll::grammar<iter, char> g;
+    auto const expr (g.nonterminal ("expr"));
+    auto const a    (g.terminal (token<iter> ('a')));
+    auto const plus (g.terminal (token<iter> ('+')));
+    g.rule (expr, {expr, plus, expr});
+    g.rule (expr, {a});
+
+    std::cout << "\nexpr := expr '+' expr | 'a'\n..." << std::endl;
+    for (std::size_t n = max_terms / 8; n <= max_terms; n *= 2) {
+        auto const text (terms (n));
+        core::range<iter> const r {text};
+
+        std::size_t nodes (0), packed (0), ambiguous (0);
+        auto const us (best_of (runs, [&]
+        {
+            auto const f (gll::parse (g, expr, r));
+            nodes     = f.nodes.size ();
+            packed    = f.packed.size ();
+            ambiguous = f.ambiguities (f.root ());
+        }));
+
+        std::cout << n << " terms: " << us << " microsec.; "
+                  << nodes << " forest nodes, " << packed
+                  << " packed nodes, " << ambiguous << " ambiguous nodes"
+                  << std::endl;
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_terms = argc > 1 ? std::atol (argv[1]) : 65536;
+    std::size_t const max_ambiguous = argc > 2 ? std::atol (argv[2]) : 128;
+    int const runs = argc > 3 ? std::max (1, std::atoi (argv[3])) : 3;
+
+    profile_left_recursion (max_terms, runs);
+    profile_ambiguity (max_ambiguous, runs);
+    return 0;
+}
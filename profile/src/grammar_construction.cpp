@@ -0,0 +1,196 @@
+//
+// Profiling the construction of the text and numeric parsers, and the
+// rendering of their descriptions
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+//
+// count every call to the global allocator, and the bytes held.
+//
+#if defined(__GNUC__) && not defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::size_t allocation_count = 0;
+static std::size_t allocation_bytes = 0;
+static std::size_t allocation_live  = 0;
+
+void * operator new (std::size_t bytes)
+{
+    ++allocation_count;
+    allocation_bytes += bytes;
+    allocation_live  += bytes;
+    if (auto p = static_cast<std::size_t *> (std::malloc (bytes + 16))) {
+        *p = bytes;
+        return p + 2;
+    }
+    throw std::bad_alloc ();
+}
+
+void operator delete (void * p) noexcept
+{
+    if (p) {
+        auto q (static_cast<std::size_t *> (p) - 2);
+        allocation_live -= *q;
+        std::free (q);
+    }
+}
+
+void operator delete (void * p, std::size_t) noexcept
+{
+    operator delete (p);
+}
+
+//
+// taken before any other static initialization (where supported), so
+// that the construction of the parser variable templates below is timed.
+//
+struct snapshot
+{
+    snapshot (void)
+        : time  (std::chrono::high_resolution_clock::now())
+        , count (allocation_count)
+        , bytes (allocation_bytes)
+        , live  (allocation_live)
+    {}
+
+    std::chrono::high_resolution_clock::time_point const time;
+    std::size_t const count;
+    std::size_t const bytes;
+    std::size_t const live;
+};
+
+#if defined(__GNUC__)
+static snapshot const before_init __attribute__ ((init_priority (101)));
+#else
+static snapshot const before_init;
+#endif
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "basic/text_parsers.hpp"
+#include "basic/numeric_parsers.hpp"
+
+using namespace rpc;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+template <typename P>
+std::function<std::string ()> describe (P const& p)
+{
+    return [&p] { return std::string (p.description); };
+}
+
+int main (void)
+{
+    snapshot const after_init;
+
+    std::vector<std::function<std::string ()>> const descriptions
+    {
+        describe (basic::space<iter>),
+        describe (basic::spaces<iter>),
+        describe (basic::spacem<iter>),
+        describe (basic::punct<iter>),
+        describe (basic::puncts<iter>),
+        describe (basic::punctm<iter>),
+        describe (basic::alpha<iter>),
+        describe (basic::alpham<iter>),
+        describe (basic::alphas<iter>),
+        describe (basic::palpha<iter>),
+        describe (basic::palpham<iter>),
+        describe (basic::palphas<iter>),
+        describe (basic::lower<iter>),
+        describe (basic::lowers<iter>),
+        describe (basic::lowerm<iter>),
+        describe (basic::upper<iter>),
+        describe (basic::uppers<iter>),
+        describe (basic::upperm<iter>),
+        describe (basic::digit<iter>),
+        describe (basic::digits<iter>),
+        describe (basic::digitm<iter>),
+        describe (basic::hexdigit<iter>),
+        describe (basic::hexdigits<iter>),
+        describe (basic::hexdigitm<iter>),
+        describe (basic::cntrl<iter>),
+        describe (basic::cntrls<iter>),
+        describe (basic::cntrlm<iter>),
+        describe (basic::word<iter>),
+        describe (basic::words<iter>),
+        describe (basic::wordm<iter>),
+        describe (basic::pword<iter>),
+        describe (basic::pwords<iter>),
+        describe (basic::pwordm<iter>),
+        describe (basic::detail::natural_str<iter>),
+        describe (basic::detail::plus_natural_str<iter>),
+        describe (basic::detail::minus_natural_str<iter>),
+        describe (basic::detail::decimal_str<iter>),
+        describe (basic::detail::number_str<iter>),
+        describe (basic::detail::exponent_str<iter>),
+        describe (basic::detail::floating_str<iter>),
+        describe (basic::todigit<iter>),
+        describe (basic::todigits<iter>),
+        describe (basic::todigitm<iter>),
+        describe (basic::natural<iter>),
+        describe (basic::naturals<iter>),
+        describe (basic::naturalm<iter>),
+        describe (basic::lnatural<iter>),
+        describe (basic::lnaturals<iter>),
+        describe (basic::lnaturalm<iter>),
+        describe (basic::integer<iter>),
+        describe (basic::integers<iter>),
+        describe (basic::integerm<iter>),
+        describe (basic::linteger<iter>),
+        describe (basic::lintegers<iter>),
+        describe (basic::lintegerm<iter>),
+        describe (basic::llinteger<iter>),
+        describe (basic::llintegers<iter>),
+        describe (basic::llintegerm<iter>),
+        describe (basic::floating<iter>),
+        describe (basic::floatings<iter>),
+        describe (basic::floatingm<iter>),
+        describe (basic::lfloating<iter>),
+        describe (basic::lfloatings<iter>),
+        describe (basic::lfloatingm<iter>),
+        describe (basic::llfloating<iter>),
+        describe (basic::llfloatings<iter>),
+        describe (basic::llfloatingm<iter>)
+    };
+
+    snapshot const before_render;
+    std::size_t rendered (0);
+    for (auto const& d : descriptions)
+        rendered += d ().size ();
+    snapshot const after_render;
+
+    auto const us = [](snapshot const& a, snapshot const& b)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>
+            (b.time - a.time).count();
+    };
+
+    std::cout << descriptions.size ()
+              << " text and numeric parsers (std::string iterators)\n"
+              << "construction: " << us (before_init, after_init)
+              << " microsec., "
+              << after_init.count - before_init.count << " allocations ("
+              << after_init.bytes - before_init.bytes << " bytes), "
+              << after_init.live - before_init.live << " bytes held\n"
+              << "rendering descriptions: " << us (before_render, after_render)
+              << " microsec., "
+              << after_render.count - before_render.count << " allocations, "
+              << rendered << " characters" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+//
+// Profiling a choice among many keywords, with and without dispatch on
+// the FIRST sets of the alternatives
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter   = typename std::basic_string<char>::const_iterator;
+using cparse = parser<iter, char>;
+using AccT   = gsl::not_null_ptr<typename cparse::accumulator_type>;
+
+//
+// the keywords of C89; where one begins another, the longer comes first.
+//
+std::vector<std::string> const keywords
+{
+    "auto", "break", "case", "char", "const", "continue", "default",
+    "double", "do", "else", "enum", "extern", "float", "for", "goto", "if",
+    "int", "long", "register", "return", "short", "signed", "sizeof",
+    "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while"
+};
+
+static std::size_t attempts = 0;
+
+//
+// the letters of k from the ith on, in sequence.
+//
+cparse letters (std::string const& k, std::size_t const i)
+{
+    auto const t (token<iter> (char (k [i])));
+    return i + 1 == k.size () ? t : sequence (t, letters (k, i + 1));
+}
+
+//
+// a keyword as a sequence of its letters, counting the attempts made at
+// it; if opaque, its FIRST set is hidden, so that a choice must try it.
+//
+cparse keyword (std::string const& k, bool const opaque)
+{
+    auto const p (letters (k, 0));
+
+    cparse const counted
+    {
+        .description = p.description,
+        .parse = [p](AccT const acc)
+        {
+            ++attempts;
+            return p.parse (acc);
+        },
+        .lookahead = p.lookahead
+    };
+    return opaque ? override_lookahead (counted, first_set::any ())
+                  : counted;
+}
+
+cparse keyword_choice (bool const opaque)
+{
+    auto const kw = [opaque](std::size_t i)
+    {
+        return keyword (keywords [i], opaque);
+    };
+    return option (kw (0),  kw (1),  kw (2),  kw (3),  kw (4),  kw (5),
+                   kw (6),  kw (7),  kw (8),  kw (9),  kw (10), kw (11),
+                   kw (12), kw (13), kw (14), kw (15), kw (16), kw (17),
+                   kw (18), kw (19), kw (20), kw (21), kw (22), kw (23),
+                   kw (24), kw (25), kw (26), kw (27), kw (28), kw (29),
+                   kw (30), kw (31));
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_words = argc > 1 ? std::atol (argv[1]) : 65536;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    auto const spaces (skip_many (token<iter> (' ')));
+    auto const ordered    (many (ignorer (keyword_choice (true),  spaces)));
+    auto const dispatched (many (ignorer (keyword_choice (false), spaces)));
+
+    std::mt19937 gen (42);
+    std::uniform_int_distribution<std::size_t> pick (0, keywords.size () - 1);
+
+    std::cout << "Parsing keywords (best of " << runs << " runs)\n..."
+              << std::endl;
+
+    for (std::size_t n = max_words / 64; n <= max_words; n *= 4) {
+        std::string text;
+        for (std::size_t i = 0; i < n; ++i)
+            text += keywords [pick (gen)] + " ";
+        core::range<iter> const r {text};
+
+        auto const profile = [&](cparse const& p, std::size_t & tries)
+        {
+            long long best (0);
+            for (int i = 0; i < runs; ++i) {
+                attempts = 0;
+                auto start = std::chrono::high_resolution_clock::now();
+                auto res   = core::parse (p, r);
+                auto end   = std::chrono::high_resolution_clock::now();
+                auto us    = std::chrono::duration_cast
+                    <std::chrono::microseconds> (end - start).count();
+
+                if (not torange (res).empty ())
+                    std::cout << "incomplete parse!" << std::endl;
+                best  = i == 0 ? us : std::min (best, (long long) us);
+                tries = attempts;
+            }
+            return best;
+        };
+
+        std::size_t ordered_tries (0), dispatched_tries (0);
+        auto const ordered_us    (profile (ordered,    ordered_tries));
+        auto const dispatched_us (profile (dispatched, dispatched_tries));
+
+        std::cout << n << " keywords: ordered trial " << ordered_us
+                  << " microsec. (" << double (ordered_tries) / n
+                  << " attempts per keyword), dispatched " << dispatched_us
+                  << " microsec. (" << double (dispatched_tries) / n
+                  << " attempts per keyword)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+//
+// Profiling a choice among many keywords: as sequences of token parsers, as
+// literals, and as a single set of keywords matched through a trie
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/literal_parsers.hpp"
+#include "core/slice.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+//
+// the keywords of C89; where one begins another, the longer comes first,
+// as an option of them needs.
+//
+std::vector<std::string> const c89
+{
+    "auto", "break", "case", "char", "const", "continue", "default",
+    "double", "do", "else", "enum", "extern", "float", "for", "goto", "if",
+    "int", "long", "register", "return", "short", "signed", "sizeof",
+    "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while"
+};
+
+//
+// the letters of k from the ith on, in sequence.
+//
+parser<iter, char> letters (std::string const& k, std::size_t const i)
+{
+    auto const t (token<iter> (char (k [i])));
+    return i + 1 == k.size () ? t : sequence (t, letters (k, i + 1));
+}
+
+template <typename V, typename F>
+parser<iter, V> choice (F const& kw)
+{
+    return option (kw (0),  kw (1),  kw (2),  kw (3),  kw (4),  kw (5),
+                   kw (6),  kw (7),  kw (8),  kw (9),  kw (10), kw (11),
+                   kw (12), kw (13), kw (14), kw (15), kw (16), kw (17),
+                   kw (18), kw (19), kw (20), kw (21), kw (22), kw (23),
+                   kw (24), kw (25), kw (26), kw (27), kw (28), kw (29),
+                   kw (30), kw (31));
+}
+
+template <typename V>
+long long profile (parser<iter, V> const& p,
+                   std::string const& text,
+                   int const runs)
+{
+    auto const spaces (skip_many (token<iter> (' ')));
+    auto const words (skip_many (ignorer (p, spaces)));
+    range<iter> const r {text};
+
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (words, r);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast
+            <std::chrono::microseconds> (end - start).count();
+
+        if (not torange (res).empty ())
+            std::cout << "incomplete parse!" << std::endl;
+        best = i == 0 ? us : std::min (best, (long long) us);
+    }
+    return best;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_words = argc > 1 ? std::atol (argv[1]) : 65536;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    auto const tokens (choice<char> ([](std::size_t i)
+        { return letters (c89 [i], 0); }));
+    auto const literals (choice<slice<iter>> ([](std::size_t i)
+        { return literal<iter> (c89 [i]); }));
+    auto const trie (keywords<iter> (c89));
+
+    std::mt19937 gen (42);
+    std::uniform_int_distribution<std::size_t> pick (0, c89.size () - 1);
+
+    std::cout << "Parsing keywords (best of " << runs << " runs)\n..."
+              << std::endl;
+
+    for (std::size_t n = max_words / 64; n <= max_words; n *= 4) {
+        std::string text;
+        for (std::size_t i = 0; i < n; ++i)
+            text += c89 [pick (gen)] + " ";
+
+        std::cout << n << " keywords: option of tokens "
+                  << profile (tokens, text, runs)
+                  << " microsec., option of literals "
+                  << profile (literals, text, runs)
+                  << " microsec., keywords " << profile (trie, text, runs)
+                  << " microsec." << std::endl;
+    }
+    return 0;
+}
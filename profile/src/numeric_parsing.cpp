@@ -0,0 +1,132 @@
+//
+// Profiling numeric parsers: numbers made into strings and converted by
+// std::stoul and the like, and numbers read straight from the input
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+#include "basic/numeric_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+//
+// numbers converted as the numeric parsers did: the string of the number,
+// lifted through the conversion of the standard library. The string is
+// taken in one run of the characters a number may have, which is cheaper
+// than the sequence of strings the parsers once reduced.
+//
+parser<iter, std::string> const number_string = take_while1<iter>
+    ([](char const& c) -> bool
+        { return std::isdigit (c) || c == '-' || c == '+' || c == '.' ||
+                 c == 'e' || c == 'E'; },
+     "number character");
+
+parser<iter, unsigned long long> const string_natural = lift
+    (number_string,
+     [](std::string const& s) -> unsigned long long
+        { return std::stoull (s, nullptr, 10); });
+
+parser<iter, long long> const string_integer = lift
+    (number_string,
+     [](std::string const& s) -> long long
+        { return std::stoll (s, nullptr, 10); });
+
+parser<iter, double> const string_floating = lift
+    (number_string,
+     [](std::string const& s) -> double { return std::stod (s, nullptr); });
+
+template <typename V>
+long long profile (parser<iter, V> const& p,
+                   std::string const& text,
+                   int const runs)
+{
+    auto const numbers (skip_many (ignorer (p, basic::spacem<iter>)));
+    range<iter> const r {text};
+
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (numbers, r);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast
+            <std::chrono::microseconds> (end - start).count();
+
+        if (not torange (res).empty ())
+            std::cout << "incomplete parse!" << std::endl;
+        best = i == 0 ? us : std::min (best, (long long) us);
+    }
+    return best;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const count = argc > 1 ? std::atol (argv[1]) : 1 << 18;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    std::mt19937_64 gen (2026);
+    std::string naturals, integers, floats;
+    for (std::size_t i = 0; i < count; ++i) {
+        naturals += std::to_string (gen () >> (gen () % 64)) + " ";
+        integers += std::to_string
+            (static_cast<long long> (gen ()) >> (gen () % 64)) + " ";
+
+        char buf [32];
+        std::snprintf (buf, sizeof (buf), "%.17g",
+                       std::uniform_real_distribution<double> (-1e6, 1e6)
+                        (gen));
+        floats += std::string (buf) + " ";
+    }
+
+    struct test
+    {
+        std::string name;
+        std::string const& text;
+        long long through_string;
+        long long direct;
+    };
+
+    test const tests []
+    {
+        {"lnatural", naturals,
+         profile (string_natural, naturals, runs),
+         profile (basic::lnatural<iter>, naturals, runs)},
+        {"llinteger", integers,
+         profile (string_integer, integers, runs),
+         profile (basic::llinteger<iter>, integers, runs)},
+        {"lfloating", floats,
+         profile (string_floating, floats, runs),
+         profile (basic::lfloating<iter>, floats, runs)}
+    };
+
+    std::cout << "Parsing " << count << " numbers (best of " << runs
+              << " runs)\n..." << std::endl;
+
+    for (auto const& t : tests)
+        std::cout << t.name << " (" << t.text.size () << " bytes): "
+                  << "through strings " << t.through_string << " microsec. ("
+                  << t.text.size () / std::max (1ll, t.through_string)
+                  << " MB/s), direct " << t.direct << " microsec. ("
+                  << t.text.size () / std::max (1ll, t.direct)
+                  << " MB/s)" << std::endl;
+    return 0;
+}
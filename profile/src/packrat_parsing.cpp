@@ -0,0 +1,159 @@
+//
+// Profiling a backtracking grammar with and without memoization
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "core/memo.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter   = typename std::basic_string<char>::const_iterator;
+using iparse = parser<iter, int>;
+using AccT   = gsl::not_null_ptr<typename iparse::accumulator_type>;
+
+//
+// The grammar
+//
+//      expr := term '+' expr | term '-' expr | term
+//      term := '(' expr ')' | 'a'
+//
+// tries each alternative of expr in turn, and each of them begins by
+// parsing a term; on an input of n nested parentheses, such as "((a))",
+// only the last alternative succeeds at each level, and so a backtracking
+// parser makes 3^n attempts at the innermost term. Each term has a single
+// value (that of the expression between its parentheses, or 1 for `a`).
+//
+// If memoize_term is set, term is wrapped in memo (); the choices are
+// memoized in any case when parsing in packrat mode.
+//
+struct grammar
+{
+    explicit grammar (bool const memoize_term)
+        : expr_ (std::make_shared<std::function<AccT const (AccT const)>> ())
+    {
+        auto const self (expr_);
+        iparse const expr_ref
+        {
+            .description = "expr",
+            .parse = [self](AccT const acc) { return (*self) (acc); }
+        };
+
+        auto const one   (lift (token<iter> ('a'), [](char) { return 1; }));
+        auto const paren (ignorel (token<iter> ('('),
+                                   ignorer (expr_ref, token<iter> (')'))));
+        auto const plain (option (paren, one));
+        auto const term  (memoize_term ? memo (plain) : plain);
+
+        auto const expr
+            (option (sequence (term, ignorel (token<iter> ('+'), expr_ref)),
+                     sequence (term, ignorel (token<iter> ('-'), expr_ref)),
+                     term));
+        *expr_ = expr.parse;
+        parse_ = expr.parse;
+    }
+
+    ~grammar (void)
+    {
+        // break the cycle between expr and the reference to it.
+        *expr_ = nullptr;
+    }
+
+    inline iparse get (void) const
+    {
+        return iparse {.description = "expr", .parse = parse_};
+    }
+
+private:
+    std::shared_ptr<std::function<AccT const (AccT const)>> expr_;
+    std::function<AccT const (AccT const)> parse_;
+};
+
+struct run_summary
+{
+    long long best;
+    bool success;
+    std::size_t results;
+    std::size_t table_bytes;
+};
+
+template <typename P>
+run_summary profile (P const& p, std::string const& text, int runs,
+                     memo_mode const mode)
+{
+    run_summary s {0, false, 0, 0};
+    memo_context ctx {mode};
+
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, core::range<iter> {text}, ctx);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best    = i == 0 ? us : std::min (s.best, (long long) us);
+        s.success = parse_success (res) && torange (res).empty ();
+        s.results = res.size ();
+    }
+    s.table_bytes = ctx.capacity ();
+    return s;
+}
+
+void report (std::string const& name, std::size_t depth, run_summary const& s)
+{
+    std::cout << name << " depth " << depth << ": "
+              << (s.success ? "success" : "failure")
+              << ", " << s.results << " results; best "
+              << s.best << " microsec.";
+    if (s.table_bytes)
+        std::cout << ", " << s.table_bytes << " bytes of memo tables";
+    std::cout << std::endl;
+}
+
+std::string nested (std::size_t depth)
+{
+    return std::string (depth, '(') + "a" + std::string (depth, ')');
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_depth = argc > 1 ? std::atol (argv[1]) : 12;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    grammar const backtracking {false};
+    grammar const memoized     {true};
+
+    std::cout << "Parsing nested parentheses with expr ("
+              << runs << " runs)\n..." << std::endl;
+
+    for (std::size_t d = 2; d <= max_depth; d += 2) {
+        auto const text (nested (d));
+        report ("backtracking", d, profile (backtracking.get (), text, runs,
+                                            memo_mode::SELECTIVE));
+    }
+    std::cout << std::endl;
+
+    for (std::size_t d = max_depth / 4; d <= 256 * max_depth; d *= 4) {
+        auto const text (nested (d));
+        report ("memo (term) ", d, profile (memoized.get (), text, runs,
+                                            memo_mode::SELECTIVE));
+        report ("packrat     ", d, profile (backtracking.get (), text, runs,
+                                            memo_mode::PACKRAT));
+    }
+    return 0;
+}
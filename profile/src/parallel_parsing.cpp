@@ -0,0 +1,138 @@
+//
+// Profiling parallel_many: the sentences of a text parsed as independent
+// records on pools of threads of increasing size
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/parallel.hpp"
+#include "core/slice.hpp"
+#include "core/token_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+using namespace rpc::basic;
+
+using iter = char const*;
+
+//
+// the grammar of sentence_parser.cpp, with words as slices of the text.
+//
+using word_type = slice<iter>;
+using sentence_type = std::vector<word_type>;
+
+template <typename T, typename C>
+auto accumulate_back = [](T const& t, C & c)
+{
+    c.push_back (t);
+    return c;
+};
+
+auto wordsep  = ignorer (word<iter, char, range<iter>, word_type>,
+                         spacem<iter>);
+auto punctstr = recognize<word_type> (punct<iter>);
+auto sentence = reducel (sequence (some (wordsep), punctstr),
+                         accumulate_back<word_type, sentence_type>,
+                         sentence_type {});
+auto sentencesep = ignorer (sentence, spacem<iter>);
+
+//
+// a sentence may begin after the first mark of punctuation at or after
+// from, and the white space following it.
+//
+iter sentence_boundary (iter from, iter const end)
+{
+    from = std::find_if (from, end, [](char const c)
+        { return std::ispunct (static_cast<unsigned char> (c)); });
+    return std::find_if (from == end ? end : from + 1, end, [](char const c)
+        { return not std::isspace (static_cast<unsigned char> (c)); });
+}
+
+template <typename P>
+long long profile (P const& p, range<iter> const& text, int const runs,
+                   std::vector<sentence_type> & out)
+{
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, text);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        if (not parse_success (res) || not torange (res).empty ())
+            std::cout << "incomplete parse!" << std::endl;
+        best = i == 0 ? us : std::min (best, (long long) us);
+
+        auto const vs (values (res));
+        out.assign (vs.begin (), vs.end ());
+    }
+    return best;
+}
+
+int main (int argc, char ** argv)
+{
+    if (argc == 1) {
+        std::cout << "Need file name for text to parse!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    std::ifstream file (argv[1]);
+    if (not file.good ()) {
+        std::cout << "File: " << argv[1]
+                  << " does not exist (or cannot be read)!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    std::string const text
+        ((std::istreambuf_iterator<char> (file)),
+          std::istreambuf_iterator<char> ());
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 3;
+    std::size_t const max_threads = argc > 3
+        ? std::max (1, std::atoi (argv[3]))
+        : std::max (1u, std::thread::hardware_concurrency ());
+
+    range<iter> const r (text.data (), text.data () + text.size ());
+
+    std::cout << "Parsing: " << argv[1] << " for sentences (best of "
+              << runs << " runs, " << std::thread::hardware_concurrency ()
+              << " hardware threads)\n..." << std::endl;
+
+    std::vector<sentence_type> serial;
+    auto const base (profile (many (sentencesep), r, runs, serial));
+    std::cout << "many: " << serial.size () << " sentences, " << base
+              << " microsec." << std::endl;
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        task_pool pool (threads);
+        std::vector<sentence_type> parallel;
+        auto const us (profile
+            (parallel_many (sentencesep, sentence_boundary, pool),
+             r, runs, parallel));
+
+        std::cout << "parallel_many, " << threads << " threads: "
+                  << parallel.size () << " sentences, "
+                  << (parallel == serial ? "same" : "DIFFERENT")
+                  << " results, " << us << " microsec. (x"
+                  << double (base) / double (us) << ")" << std::endl;
+    }
+    return 0;
+}
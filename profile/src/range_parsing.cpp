@@ -0,0 +1,153 @@
+//
+// Profiling the primitive parsers over ranges of various iterator types
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <forward_list>
+#include <iostream>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+//
+// the input is n tokens of `a`; `many (item)` consumes them one at a time,
+// so the runtime is that of n calls each to head, tail and the accumulator.
+//
+template <typename It, typename R>
+long long profile_items (R const& r, int runs, std::size_t & results)
+{
+    auto const p (many (item<It, char>));
+
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, r);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        best    = i == 0 ? us : std::min (best, (long long) us);
+        results = res.size ();
+    }
+    return best;
+}
+
+//
+// the same, but with three failed alternatives tried before each success;
+// the runtime is then dominated by the cost of making failures.
+//
+template <typename It, typename R>
+long long profile_failures (R const& r, int runs, std::size_t & results)
+{
+    auto const p (many (option (token<It> ('x'),
+                                token<It> ('y'),
+                                token<It> ('z'),
+                                item<It, char>)));
+
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, r);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        best    = i == 0 ? us : std::min (best, (long long) us);
+        results = res.size ();
+    }
+    return best;
+}
+
+template <typename It, typename R>
+void report (std::string const& name, R const& r, int runs)
+{
+    std::size_t results (0);
+    auto const best (profile_items<It> (r, runs, results));
+
+    std::cout << name << ": sizeof (range) = " << sizeof (R)
+              << ", sizeof (entry) = "
+              << sizeof (typename accumulator<It, char>::backing_type
+                            ::value_type)
+              << "; " << results - 1 << " tokens in best "
+              << best << " microsec." << std::endl;
+}
+
+//
+// the time per token should not grow with the length of the input.
+//
+template <typename C>
+void report_scaling (std::string const& name, std::size_t const n, int runs)
+{
+    using It = typename C::const_iterator;
+
+    std::cout << name << ":";
+    for (std::size_t m = n / 8; m <= n; m *= 2) {
+        std::string const str (m, 'a');
+        C const c (str.cbegin (), str.cend ());
+
+        std::size_t results (0);
+        auto const best
+            (profile_items<It> (core::range<It> {c}, runs, results));
+        std::cout << " " << results - 1 << " tokens in "
+                  << best << " microsec. ("
+                  << 1000.0 * best / m << " ns/token);";
+    }
+    std::cout << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const n = argc > 1 ? std::atol (argv[1]) : 1000000;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 10;
+
+    std::cout << "Parsing " << n << " tokens with many (item) ("
+              << runs << " runs)\n..." << std::endl;
+
+    std::string const str (n, 'a');
+    std::vector<char> const vec (str.cbegin (), str.cend ());
+
+    using str_iter = std::string::const_iterator;
+    using vec_iter = std::vector<char>::const_iterator;
+    using ptr_iter = char const*;
+
+    report<str_iter> ("std::string      ",
+                      core::range<str_iter> {str}, runs);
+    report<vec_iter> ("std::vector<char>",
+                      core::range<vec_iter> {vec}, runs);
+    report<ptr_iter> ("char const*      ",
+                      core::range<ptr_iter> {str.data (),
+                                             str.data () + str.size ()},
+                      runs);
+
+    {
+        std::size_t results (0);
+        auto const best (profile_failures<str_iter>
+            (core::range<str_iter> {str}, runs, results));
+        std::cout << "std::string, 3 failed alternatives per token: "
+                  << results - 1 << " tokens in best "
+                  << best << " microsec." << std::endl;
+    }
+
+    std::cout << "\nScaling with the length of the input\n..." << std::endl;
+
+    report_scaling<std::deque<char>>        ("std::deque<char>       ", n, runs);
+    report_scaling<std::list<char>>         ("std::list<char>        ", n, runs);
+    report_scaling<std::forward_list<char>> ("std::forward_list<char>", n, runs);
+    return 0;
+}
@@ -0,0 +1,93 @@
+//
+// Profiling regex parsers: std::regex_search from the beginning of the
+// range, and patterns compiled into automata
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+#include "basic/regex_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+long long profile (parser<iter, std::string> const& p,
+                   std::string const& text,
+                   int const runs)
+{
+    auto const spaces (skip_many (token<iter> (' ')));
+    auto const words (skip_many (ignorer (p, spaces)));
+    range<iter> const r {text};
+
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (words, r);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast
+            <std::chrono::microseconds> (end - start).count();
+
+        if (not torange (res).empty ())
+            std::cout << "incomplete parse!" << std::endl;
+        best = i == 0 ? us : std::min (best, (long long) us);
+    }
+    return best;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const words = argc > 1 ? std::atol (argv[1]) : 1 << 16;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    std::cout << "Parsing " << words << " words (best of " << runs
+              << " runs)\n..." << std::endl;
+
+    //
+    // the patterns of example/src/string_parsing.cpp, over words of runs of
+    // a and b up to the given length.
+    //
+    for (std::size_t length = 4; length <= 64; length *= 4) {
+        std::mt19937 gen (42);
+        std::uniform_int_distribution<std::size_t> run (1, length);
+
+        std::string as, as_bs;
+        for (std::size_t i = 0; i < words; ++i) {
+            as += std::string (run (gen), 'a') + " ";
+            as_bs += std::string (run (gen), 'a') +
+                     std::string (run (gen), 'b') + " ";
+        }
+
+        auto const search_as
+            (basic::regexparser<iter> (std::regex ("a+"), "a+"));
+        auto const search_as_bs
+            (basic::regexparser<iter> (std::regex ("a+b+"), "a+b+"));
+        auto const compiled_as (basic::compiled_regexparser<iter> ("a+"));
+        auto const compiled_as_bs
+            (basic::compiled_regexparser<iter> ("a+b+"));
+
+        std::cout << "runs up to " << length << ": a+ std::regex "
+                  << profile (search_as, as, runs) << " microsec., compiled "
+                  << profile (compiled_as, as, runs) << " microsec.; "
+                  << "a+b+ std::regex " << profile (search_as_bs, as_bs, runs)
+                  << " microsec., compiled "
+                  << profile (compiled_as_bs, as_bs, runs) << " microsec."
+                  << std::endl;
+    }
+    return 0;
+}
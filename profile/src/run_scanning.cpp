@@ -0,0 +1,111 @@
+//
+// Profiling runs of a class of characters: words built by folding a
+// parse of each character, and by take_while
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter    = typename std::basic_string<char>::const_iterator;
+using sparse  = parser<iter, std::string>;
+
+//
+// The grammar
+//
+//      text := (space* word)*
+//      word := alpha+
+//
+// where, per character, a word is a fold of the parses of its letters onto
+// a string and the spaces are parsed and discarded; and, per run, a word is
+// a take_while1 of its letters and the spaces are a skip_while.
+//
+sparse per_character (void)
+{
+    auto const alpha (satisfy<iter, char, range<iter>>
+        (pure ([](char const& c) -> bool { return std::isalpha (c); }),
+         "alphabetic"));
+    auto const space (satisfy<iter, char, range<iter>>
+        (pure ([](char const& c) -> bool { return std::isspace (c); }),
+         "whitespace"));
+
+    auto const word
+        (fold_some (alpha, [](char c, std::string & s) { s.push_back (c); },
+                    std::string ()));
+    return many (ignorel (many (space), word));
+}
+
+sparse per_run (void)
+{
+    auto const word (take_while1<iter>
+        ([](char const& c) -> bool { return std::isalpha (c); },
+         "alphabetic"));
+    auto const spaces (skip_while<iter>
+        ([](char const& c) -> bool { return std::isspace (c); },
+         "whitespace"));
+    return many (ignorel (spaces, word));
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const length = argc > 1 ? std::atol (argv[1]) : 1 << 20;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    auto const folded  (per_character ());
+    auto const scanned (per_run ());
+
+    std::cout << "Parsing " << length << " characters of words (best of "
+              << runs << " runs)\n..." << std::endl;
+
+    for (std::size_t w = 4; w <= 1024; w *= 4) {
+        std::string text;
+        while (text.size () < length)
+            text += std::string (w, 'x') + " ";
+        core::range<iter> const r {text};
+
+        auto const profile = [&](sparse const& p, std::size_t & words)
+        {
+            long long best (0);
+            for (int i = 0; i < runs; ++i) {
+                auto start = std::chrono::high_resolution_clock::now();
+                auto res   = core::parse (p, r);
+                auto end   = std::chrono::high_resolution_clock::now();
+                auto us    = std::chrono::duration_cast
+                    <std::chrono::microseconds> (end - start).count();
+
+                if (not torange (res).empty ())
+                    std::cout << "incomplete parse!" << std::endl;
+                best  = i == 0 ? us : std::min (best, (long long) us);
+                words = res.size ();
+            }
+            return best;
+        };
+
+        std::size_t folded_words (0), scanned_words (0);
+        auto const folded_us  (profile (folded,  folded_words));
+        auto const scanned_us (profile (scanned, scanned_words));
+
+        if (folded_words != scanned_words)
+            std::cout << "different results!" << std::endl;
+        std::cout << "words of " << w << ": per character "
+                  << folded_us << " microsec., per run " << scanned_us
+                  << " microsec. (" << scanned_words << " results)"
+                  << std::endl;
+    }
+    return 0;
+}
@@ -10,16 +10,23 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <string>
 #include <streambuf>
 #include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
 
 #include "core/range.hpp"
 #include "core/parser.hpp"
 #include "core/combinators.hpp"
+#include "core/mapped_file.hpp"
+#include "core/slice.hpp"
 #include "core/token_parsers.hpp"
 #include "basic/text_parsers.hpp"
-#include "basic/regex_parsers.hpp"
 
 #ifndef RPC_PRINT_RESULTS
 #define RPC_PRINT_RESULTS 0
@@ -31,9 +38,18 @@ using namespace rpc;
 using namespace rpc::core;
 using namespace rpc::basic;
 
-using iter = typename std::basic_string<char>::const_iterator;
+//
+// the text is parsed in place, whether read into a string or mapped (with
+// --mmap, or --mmap-populate to read the pages in as it is mapped).
+//
+using iter = char const*;
 
-using sentence_type = std::deque<std::string>;
+//
+// words (and the punctuation ending a sentence) are slices of the text,
+// which is loaded in whole before it is parsed and outlives the results.
+//
+using word_type = slice<iter>;
+using sentence_type = std::vector<word_type>;
 
 template <typename T, typename C>
 auto accumulate_back = [](T const& t, C & c)
@@ -42,20 +58,12 @@ auto accumulate_back = [](T const& t, C & c)
     return c;
 };
 
-template <typename T, typename C>
-auto accumulate_front = [](T const& t, C & c)
-{
-    c.push_front (t);
-    return c;
-};
-
-auto wordsep  = ignorer (word<iter>, spacem<iter>);
-auto punctstr = lift
-    (punct<iter>, [](char c) { return std::string (1, c); });
-auto sentence = lift<sentence_type>
-    (reducer (sequence (some (wordsep), punctstr),
-             accumulate_front<std::string, std::deque<std::string>>,
-             std::deque<std::string>{}));
+auto wordsep  = ignorer (word<iter, char, range<iter>, word_type>,
+                         spacem<iter>);
+auto punctstr = recognize<word_type> (punct<iter>);
+auto sentence = reducel (sequence (some (wordsep), punctstr),
+                         accumulate_back<word_type, sentence_type>,
+                         sentence_type {});
 auto sentencesep = ignorer (sentence, spacem<iter>);
 auto sentences = some (sentencesep);
 
@@ -80,6 +88,18 @@ std::string read_in_file (std::string const& filename)
     return out;
 }
 
+//
+// the end of the text less its trailing white space, as read_in_file drops
+// it.
+//
+iter trim_end (iter const begin, iter end)
+{
+    std::string const space (" \v\n\r\t");
+    while (end != begin && space.find (end [-1]) != std::string::npos)
+        --end;
+    return end;
+}
+
 template <typename T>
 std::string print_results (std::deque<T> const& l)
 {
@@ -98,6 +118,7 @@ int main (int argc, char ** argv)
 {
     std::string filename;
     std::string parse_text;
+    std::unique_ptr<mapped_file const> mapped_text;
 
     if (argc == 1) {
         std::cout << "Need file name for text to parse!" << std::endl;
@@ -105,6 +126,8 @@ int main (int argc, char ** argv)
     }
 
     filename.assign (argv[1]);
+    std::string const mode (argc > 2 ? argv[2] : "");
+    bool const mapped (mode == "--mmap" || mode == "--mmap-populate");
     
     if (not file_exists (filename)) {
         std::cout << "File: "
@@ -114,11 +137,26 @@ int main (int argc, char ** argv)
         std::exit (EXIT_FAILURE);
     }
 
-    parse_text.assign (read_in_file (filename)); 
-    std::cout << "Parsing: " << filename << " for sentences\n..." << std::endl;
+    auto const load_start = std::chrono::high_resolution_clock::now();
+    iter text_begin, text_end;
+    if (mapped) {
+        mapped_text.reset
+            (new mapped_file (filename, mode == "--mmap-populate"));
+        text_begin = mapped_text->cbegin ();
+        text_end   = trim_end (text_begin, mapped_text->cend ());
+    } else {
+        parse_text.assign (read_in_file (filename));
+        text_begin = parse_text.data ();
+        text_end   = text_begin + parse_text.size ();
+    }
+    auto const load_end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Parsing: " << filename << " for sentences ("
+              << (mapped ? "mapped" : "read in") << ")\n..." << std::endl;
     {
+        range<iter> const text (text_begin, text_end);
         auto start = std::chrono::high_resolution_clock::now();
-        auto res   = rpc::core::parse (sentences, parse_text);
+        auto res   = rpc::core::parse (sentences, text);
         auto end   = std::chrono::high_resolution_clock::now();
         std::cout
             << "parse result: "
@@ -139,14 +177,24 @@ int main (int argc, char ** argv)
                 }
         } else if (RPC_PRINT_RESULTS) {
             std::cout << "original data: "
-                      << parse_text << std::endl;
+                      << text.grab () << std::endl;
             std::cout << "parsed data: "
                       << print_results (core::values (res)) << std::endl;
         }
+        std::cout << "load time: "
+              << std::chrono::duration_cast<std::chrono::microseconds>
+                    (load_end - load_start).count()
+              << " microsec." << std::endl;
         std::cout << "elapsed time: "
               << std::chrono::duration_cast<std::chrono::microseconds>
                     (end - start).count()
               << " microsec." << std::endl;
+#if defined(__linux__)
+        struct rusage usage;
+        if (::getrusage (RUSAGE_SELF, &usage) == 0)
+            std::cout << "peak RSS: " << usage.ru_maxrss << " KiB"
+                      << std::endl;
+#endif
     }
 
     return 0;
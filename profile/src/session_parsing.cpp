@@ -0,0 +1,130 @@
+//
+// Profiling parse sessions fed their input in chunks, against parsing the
+// input whole
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/session.hpp"
+#include "core/token_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter  = typename std::basic_string<char>::const_iterator;
+using siter = stream_iterator<char>;
+
+//
+// a sentence of sentence_parser.cpp, as the number of its words.
+//
+template <typename It>
+parser<It, std::size_t> sentence (void)
+{
+    auto const count = [](std::string const&, std::size_t & n) { ++n; };
+
+    auto const wordsep (ignorer (basic::word<It>, basic::spacem<It>));
+    return ignorer (ignorer (fold_some (wordsep, count, std::size_t (0)),
+                             basic::punct<It>),
+                    basic::spacem<It>);
+}
+
+struct run_summary
+{
+    long long best;
+    std::size_t words;
+    std::size_t held;
+    bool success;
+};
+
+template <typename F>
+run_summary profile (F const& f, int const runs)
+{
+    run_summary s {0, 0, 0, false};
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f (s);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best = i == 0 ? us : std::min (s.best, (long long) us);
+    }
+    return s;
+}
+
+int main (int argc, char ** argv)
+{
+    if (argc == 1) {
+        std::cout << "Need file name for text to parse!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    std::ifstream file (argv[1]);
+    if (not file.good ()) {
+        std::cout << "File: " << argv[1]
+                  << " does not exist (or cannot be read)!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    std::string const text
+        ((std::istreambuf_iterator<char> (file)),
+          std::istreambuf_iterator<char> ());
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    auto const whole (many (sentence<iter> ()));
+    auto const record (sentence<siter> ());
+
+    std::cout << "Parsing: " << argv[1] << " for sentences (best of "
+              << runs << " runs)\n..." << std::endl;
+
+    auto const w (profile ([&](run_summary & s)
+    {
+        auto const res (core::parse (whole, text));
+        s.success = parse_success (res) && torange (res).empty ();
+        s.words   = 0;
+        for (auto const n : values (res))
+            s.words += n;
+    }, runs));
+    std::cout << "whole: " << (w.success ? "success" : "failure") << ", "
+              << w.words << " words, best " << w.best << " microsec."
+              << std::endl;
+
+    for (std::size_t const chunk : {16, 256, 1500, 65536}) {
+        auto const c (profile ([&](run_summary & s)
+        {
+            parse_session<std::size_t> session (record, 4096);
+            s.words = 0;
+            for (std::size_t i = 0; i < text.size (); i += chunk) {
+                session.feed (text.data () + i,
+                              std::min (chunk, text.size () - i));
+                for (auto const n : session.take ())
+                    s.words += n;
+            }
+
+            s.success = session.finish () == session_status::DONE;
+            for (auto const n : session.take ())
+                s.words += n;
+            s.held = session.capacity ();
+        }, runs));
+        std::cout << "chunks of " << chunk << ": "
+                  << (c.success ? "success" : "failure") << ", " << c.words
+                  << " words, best " << c.best << " microsec., buffer "
+                  << c.held / 1024 << " KiB" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+//
+// Profiling speculative_many: CSV with newlines in quoted fields, which has
+// no split point that can be found without reading from the beginning,
+// parsed on pools of threads of increasing size
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/parallel.hpp"
+#include "core/slice.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = char const*;
+
+//
+// a row of CSV (RFC 4180), as a slice of the text of each field; quoted
+// fields may hold commas, newlines and doubled quotes.
+//
+using field_type = slice<iter>;
+using row_type = std::vector<field_type>;
+
+template <typename T, typename C>
+auto accumulate_back = [](T const& t, C & c)
+{
+    c.push_back (t);
+    return c;
+};
+
+auto quote    = token<iter> ('"');
+auto inner    = skip_while1<iter> ([](char const c) { return c != '"'; },
+                                   "quoted text");
+auto quoted   = ignorer (ignorer (quote,
+                                  skip_many (option (inner,
+                                                     sequence (quote, quote)))),
+                         quote);
+auto bare     = [](std::size_t const least)
+{
+    auto const plain = [](char const c)
+    {
+        return c != ',' && c != '\n' && c != '"';
+    };
+    return least == 0 ? skip_while<iter> (plain, "bare text")
+                      : skip_while1<iter> (plain, "bare text");
+};
+
+//
+// the first field of a row is not empty, so that no row is begun (and
+// left half made) at the end of the input.
+//
+auto first    = recognize<field_type> (option (quoted, bare (1)));
+auto field    = recognize<field_type> (option (quoted, bare (0)));
+auto fields   = sequence (first,
+                          many (sequence (liftignore<field_type>
+                                              (token<iter> (',')),
+                                          field)));
+auto row      = ignorer (reducel (fields,
+                                  accumulate_back<field_type, row_type>,
+                                  row_type {}),
+                         token<iter> ('\n'));
+
+//
+// lexical states: 0, outside quotes, and 1, inside them. A row begins after
+// a newline outside quotes.
+//
+iter row_boundary (std::size_t const state, iter from, iter const end)
+{
+    bool in_quotes (state == 1);
+    if (not in_quotes && from [-1] == '\n')
+        return from;
+
+    for (; from != end; ++from) {
+        if (*from == '"')
+            in_quotes = not in_quotes;
+        else if (*from == '\n' && not in_quotes)
+            return from + 1;
+    }
+    return end;
+}
+
+//
+// what a split point would be if quotes could be ignored: the beginning of
+// the next line.
+//
+iter line_boundary (iter from, iter const end)
+{
+    if (from [-1] == '\n')
+        return from;
+    from = std::find (from, end, '\n');
+    return from == end ? end : from + 1;
+}
+
+//
+// rows of six fields, one in three of them quoted, and one in eight of the
+// quoted ones spread over lines.
+//
+std::string make_csv (std::size_t const rows)
+{
+    std::uint32_t seed (12345);
+    auto const next = [&seed] (void)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    std::string csv;
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (int f = 0; f < 6; ++f) {
+            if (f != 0)
+                csv += ',';
+            auto const kind (next () % 24);
+            auto const size (1 + next () % 12);
+            if (kind < 8) {
+                csv += '"';
+                for (std::uint32_t i = 0; i < size; ++i)
+                    csv += char ('a' + next () % 26);
+                csv += kind == 0 ? "\n\"\"next, line\"\"" : ", and more";
+                csv += '"';
+            } else {
+                for (std::uint32_t i = 0; i < size; ++i)
+                    csv += char ('0' + next () % 10);
+            }
+        }
+        csv += '\n';
+    }
+    return csv;
+}
+
+template <typename P>
+long long profile (P const& p, range<iter> const& text, int const runs,
+                   std::vector<row_type> & out)
+{
+    long long best (0);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, text);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        if (not parse_success (res) || not torange (res).empty ())
+            std::cout << "incomplete parse!" << std::endl;
+        best = i == 0 ? us : std::min (best, (long long) us);
+
+        auto const vs (values (res));
+        out.assign (vs.begin (), vs.end ());
+    }
+    return best;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const rows = argc > 1 ? std::max (1, std::atoi (argv[1]))
+                                      : 100000;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 3;
+    std::size_t const max_threads = argc > 3
+        ? std::max (1, std::atoi (argv[3]))
+        : std::max (1u, std::thread::hardware_concurrency ());
+
+    std::string const csv (make_csv (rows));
+    range<iter> const r (csv.data (), csv.data () + csv.size ());
+
+    std::cout << "Parsing: " << rows << " rows of CSV, " << csv.size ()
+              << " bytes (best of " << runs << " runs, "
+              << std::thread::hardware_concurrency ()
+              << " hardware threads)\n..." << std::endl;
+
+    std::vector<row_type> serial;
+    auto const base (profile (many (row), r, runs, serial));
+    std::cout << "many: " << serial.size () << " rows, " << base
+              << " microsec." << std::endl;
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        task_pool pool (threads);
+        std::vector<row_type> lines, guessed;
+        auto const l (profile
+            (parallel_many (row, line_boundary, pool), r, runs, lines));
+        auto const g (profile
+            (speculative_many (row, 2, row_boundary, pool),
+             r, runs, guessed));
+
+        std::cout << threads << " threads: parallel_many at lines, "
+                  << (lines == serial ? "same" : "DIFFERENT")
+                  << " results, " << l << " microsec.; speculative_many, "
+                  << (guessed == serial ? "same" : "DIFFERENT")
+                  << " results, " << g << " microsec. (x"
+                  << double (base) / double (g) << ")" << std::endl;
+    }
+    return 0;
+}
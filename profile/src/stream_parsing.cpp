@@ -0,0 +1,174 @@
+//
+// Profiling input read from a stream as it is parsed, against input read in
+// whole before it is parsed
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/stream.hpp"
+#include "core/token_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter   = typename std::basic_string<char>::const_iterator;
+using siter  = stream_iterator<char>;
+
+//
+// the bytes held from the global heap, and the most held at once; each
+// block is prefixed with its size.
+//
+static std::size_t live_bytes = 0;
+static std::size_t peak_bytes = 0;
+
+void * operator new (std::size_t bytes)
+{
+    auto const header (alignof (std::max_align_t));
+    auto const block (static_cast<char *> (std::malloc (bytes + header)));
+    if (block == nullptr)
+        throw std::bad_alloc {};
+
+    *reinterpret_cast<std::size_t *> (block) = bytes;
+    live_bytes += bytes;
+    peak_bytes  = std::max (peak_bytes, live_bytes);
+    return block + header;
+}
+
+void operator delete (void * p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    auto const block
+        (static_cast<char *> (p) - alignof (std::max_align_t));
+    live_bytes -= *reinterpret_cast<std::size_t *> (block);
+    std::free (block);
+}
+
+void operator delete (void * p, std::size_t) noexcept
+{
+    operator delete (p);
+}
+
+//
+// The grammar of sentence_parser.cpp, counting the words of the sentences
+// rather than keeping them, so that only the input held grows with it; each
+// sentence commits once its first word is parsed.
+//
+template <typename It>
+parser<It, std::size_t> sentences (void)
+{
+    auto const one   = [](std::string const&) { return std::size_t (1); };
+    auto const count = [](std::string const&, std::size_t & n) { ++n; };
+    auto const add   = [](std::size_t const m, std::size_t & n) { n += m; };
+
+    auto const wordsep (ignorer (basic::word<It>, basic::spacem<It>));
+    auto const rest
+        (ignorer (ignorer (fold_many (wordsep, count, std::size_t (0)),
+                           basic::punct<It>),
+                  basic::spacem<It>));
+    auto const sentence (sequence (lift (wordsep, one), commit (rest)));
+    return fold_many (sentence, add, std::size_t (0));
+}
+
+struct run_summary
+{
+    long long best;
+    std::size_t peak;
+    std::size_t words;
+    bool success;
+};
+
+//
+// the best time of the given number of runs of f, which reads and parses
+// the input, and the most heap memory held above that held before it.
+//
+template <typename F>
+run_summary profile (F const& f, int const runs)
+{
+    run_summary s {0, 0, 0, false};
+    for (int i = 0; i < runs; ++i) {
+        auto const before (live_bytes);
+        peak_bytes = live_bytes;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        f (s);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best = i == 0 ? us : std::min (s.best, (long long) us);
+        s.peak = std::max (s.peak, peak_bytes - before);
+    }
+    return s;
+}
+
+void report (std::string const& name, run_summary const& s)
+{
+    std::cout << name << ": " << (s.success ? "success" : "failure")
+              << ", " << s.words << " words, best " << s.best
+              << " microsec., peak " << s.peak / 1024 << " KiB" << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    if (argc == 1) {
+        std::cout << "Need file name for text to parse!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    std::string const filename (argv[1]);
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 3;
+
+    if (not std::ifstream (filename).good ()) {
+        std::cout << "File: " << filename
+                  << " does not exist (or cannot be read)!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    auto const whole (sentences<iter> ());
+    auto const streamed (sentences<siter> ());
+
+    std::cout << "Parsing: " << filename << " for sentences (best of "
+              << runs << " runs)\n..." << std::endl;
+
+    report ("read in whole", profile ([&](run_summary & s)
+    {
+        std::ifstream file (filename);
+        std::string const text
+            ((std::istreambuf_iterator<char> (file)),
+              std::istreambuf_iterator<char> ());
+
+        auto const res (core::parse (whole, text));
+        s.success = parse_success (res) && torange (res).empty ();
+        s.words   = s.success ? values (res).front () : 0;
+    }, runs));
+
+    report ("streamed", profile ([&](run_summary & s)
+    {
+        std::ifstream file (filename);
+        stream_buffer<char> const buffer (file);
+
+        auto const res (core::parse (streamed, buffer));
+        s.success = parse_success (res) && torange (res).empty ();
+        s.words   = s.success ? values (res).front () : 0;
+    }, runs));
+
+    return 0;
+}
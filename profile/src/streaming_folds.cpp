@@ -0,0 +1,148 @@
+//
+// Profiling the time and memory taken to parse long repetitions, folded
+// as they are parsed or reduced after the fact
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+//
+// the bytes held from the global heap, and the most held at once; each
+// block is prefixed with its size.
+//
+static std::size_t live_bytes = 0;
+static std::size_t peak_bytes = 0;
+
+void * operator new (std::size_t bytes)
+{
+    auto const header (alignof (std::max_align_t));
+    auto const block (static_cast<char *> (std::malloc (bytes + header)));
+    if (block == nullptr)
+        throw std::bad_alloc {};
+
+    *reinterpret_cast<std::size_t *> (block) = bytes;
+    live_bytes += bytes;
+    peak_bytes  = std::max (peak_bytes, live_bytes);
+    return block + header;
+}
+
+void operator delete (void * p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    auto const block
+        (static_cast<char *> (p) - alignof (std::max_align_t));
+    live_bytes -= *reinterpret_cast<std::size_t *> (block);
+    std::free (block);
+}
+
+void operator delete (void * p, std::size_t) noexcept
+{
+    operator delete (p);
+}
+
+struct run_summary
+{
+    long long best;
+    std::size_t peak;
+    bool success;
+};
+
+//
+// the best time of the given number of runs, and the most heap memory
+// held above that held before the parse.
+//
+template <typename P>
+run_summary profile (P const& p, std::string const& text, int runs)
+{
+    run_summary s {0, 0, false};
+    for (int i = 0; i < runs; ++i) {
+        auto const before (live_bytes);
+        peak_bytes = live_bytes;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            auto res (core::parse (p, core::range<iter> {text}));
+            s.success = parse_success (res) && torange (res).length () <= 1;
+        }
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best = i == 0 ? us : std::min (s.best, (long long) us);
+        s.peak = std::max (s.peak, peak_bytes - before);
+    }
+    return s;
+}
+
+void report (std::string const& name, std::size_t n, run_summary const& s)
+{
+    std::cout << name << " " << n << ": "
+              << (s.success ? "success" : "failure")
+              << ", best " << s.best << " microsec., peak "
+              << s.peak / 1024 << " KiB" << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    std::size_t const max_length = argc > 1 ? std::atol (argv[1]) : 1 << 18;
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 3;
+
+    //
+    // a word, by reducing the list of its letters, and by folding them.
+    //
+    auto const reduced_word
+        (reducel (some (basic::alpha<iter>),
+                  [](char c, std::string & s) { s.push_back (c); return s; },
+                  std::string ()));
+    auto const folded_word
+        (fold_some (basic::alpha<iter>,
+                    [](char c, std::string & s) { s.push_back (c); },
+                    std::string ()));
+
+    //
+    // a run of spaces, kept and skipped.
+    //
+    auto const kept_spaces    (many (basic::space<iter>));
+    auto const skipped_spaces (skip_many (basic::space<iter>));
+
+    std::cout << "Parsing long words and runs of spaces (best of "
+              << runs << " runs)\n..." << std::endl;
+
+    for (std::size_t n = max_length / 256; n <= max_length; n *= 4) {
+        auto const letters (std::string (n, 'a') + ".");
+        report ("reducel (some (alpha))", n,
+                profile (reduced_word, letters, runs));
+        report ("fold_some (alpha)     ", n,
+                profile (folded_word, letters, runs));
+
+        auto const spaces (std::string (n, ' ') + ".");
+        report ("many (space)          ", n,
+                profile (kept_spaces, spaces, runs));
+        report ("skip_many (space)     ", n,
+                profile (skipped_spaces, spaces, runs));
+        std::cout << std::endl;
+    }
+    return 0;
+}
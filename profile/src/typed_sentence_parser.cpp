@@ -0,0 +1,207 @@
+//
+// Profiling the statically-typed and the type-erased sentence grammar
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <streambuf>
+#include <utility>
+
+#include "core/char_class.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "core/typed_parsers.hpp"
+#include "basic/text_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using iter = typename std::basic_string<char>::const_iterator;
+
+using sentence_type = std::deque<std::string>;
+
+static auto const accumulate_front =
+    [](std::string const& t, std::deque<std::string> & c)
+{
+    c.push_front (t);
+    return c;
+};
+
+static auto const char_to_string = [](char c) { return std::string (1, c); };
+
+//
+// the grammar of sentence_parser.cpp, built from the type-erased combinators.
+//
+auto erased_grammar (void)
+{
+    auto wordsep  = ignorer (basic::word<iter>, basic::spacem<iter>);
+    auto punctstr = lift (basic::punct<iter>, char_to_string);
+    auto sentence = lift<sentence_type>
+        (reducer (sequence (some (wordsep), punctstr),
+                  accumulate_front,
+                  std::deque<std::string>{}));
+    auto sentencesep = ignorer (sentence, basic::spacem<iter>);
+    return some (sentencesep);
+}
+
+//
+// the same grammar, built from the statically-typed combinators: words and
+// spaces are runs of a class of characters, as basic::word and spacem are,
+// and punctuation is a table of bytes, as basic::punct compiles it into.
+//
+auto typed_grammar (void)
+{
+    auto punct = typed::satisfy<iter>
+        (byte_class::of<char>
+            ([](char c) -> bool { return std::ispunct (c); }),
+         "punctuation");
+
+    auto spacem   = typed::skip_while<iter>
+        (class_predicate {char_class::space}, "whitespace");
+    auto word     = typed::take_while1<iter>
+        (class_predicate {char_class::alpha}, "alphabetic");
+    auto wordsep  = typed::ignorer (word, spacem);
+    auto punctstr = typed::lift (punct, char_to_string);
+    auto sentence = typed::lift<sentence_type>
+        (typed::reducer (typed::sequence (typed::some (wordsep), punctstr),
+                         accumulate_front,
+                         std::deque<std::string>{}));
+    auto sentencesep = typed::ignorer (sentence, spacem);
+    return typed::some (sentencesep);
+}
+
+std::string read_in_file (std::string const& filename)
+{
+    std::ifstream file (filename);
+    std::string out;
+
+    file.seekg (0, std::ios::end);
+    out.reserve (file.tellg());
+    file.seekg (0, std::ios::beg);
+
+    out.assign ((std::istreambuf_iterator<char>(file)),
+                 std::istreambuf_iterator<char>());
+    out.erase  (1 + out.find_last_not_of (" \v\n\r\t"));
+    return out;
+}
+
+struct run_summary
+{
+    long long best;
+    long long total;
+    bool success;
+    std::size_t results;
+    std::size_t remaining;
+    std::deque<sentence_type> sentences;
+};
+
+template <typename P>
+run_summary profile_erased (P const& p, std::string const& text, int runs)
+{
+    run_summary s {0, 0, false, 0, 0, {}};
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto res   = core::parse (p, text);
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best      = i == 0 ? us : std::min (s.best, (long long) us);
+        s.total    += us;
+        s.success   = parse_success (res);
+        s.results   = res.size ();
+        s.remaining = torange (res).length ();
+        s.sentences = values (res);
+    }
+    return s;
+}
+
+template <typename P>
+run_summary profile_typed (P const& p, std::string const& text, int runs)
+{
+    using A = typename typed::typed_traits<P>::accumulator_type;
+    using V = typename typed::typed_traits<P>::value_type;
+
+    run_summary s {0, 0, false, 0, 0, {}};
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        A acc {empty<V>{}, core::range<iter> {text}};
+        (void) p.parse (typename typed::typed_traits<P>::acc_ptr {&acc});
+        auto end   = std::chrono::high_resolution_clock::now();
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>
+            (end - start).count();
+
+        s.best      = i == 0 ? us : std::min (s.best, (long long) us);
+        s.total    += us;
+        s.success   = parse_success (acc);
+        s.results   = acc.size ();
+        s.remaining = torange (acc).length ();
+        s.sentences = values (acc);
+    }
+    return s;
+}
+
+void report (std::string const& name, run_summary const& s, int runs)
+{
+    std::cout << name << ": "
+              << (s.success ? "success" : "failure")
+              << ", " << s.results << " results, "
+              << s.remaining << " tokens left; best "
+              << s.best << " microsec., mean "
+              << s.total / runs << " microsec." << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    if (argc == 1) {
+        std::cout << "Need file name for text to parse!" << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    int const runs = argc > 2 ? std::max (1, std::atoi (argv[2])) : 10;
+    std::string const filename (argv[1]);
+
+    if (not std::ifstream (filename).good ()) {
+        std::cout << "File: "
+                  << filename
+                  << " does not exist (or cannot be read)!"
+                  << std::endl;
+        std::exit (EXIT_FAILURE);
+    }
+
+    auto const parse_text (read_in_file (filename));
+    auto const erased_sentences  (erased_grammar ());
+    auto const typed_sentences   (typed_grammar ());
+    auto const retyped_sentences (typed::erase (typed_sentences));
+
+    std::cout << "Parsing: " << filename << " for sentences ("
+              << runs << " runs)\n..." << std::endl;
+
+    auto const e (profile_erased (erased_sentences, parse_text, runs));
+    auto const t (profile_typed (typed_sentences, parse_text, runs));
+    auto const r (profile_erased (retyped_sentences, parse_text, runs));
+
+    report ("erased (core::parser)   ", e, runs);
+    report ("typed                   ", t, runs);
+    report ("typed, erase()'d at root", r, runs);
+
+    if (e.success != t.success || e.results != t.results ||
+        e.remaining != t.remaining || e.sentences != t.sentences ||
+        e.sentences != r.sentences) {
+        std::cout << "typed and erased grammars disagree!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
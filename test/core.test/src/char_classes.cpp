@@ -0,0 +1,97 @@
+//
+// Testing that the classes of characters decide every byte as the
+// functions of <cctype> do of it as an unsigned char, whether asked one
+// token at a time, compiled into a FIRST set, or scanned as a run
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/char_class.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter  = std::string::const_iterator;
+using witer = std::wstring::const_iterator;
+
+int main (void)
+{
+    struct named
+    {
+        char_class cls;
+        int (*is) (int);
+        std::string name;
+        char member;
+    };
+    std::vector<named> const classes
+    {
+        {char_class::space,  &std::isspace,  "space",  ' '},
+        {char_class::digit,  &std::isdigit,  "digit",  '0'},
+        {char_class::alpha,  &std::isalpha,  "alpha",  'a'},
+        {char_class::punct,  &std::ispunct,  "punct",  '!'},
+        {char_class::xdigit, &std::isxdigit, "xdigit", 'f'}
+    };
+
+    for (auto const& c : classes) {
+        class_predicate const predicate {c.cls};
+        auto const run (take_while<iter> (predicate, c.name));
+        bool tokens (true), first (true), runs (true);
+
+        for (unsigned b (0); b < 256; ++b) {
+            bool const in (c.is (static_cast<int> (b)) != 0);
+            tokens = tokens && predicate (static_cast<char> (b)) == in;
+            first = first && run.lookahead.test
+                (static_cast<unsigned char> (b)) == in;
+
+            //
+            // a run long enough to be scanned in blocks, ended by b.
+            //
+            std::string const input
+                (std::string (40, c.member) + static_cast<char> (b));
+            auto const res (core::parse (run, input));
+            runs = runs && parse_success (res) &&
+                toresult_value (res).size () == (in ? 41u : 40u);
+        }
+
+        check (tokens, c.name + ": each byte as a char");
+        check (first, c.name + ": the FIRST set of a run");
+        check (runs, c.name + ": the end of a run");
+    }
+
+    //
+    // a wide token past the values of unsigned char is in no class.
+    //
+    class_predicate const alpha {char_class::alpha};
+    check (alpha (L'a') && not alpha (wchar_t (0x0410)) &&
+           not alpha (wchar_t (0x10061)),
+           "a wide token past a byte is in no class");
+    auto const wide (core::parse (take_while<witer> (alpha, "alpha"),
+                                  std::wstring (L"ab\x0410")));
+    check (parse_success (wide) && toresult_value (wide) == L"ab",
+           "a wide run ends at a token past a byte");
+
+    if (failures == 0)
+        std::cout << "char_classes: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+//
+// Testing that a choice with committed alternatives gives the same outcome
+// whether it is dispatched on the next token (over bytes) or tries each
+// alternative in turn (over wider tokens)
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+enum class outcome
+{
+    SUCCESS,
+    FAILURE,
+    FATAL
+};
+
+template <typename A>
+outcome outcome_of (A const& res)
+{
+    return parse_success (res) ? outcome::SUCCESS
+         : parse_fatal (res)   ? outcome::FATAL
+                               : outcome::FAILURE;
+}
+
+//
+// the outcomes of the grammars over the given text, with tokens of type T.
+//
+template <typename T>
+std::vector<outcome> outcomes (std::basic_string<T> const& text)
+{
+    using iter = typename std::basic_string<T>::const_iterator;
+
+    auto const a (token<iter> (T ('a')));
+    auto const b (token<iter> (T ('b')));
+    auto const c (token<iter> (T ('c')));
+
+    return std::vector<outcome>
+    {
+        outcome_of (core::parse (option (commit (sequence (a, b)), c), text)),
+        outcome_of (core::parse (option (sequence (a, commit (b)), c), text)),
+        outcome_of (core::parse
+            (option (attempt (commit (sequence (a, b))), c), text)),
+    };
+}
+
+int main (void)
+{
+    for (auto const& text : {std::string ("c"),
+                             std::string ("ab"),
+                             std::string ("ac"),
+                             std::string ("x")}) {
+        std::wstring const wide (text.begin (), text.end ());
+        check (outcomes (text) == outcomes (wide),
+               "same outcomes over char and wchar_t on \"" + text + "\"");
+    }
+
+    auto const narrow (outcomes (std::string ("c")));
+    check (narrow [0] == outcome::FATAL,
+           "a committed alternative is tried before the next");
+    check (narrow [1] == outcome::SUCCESS,
+           "a commit after the deciding token leaves the choice to it");
+    check (narrow [2] == outcome::SUCCESS,
+           "an attempted commit is backtracked over");
+
+    if (failures == 0)
+        std::cout << "commit_dispatch: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
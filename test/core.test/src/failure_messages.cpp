@@ -0,0 +1,142 @@
+//
+// Testing failure messages: fixed ones refer to interned text, expectations
+// to descriptions rendered only when asked for, and those made while parsing
+// own theirs, which outlives the failure it was made for in every copy
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter = std::string::const_iterator;
+
+//
+// a parser which fails with a message made from the input, as a parser
+// written outside the library might.
+//
+parser<iter, char> const complain = parser<iter, char>
+{
+    .description = "[complain]",
+    .parse = [](gsl::not_null_ptr<accumulator<iter, char>> const acc)
+    {
+        auto const rng (torange (*acc));
+        acc->insert
+            (failure {"unexpected '" + std::string (1, rng.head ()) + "'"},
+             rng);
+        return acc;
+    },
+    .lookahead = first_set::any ()
+};
+
+int main (void)
+{
+    check (fixed_message ("y").what == fixed_message ("y").what,
+           "a fixed message is interned");
+    check (failure {expect (std::string ("x"))}.message () == "expected x",
+           "an expectation renders as one");
+    check (failure {fixed_message ("y")}.message () == "y",
+           "a fixed message renders as itself");
+    check (failure {}.message () == "failure",
+           "the default message");
+
+    //
+    // an expectation made from a description renders it only when asked.
+    //
+    int rendered (0);
+    auto const described (expect (description::deferred ([&rendered] (void)
+    {
+        ++rendered;
+        return std::string ("['z']");
+    })));
+    failure const copied_expectation (described);
+    check (rendered == 0, "an expectation is not rendered when made");
+#if not RPC_NO_DESCRIPTIONS
+    check (copied_expectation.message () == "expected ['z']" &&
+           rendered == 1,
+           "an expectation renders its description when asked");
+#else
+    check (copied_expectation.message () == "failure" && rendered == 0,
+           "an expectation is dropped with the descriptions");
+#endif
+
+#if not RPC_NO_DESCRIPTIONS
+    //
+    // a description of text made at run time holds the text itself.
+    //
+    description held;
+    {
+        std::string const made ("word " + std::to_string (42));
+        held = "[" + description (made) + "]";
+    }
+    check (held.str () == "[word 42]" &&
+           failure {expect (held)}.message () == "expected [word 42]",
+           "a description of run time text renders after the text is gone");
+#endif
+
+    std::string const text ("made at run time");
+    failure kept;
+    {
+        failure const made (text);
+        failure copied (made);
+        kept = copied;
+        failure const assigned (std::move (copied));
+        check (assigned.message () == text, "a moved message");
+        kept = assigned;
+    }
+    check (kept.message () == text, "a message outlives its original");
+    check (kept.fatal ().is_fatal () && kept.fatal ().message () == text,
+           "a fatal copy shares the message");
+
+    //
+    // messages made while parsing, on several threads at once.
+    //
+    std::vector<std::string> messages (4);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < messages.size (); ++i)
+        threads.emplace_back ([i, &messages] (void)
+        {
+            std::string const input (1, char ('a' + i));
+            for (int n = 0; n < 1000; ++n) {
+                auto const res (core::parse (option (complain, complain),
+                                             input));
+                messages [i] = toresult_failure_message (res);
+            }
+        });
+    for (auto & t : threads)
+        t.join ();
+
+    for (std::size_t i = 0; i < messages.size (); ++i)
+        check (messages [i] == "unexpected '" +
+                               std::string (1, char ('a' + i)) + "'",
+               "the message of a failure made on thread " +
+               std::to_string (i));
+
+    if (failures == 0)
+        std::cout << "failure_messages: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
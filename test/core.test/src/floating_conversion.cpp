@@ -0,0 +1,248 @@
+//
+// Testing that floating and lfloating convert decimal numbers to the same
+// float and double, bit for bit, as strtof and strtod: on the hard cases
+// (subnormals, halfway points, long mantissas, overflow and underflow) and
+// on a seeded random sample
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "basic/numeric_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter = std::string::const_iterator;
+
+template <typename F>
+struct bits_of;
+
+template <>
+struct bits_of<float>
+{
+    using type = std::uint32_t;
+};
+
+template <>
+struct bits_of<double>
+{
+    using type = std::uint64_t;
+};
+
+template <typename F>
+typename bits_of<F>::type bits (F const v)
+{
+    typename bits_of<F>::type b;
+    std::memcpy (&b, &v, sizeof (v));
+    return b;
+}
+
+inline void c_library (std::string const& s, float & v)
+{
+    v = std::strtof (s.c_str (), nullptr);
+}
+
+inline void c_library (std::string const& s, double & v)
+{
+    v = std::strtod (s.c_str (), nullptr);
+}
+
+//
+// whether p converts s as the C library does: to the same bits, over the
+// whole of s; or, where the C library overflows to infinity, not at all
+// (the parser fails as out of range).
+//
+template <typename F>
+bool same (parser<iter, F> const& p, std::string const& s)
+{
+    F expected;
+    c_library (s, expected);
+
+    auto const res (core::parse (p, s));
+    if (std::isinf (expected))
+        return not parse_success (res);
+
+    return parse_success (res) && torange (res).empty () &&
+        bits (toresult_value (res)) == bits (expected);
+}
+
+template <typename F>
+void compare (parser<iter, F> const& p, std::string const& type,
+              std::vector<std::string> const& inputs)
+{
+    for (auto const& s : inputs)
+        check (same (p, s), type + " of \"" + s + "\"");
+}
+
+//
+// a random decimal number of the grammar of the parsers: up to 30 digits,
+// a point among them half the time, and an exponent half the time.
+//
+std::string random_decimal (std::mt19937_64 & gen, int const max_exponent)
+{
+    std::uniform_int_distribution<int> length (1, 30);
+    std::uniform_int_distribution<int> digit (0, 9);
+    std::uniform_int_distribution<int> coin (0, 1);
+    std::uniform_int_distribution<int> exponent (-max_exponent, max_exponent);
+
+    std::string s (coin (gen) ? "-" : "");
+    auto const n (length (gen));
+    std::uniform_int_distribution<int> point (1, n);
+    auto const at (n > 1 && coin (gen) ? point (gen) : n);
+    for (int i = 0; i < n; ++i) {
+        if (i == at)
+            s.push_back ('.');
+        s.push_back (static_cast<char> ('0' + digit (gen)));
+    }
+    if (coin (gen))
+        s += "e" + std::to_string (exponent (gen));
+    return s;
+}
+
+//
+// v printed with the given number of significant digits.
+//
+template <typename F>
+std::string printed (F const v, int const digits)
+{
+    char buffer [64];
+    std::snprintf (buffer, sizeof (buffer), "%.*e", digits - 1, double (v));
+    return buffer;
+}
+
+int main (void)
+{
+    auto const d (basic::lfloating<iter>);
+    auto const f (basic::floating<iter>);
+
+    compare (d, "double",
+    {
+        // zeros, and exact values
+        "0", "-0", "0.0", "0e999", "-0e-999", "000000.000000e5", "1", "-1",
+        "0.5", "9007199254740992", "1e22", "1e23", "123456789e-22",
+
+        // subnormals, and the boundary with the normals
+        "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "7.4109846876186982e-324",
+        "1e-320", "2.2250738585072009e-308", "2.2250738585072011e-308",
+        "2.2250738585072012e-308", "2.2250738585072014e-308",
+        "2.225073858507201136057409796709131975934819546351645648e-308",
+
+        // halfway between two doubles (ties to even), and just off it
+        "9007199254740993", "9007199254740995", "9007199254740993.0000001",
+        "9007199254740992.9999999",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "1.00000000000000033306690738754696212708950042724609375",
+        "0.500000000000000166533453693773481063544750213623046875",
+
+        // more than 19 significant digits
+        "12345678901234567890", "123456789012345678901234567890",
+        "0.1000000000000000055511151231257827021181583404541015625",
+        "3.14159265358979323846264338327950288419716939937510582097494",
+        "2.718281828459045235360287471352662497757247093699959574966",
+        "1797693134862315708145274237317043567980705675258449965989174768"
+        "0315726078002853876058955863276687817154045895351438246423432132"
+        "6889464182768467546703537516986049910576551282076245490090389328"
+        "9440758685084551339423045832369032229481658085593321233482747978"
+        "26204144723168738177180919299881250404026184124858368",
+        "0.0000000000000000000000000000000000000000000000000000000000000000"
+        "0000000000000000000000000000000000000000000000000000000000000001",
+
+        // overflow: the largest double, what rounds to it, and past it
+        "1.7976931348623157e308", "1.7976931348623158e308",
+        "1.7976931348623159e308", "-1.7976931348623159e308", "1e309",
+        "1e400", "123456789012345678901234567890e300",
+
+        // underflow to zero
+        "2e-324", "1e-324", "1e-400", "-1e-400",
+        "0.00000000000000000000000000000000000000001e-300"
+    });
+
+    compare (f, "float",
+    {
+        "0", "-0", "1", "0.1", "16777216", "1e10", "3e-5",
+
+        // subnormals, and the boundary with the normals
+        "1.4e-45", "1.401298464324817e-45", "7.006492321624085e-46",
+        "7.006492321624086e-46", "1e-40", "1.1754942e-38",
+        "1.17549435e-38", "1.1754944e-38",
+
+        // halfway between two floats, and just off it
+        "16777217", "16777219", "16777217.000001", "16777216.999999",
+        "1.000000059604644775390625", "1.000000059604644775390624",
+        "1.000000059604644775390626", "7.038531e-26",
+
+        // more than 19 significant digits
+        "0.10000000149011611938476562500000000001",
+        "3.14159265358979323846264338327950288",
+        "340282356779733661637539395458142568447",
+
+        // overflow, and underflow to zero
+        "3.4028234e38", "3.4028235e38", "3.40282356e38", "3.4028236e38",
+        "1e39", "-1e39", "7e-46", "1e-46", "1e-50"
+    });
+
+    //
+    // a seeded random sample: decimals of every length over the range of
+    // exponents (and past it), and values printed short of, at, and past
+    // the digits that decide them.
+    //
+    std::mt19937_64 gen (20261017);
+    std::uniform_int_distribution<std::uint64_t> any_bits;
+    std::uniform_int_distribution<int> digits (1, 20);
+
+    std::size_t doubles (0), floats (0);
+    for (int i = 0; i < 20000; ++i) {
+        auto const s (random_decimal (gen, 340));
+        doubles += same (d, s) ? 0 : 1;
+
+        auto const t (random_decimal (gen, 50));
+        floats += same (f, t) ? 0 : 1;
+
+        auto const b (any_bits (gen));
+        double v;
+        std::memcpy (&v, &b, sizeof (v));
+        if (std::isfinite (v))
+            doubles += same (d, printed (v, digits (gen))) ? 0 : 1;
+
+        auto const c (static_cast<std::uint32_t> (b >> 32));
+        float w;
+        std::memcpy (&w, &c, sizeof (w));
+        if (std::isfinite (w))
+            floats += same (f, printed (w, digits (gen))) ? 0 : 1;
+    }
+    check (doubles == 0, "doubles of the random sample (" +
+           std::to_string (doubles) + " differ)");
+    check (floats == 0, "floats of the random sample (" +
+           std::to_string (floats) + " differ)");
+
+    if (failures == 0)
+        std::cout << "floating_conversion: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,244 @@
+//
+// Testing GLL parsing of the grammars the combinators cannot run: left
+// recursive ones (directly, through another rule, or behind an empty
+// rule), ambiguous ones, whose forests must hold every derivation, and
+// ones with empty rules; and where a grammar fails or stops short
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "core/gll.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter    = std::string::const_iterator;
+using grammar = gll::grammar<iter, char>;
+using forest  = gll::forest<char, range<iter>>;
+
+//
+// the values of the first derivation of s, and the input it leaves.
+//
+std::string derived (parser<iter, char> const& p, std::string const& s,
+                     std::size_t & left)
+{
+    auto const res (core::parse (p, s));
+    left = static_cast<std::size_t> (torange (res).length ());
+    if (not parse_success (res))
+        return "(failed)";
+
+    std::string out;
+    for (auto const c : values (res))
+        out.push_back (c);
+    return out;
+}
+
+//
+// the number of derivations below node n of the forest: the sum over its
+// packed children of the products of theirs.
+//
+std::uint64_t derivations (forest const& f, std::size_t const n,
+                           std::unordered_map<std::size_t, std::uint64_t> & m)
+{
+    if (n == gll::none || f.nodes [n].packed == gll::none)
+        return 1;
+
+    auto const found (m.find (n));
+    if (found != m.end ())
+        return found->second;
+
+    std::uint64_t count (0);
+    for (auto p (f.nodes [n].packed); p != gll::none; p = f.packed [p].next)
+        count += derivations (f, f.packed [p].left, m) *
+                 derivations (f, f.packed [p].right, m);
+    m [n] = count;
+    return count;
+}
+
+std::uint64_t derivations (forest const& f)
+{
+    std::unordered_map<std::size_t, std::uint64_t> m;
+    return derivations (f, f.root (), m);
+}
+
+int main (void)
+{
+    std::size_t left (0);
+
+    //
+    // direct left recursion: expr ::= expr '+' digit | digit.
+    //
+    {
+        grammar g;
+        auto const expr  (g.nonterminal ("expr"));
+        auto const digit (g.terminal (satisfy<iter, char, range<iter>>
+            ([](char const& c) { return c >= '0' && c <= '9'; }, "digit")));
+        auto const plus  (g.terminal (token<iter> ('+')));
+        g.rule (expr, {expr, plus, digit});
+        g.rule (expr, {digit});
+        auto const p (gll::to_parser (g, expr));
+
+        check (derived (p, "1+2+3", left) == "1+2+3" && left == 0,
+               "direct left recursion: the whole input");
+        check (derived (p, "7", left) == "7" && left == 0,
+               "direct left recursion: the base case");
+        check (derivations (gll::parse (g, expr, range<iter> {
+                   std::string ("1+2+3+4")})) == 1,
+               "direct left recursion: one derivation");
+
+        //
+        // failures: the longest prefix derived is taken, and a grammar
+        // which derives none fails where it began, expecting its start.
+        //
+        check (derived (p, "1+2+", left) == "1+2" && left == 1,
+               "a trailing '+' is left over");
+        auto const res (core::parse (p, std::string ("+1")));
+        check (not parse_success (res) &&
+               torange (res).length () == 2,
+               "a grammar which derives nothing fails where it began");
+#if not RPC_NO_DESCRIPTIONS
+        check (toresult_failure_message (res) == "expected [(gll) expr]",
+               "a grammar which derives nothing expects its start symbol");
+#endif
+        std::string const text ("1+2+");
+        auto const f (gll::parse (g, expr, range<iter> {text}));
+        check (f.success () && f.nodes [f.root ()].right == 3,
+               "the forest's longest root ends before the trailing '+'");
+        check (not gll::parse (g, expr, range<iter> {std::string ("x")})
+                   .success (),
+               "a forest of no derivation has no root");
+    }
+
+    //
+    // indirect left recursion: a ::= b 'a' | 'a', b ::= a 'b'.
+    //
+    {
+        grammar g;
+        auto const a  (g.nonterminal ("a"));
+        auto const b  (g.nonterminal ("b"));
+        auto const ta (g.terminal (token<iter> ('a')));
+        auto const tb (g.terminal (token<iter> ('b')));
+        g.rule (a, {b, ta});
+        g.rule (a, {ta});
+        g.rule (b, {a, tb});
+        auto const p (gll::to_parser (g, a));
+
+        check (derived (p, "ababa", left) == "ababa" && left == 0,
+               "indirect left recursion: the whole input");
+        check (derived (p, "abab", left) == "aba" && left == 1,
+               "indirect left recursion: the longest prefix");
+    }
+
+    //
+    // left recursion hidden behind an empty rule: h ::= n h 'c' | 'c',
+    // n ::= (empty).
+    //
+    {
+        grammar g;
+        auto const h (g.nonterminal ("h"));
+        auto const n (g.nonterminal ("n"));
+        auto const c (g.terminal (token<iter> ('c')));
+        g.rule (h, {n, h, c});
+        g.rule (h, {c});
+        g.rule (n, {});
+
+        check (derived (gll::to_parser (g, h), "ccc", left) == "ccc" &&
+               left == 0,
+               "hidden left recursion: the whole input");
+    }
+
+    //
+    // empty rules: s ::= as 'b', as ::= 'a' as | (empty); and a left
+    // recursive rule which may derive nothing: l ::= l 'a' | (empty).
+    //
+    {
+        grammar g;
+        auto const s  (g.nonterminal ("s"));
+        auto const as (g.nonterminal ("as"));
+        auto const ta (g.terminal (token<iter> ('a')));
+        auto const tb (g.terminal (token<iter> ('b')));
+        g.rule (s, {as, tb});
+        g.rule (as, {ta, as});
+        g.rule (as, {});
+        auto const p (gll::to_parser (g, s));
+
+        check (derived (p, "b", left) == "b" && left == 0,
+               "an empty rule derives nothing before a terminal");
+        check (derived (p, "aab", left) == "aab" && left == 0,
+               "an empty rule ends a right recursion");
+        check (derived (p, "aa", left) == "(failed)" && left == 2,
+               "an empty rule does not stand for a missing terminal");
+
+        grammar e;
+        auto const l  (e.nonterminal ("l"));
+        auto const ea (e.terminal (token<iter> ('a')));
+        e.rule (l, {l, ea});
+        e.rule (l, {});
+        auto const q (gll::to_parser (e, l));
+
+        check (derived (q, "aaa", left) == "aaa" && left == 0,
+               "a nullable left recursion: the whole input");
+        auto const none (core::parse (q, std::string ("")));
+        check (parse_success (none) && values (none).empty (),
+               "a nullable left recursion derives the empty input");
+        check (derived (q, "ba", left).empty () && left == 2,
+               "a nullable left recursion derives the empty prefix");
+    }
+
+    //
+    // ambiguity: e ::= e e | 'a' derives a^n in Catalan (n - 1) ways, all
+    // of which the forest holds.
+    //
+    {
+        grammar g;
+        auto const e (g.nonterminal ("e"));
+        auto const a (g.terminal (token<iter> ('a')));
+        g.rule (e, {e, e});
+        g.rule (e, {a});
+
+        std::uint64_t const catalan [] = {1, 1, 2, 5, 14, 42, 132, 429};
+        bool all (true);
+        for (std::size_t n = 1; n <= 8; ++n) {
+            std::string const text (n, 'a');
+            auto const f (gll::parse (g, e, range<iter> {text}));
+            all = all && f.success () &&
+                f.nodes [f.root ()].right == n &&
+                derivations (f) == catalan [n - 1];
+        }
+        check (all, "e ::= e e | 'a': every derivation is in the forest");
+
+        std::string const text (4, 'a');
+        auto const f (gll::parse (g, e, range<iter> {text}));
+        check (f.ambiguities (f.root ()) > 0,
+               "e ::= e e | 'a': the forest has ambiguous nodes");
+        check (derived (gll::to_parser (g, e), text, left) == text &&
+               left == 0,
+               "e ::= e e | 'a': a derivation as a parser");
+    }
+
+    if (failures == 0)
+        std::cout << "gll_grammars: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
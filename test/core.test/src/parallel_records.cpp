@@ -0,0 +1,320 @@
+//
+// Testing parallel parsing of records: that the values are those of many
+// over the whole input, in order, wherever the input is split and whatever
+// state a speculative parse guesses a chunk begins in, and that an
+// exception thrown on a worker is thrown again from the parse
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/parallel.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter = std::string::const_iterator;
+
+//
+// the values of a parse of s, and whether it consumed the whole of s.
+//
+std::vector<std::string> parsed (parser<iter, std::string> const& p,
+                                 std::string const& s, bool & whole)
+{
+    auto const res (core::parse (p, s));
+    whole = parse_success (res) && torange (res).empty ();
+    auto const vs (values (res));
+    return std::vector<std::string> (vs.begin (), vs.end ());
+}
+
+//
+// whether q over s leaves what many (p) does: the same values, in order,
+// and the same input.
+//
+bool same_as_many (parser<iter, std::string> const& p,
+                   parser<iter, std::string> const& q, std::string const& s)
+{
+    auto const serial (core::parse (many (p), s));
+    auto const parallel (core::parse (q, s));
+    auto const vs (values (serial));
+    auto const ws (values (parallel));
+    return parse_success (parallel) &&
+        torange (parallel).length () == torange (serial).length () &&
+        std::equal (vs.begin (), vs.end (), ws.begin (), ws.end ());
+}
+
+template <typename B>
+bool same_as_many (parser<iter, std::string> const& p, B const& boundary,
+                   task_pool & pool, std::string const& s)
+{
+    return same_as_many (p, parallel_many (p, boundary, pool), s);
+}
+
+//
+// lines of from one to eight digits, enough of them to be split into
+// chunks.
+//
+std::string make_lines (std::size_t const lines)
+{
+    std::uint32_t seed (2718);
+    auto const next = [&seed] (void)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    std::string text;
+    for (std::size_t l = 0; l < lines; ++l) {
+        auto const size (1 + next () % 8);
+        for (std::uint32_t i = 0; i < size; ++i)
+            text += char ('0' + next () % 10);
+        text += '\n';
+    }
+    return text;
+}
+
+//
+// a record may begin after the first newline before or at from.
+//
+iter line_boundary (iter from, iter const end)
+{
+    if (from [-1] == '\n')
+        return from;
+    from = std::find (from, end, '\n');
+    return from == end ? end : from + 1;
+}
+
+//
+// lines of digits, and one in five a quoted field of many such lines: most
+// of the input is within quotes, and reads as lines of digits from outside
+// them.
+//
+std::string make_quoted (std::size_t const lines)
+{
+    std::uint32_t seed (31415);
+    auto const next = [&seed] (void)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    std::string text;
+    for (std::size_t l = 0; l < lines; ++l) {
+        if (next () % 5 == 0) {
+            text += '"';
+            for (std::uint32_t i = 0, n = 50 + next () % 200; i < n; ++i)
+                text += std::to_string (next () % 1000) + '\n';
+            text += '"';
+        } else {
+            text += std::to_string (next () % 100000);
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+//
+// lexical states: 0, outside quotes, and 1, inside them. A record begins
+// after a newline outside quotes.
+//
+iter quoted_boundary (std::size_t const state, iter from, iter const end)
+{
+    bool in_quotes (state == 1);
+    if (not in_quotes && from [-1] == '\n')
+        return from;
+
+    for (; from != end; ++from) {
+        if (*from == '"')
+            in_quotes = not in_quotes;
+        else if (*from == '\n' && not in_quotes)
+            return from + 1;
+    }
+    return end;
+}
+
+int main (void)
+{
+    auto const is_digit = [](char const& c) { return c >= '0' && c <= '9'; };
+
+    //
+    // a record is a line of digits, as its text.
+    //
+    auto const line (ignorer (take_while1<iter> (is_digit, "digits"),
+                              token<iter> ('\n')));
+
+    std::string const text (make_lines (40000));
+    auto const half (text.find ('\n', text.size () / 2) + 1);
+    task_pool pool (4);
+    bool whole (false);
+
+    auto const serial (parsed (many (line), text, whole));
+    check (whole && serial.size () == 40000, "many parses every line");
+
+    //
+    // split at lines, the chunks give the values of many, in order.
+    //
+    auto const lines (parsed (parallel_many (line, line_boundary, pool),
+                              text, whole));
+    check (whole && lines == serial,
+           "split at lines: the values of many, in order");
+
+    //
+    // split anywhere, within records: the chunk a record cut off begins in
+    // parses it whole, and the parse goes on from its end as many.
+    //
+    auto const anywhere = [](iter const from, iter) { return from; };
+    auto const within (parsed (parallel_many (line, anywhere, pool),
+                               text, whole));
+    check (whole && within == serial,
+           "split within records: the values of many, in order");
+
+    //
+    // where the records stop (at one which is not a line of digits), the
+    // parse stops as many does, and leaves the rest.
+    //
+    check (same_as_many (line, line_boundary, pool,
+                         text.substr (0, half) + "x\n" + text),
+           "records which stop part way leave what many leaves");
+
+    //
+    // a record which fails keeps what it made, as in many: here a run of
+    // digits longer than a chunk, and not a line, after which a line of
+    // letters would parse. The parse ends with the run, wherever the chunks
+    // are split.
+    //
+    auto const is_alpha = [](char const& c) { return c >= 'a' && c <= 'z'; };
+    auto const letters (ignorer (take_while1<iter> (is_alpha, "letters"),
+                                 token<iter> ('\n')));
+    auto const either (option (letters, line));
+    check (same_as_many (either, line_boundary, pool,
+                         text.substr (0, half) + std::string (60000, '7') +
+                         "abc\n" + text),
+           "a record which fails across a split point ends the parse");
+
+    //
+    // an exception thrown by p on any chunk is thrown from the parse, and
+    // leaves the pool as it was.
+    //
+    auto const throwing (lift (line, [](std::string const& s)
+    {
+        if (s == "13579")
+            throw std::runtime_error ("odd record");
+        return s;
+    }));
+    std::string const thrown
+        (text.substr (0, text.find ('\n', 3 * text.size () / 4) + 1) +
+         "13579\n" + text);
+    std::string caught;
+    try {
+        core::parse (parallel_many (throwing, line_boundary, pool), thrown);
+    } catch (std::runtime_error const& e) {
+        caught = e.what ();
+    }
+    check (caught == "odd record", "an exception on a worker is thrown again");
+    check (parsed (parallel_many (line, line_boundary, pool), text, whole) ==
+               serial && whole,
+           "a pool parses again after an exception");
+
+    //
+    // a record is a line of digits or a quoted field, as its text.
+    //
+    auto const is_text = [](char const& c) { return c != '"'; };
+    auto const quoted (ignorer (ignorel (token<iter> ('"'),
+                                         take_while<iter> (is_text,
+                                                           "quoted text")),
+                                token<iter> ('"')));
+    auto const field (ignorer (option (quoted, take_while1<iter>
+                                                   (is_digit, "digits")),
+                               token<iter> ('\n')));
+
+    std::string const csv (make_quoted (4000));
+    std::vector<char> inside (csv.size () + 1);
+    for (std::size_t i (0); i < csv.size (); ++i)
+        inside [i + 1] = inside [i] != (csv [i] == '"');
+
+    //
+    // a guess made from outside quotes where the true state is inside
+    // them parses records which are not there; it is thrown away, and the
+    // values are those of many.
+    //
+    std::size_t wrong (0);
+    auto const counted = [&](std::size_t const state, iter const from,
+                             iter const end)
+    {
+        auto const at (static_cast<std::size_t> (from - csv.begin ()));
+        wrong += state != std::size_t (inside [at]) ? 1 : 0;
+        return quoted_boundary (state, from, end);
+    };
+    check (same_as_many (field, speculative_many (field, 2, counted, pool),
+                         csv) && wrong > 0,
+           "wrong guesses are thrown away");
+
+    //
+    // where no guess begins where the records of the chunk before ended,
+    // the chunk is parsed again from there.
+    //
+    auto const nowhere = [](std::size_t, iter const from, iter)
+    {
+        return from;
+    };
+    check (same_as_many (field, speculative_many (field, 2, nowhere, pool),
+                         csv),
+           "a chunk no guess began at is parsed again");
+
+    //
+    // split at lines, ignoring quotes, parallel_many gives the values of
+    // many too, if less in parallel.
+    //
+    check (same_as_many (field, line_boundary, pool, csv),
+           "split at lines within quotes: the values of many");
+
+    //
+    // a record which fails, keeping what it made past the next chunk, ends
+    // the parse as it ends many.
+    //
+    auto const at_lines = [](std::size_t, iter const from, iter const end)
+    {
+        return line_boundary (from, end);
+    };
+    check (same_as_many (either, speculative_many (either, 1, at_lines, pool),
+                         text.substr (0, half) + std::string (60000, '7') +
+                         "abc\n" + text),
+           "a guessed record which fails across a split point ends the parse");
+
+    caught.clear ();
+    try {
+        core::parse (speculative_many (throwing, 1, at_lines, pool), thrown);
+    } catch (std::runtime_error const& e) {
+        caught = e.what ();
+    }
+    check (caught == "odd record",
+           "an exception on a worker is thrown again from a guess");
+
+    if (failures == 0)
+        std::cout << "parallel_records: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
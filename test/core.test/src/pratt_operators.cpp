@@ -0,0 +1,175 @@
+//
+// Testing operator precedence parsing from a table: associativity, prefix
+// against postfix operators, operators which begin others, infix operators
+// with no operand after them, and operands which fail fatally
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/literal_parsers.hpp"
+#include "core/precedence.hpp"
+#include "core/slice.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter  = std::string::const_iterator;
+using table = operator_table<iter, std::string, slice<iter>>;
+
+//
+// each operator makes the bracketed text of its application, so that the
+// value of an expression shows how it was grouped.
+//
+table::binary infix (std::string const& op)
+{
+    return [op](std::string const& x, std::string const& y)
+    {
+        return "(" + x + op + y + ")";
+    };
+}
+
+table::unary prefix (std::string const& op)
+{
+    return [op](std::string const& x) { return "(" + op + x + ")"; };
+}
+
+table::unary postfix (std::string const& op)
+{
+    return [op](std::string const& x) { return "(" + x + op + ")"; };
+}
+
+//
+// the value of the expression at the beginning of s, and the input it
+// leaves; "(failed)" or "(fatal)" if it fails.
+//
+std::string grouped (parser<iter, std::string> const& p, std::string const& s,
+                     std::size_t & left)
+{
+    auto const res (core::parse (p, s));
+    left = static_cast<std::size_t> (torange (res).length ());
+    if (parse_fatal (res))
+        return "(fatal)";
+    else if (not parse_success (res))
+        return "(failed)";
+    return toresult_value (res);
+}
+
+int main (void)
+{
+    //
+    // an operand is a digit, or '#' and then, without fail, a digit.
+    //
+    auto const is_digit = [](char const& c) { return c >= '0' && c <= '9'; };
+    auto const text = [](char const& c) { return std::string (1, c); };
+    auto const digit (lift (satisfy<iter, char, range<iter>>
+                                (is_digit, "digit"),
+                            text));
+    auto const operand
+        (option (digit, ignorel (token<iter> ('#'), commit (digit))));
+
+    //
+    // '**' is added before '*', which begins it.
+    //
+    table ops;
+    ops.infixl (literal<iter> ("+"), 1, infix ("+"))
+       .infixl (literal<iter> ("-"), 1, infix ("-"))
+       .infixr (literal<iter> ("**"), 4, infix ("**"))
+       .infixl (literal<iter> ("*"), 2, infix ("*"))
+       .infixr (literal<iter> ("^"), 3, infix ("^"))
+       .prefix (literal<iter> ("-"), 5, prefix ("-"))
+       .postfix (literal<iter> ("!"), 6, postfix ("!"))
+       .postfix (literal<iter> ("?"), 0, postfix ("?"));
+    auto const expr (pratt (operand, ops));
+
+    struct example
+    {
+        std::string input;
+        std::string value;
+        std::size_t left;
+        std::string what;
+    };
+    example const examples []
+    {
+        {"1-2-3",   "((1-2)-3)",     0, "infixl associates left"},
+        {"1^2^3",   "(1^(2^3))",     0, "infixr associates right"},
+        {"1+2*3",   "(1+(2*3))",     0, "higher precedence first"},
+        {"1*2+3",   "((1*2)+3)",     0, "a lower precedence binds last"},
+        {"1*2^3*4", "((1*(2^3))*4)", 0, "levels nest"},
+
+        {"-1!",     "(-(1!))",       0, "a high postfix binds first"},
+        {"-1?",     "((-1)?)",       0, "a low postfix binds last"},
+        {"1+2?",    "((1+2)?)",      0, "a low postfix after an infix"},
+        {"1+-2!",   "(1+(-(2!)))",   0, "a prefix after an infix"},
+        {"--1",     "(-(-1))",       0, "prefixes nest"},
+
+        {"2**3",    "(2**3)",        0, "'**' is not read as '*' '*'"},
+        {"2**3**4", "(2**(3**4))",   0, "'**' associates to the right"},
+        {"2*3**4",  "(2*(3**4))",    0, "'*' and '**' side by side"},
+
+        {"1+2+",    "(1+2)",         1, "a trailing infix is left over"},
+        {"1+",      "1",             1, "an infix with no operand"},
+        {"1*-",     "1",             2,
+         "prefixes after a trailing infix are left over too"},
+        {"1+a",     "1",             2, "an infix before a non-operand"},
+        {"1**",     "1",             2, "a trailing '**' is left whole"},
+
+        {"#1+#2",   "(1+2)",         0, "committed operands"},
+        {"1+#x",    "(fatal)",       1, "a fatal operand fails the whole"},
+        {"#x",      "(fatal)",       1, "a fatal first operand"},
+        {"-#x",     "(fatal)",       1, "a fatal operand after a prefix"},
+        {"x",       "(failed)",      1, "no operand"},
+        {"-",       "(failed)",      0, "a prefix with no operand"}
+    };
+
+    for (auto const& e : examples) {
+        std::size_t left (0);
+        auto const value (grouped (expr, e.input, left));
+        check (value == e.value && left == e.left,
+               e.what + ": \"" + e.input + "\" gave " + value + " with " +
+               std::to_string (left) + " left");
+    }
+
+    //
+    // the failure of a fatal operand is the operand's own.
+    //
+    auto const fatal (core::parse (expr, std::string ("1+#x")));
+#if not RPC_NO_DESCRIPTIONS
+    check (toresult_failure_message (fatal) == "expected ['digit']",
+           "a fatal operand fails with its own message");
+#else
+    check (parse_fatal (fatal), "a fatal operand fails with its own message");
+#endif
+
+    //
+    // as a part of a larger parse, the operator left over by an expression
+    // is there for what follows it.
+    //
+    auto const statement (ignorer (expr, literal<iter> ("+;")));
+    std::size_t left (0);
+    check (grouped (statement, "1*2+;", left) == "(1*2)" && left == 0,
+           "what follows an expression parses its trailing operator");
+
+    if (failures == 0)
+        std::cout << "pratt_operators: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
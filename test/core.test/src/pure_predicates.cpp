@@ -0,0 +1,95 @@
+//
+// Testing that a predicate which keeps state is called for each token as it
+// is parsed, so that a choice never dispatches on what it answered when the
+// parser was built, and that one declared pure is compiled as before
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter = std::string::const_iterator;
+
+int main (void)
+{
+    //
+    // a predicate which accepts 'b' only once it is told to, after the
+    // parsers of it are built.
+    //
+    bool accept_b (false);
+    auto const letter = [&accept_b] (char const& l) -> bool
+    {
+        return l == 'a' || (accept_b && l == 'b');
+    };
+
+    auto const c (token<iter> ('c'));
+    auto const satisfied (option (satisfy<iter, char, range<iter>>
+                                      (letter, "letter"),
+                                  c));
+    auto const taken
+        (option (take_while1<iter> (letter, "letters"),
+                 lift (c, [](char x) { return std::string (1, x); })));
+    auto const skipped (option (skip_while1<iter> (letter, "letters"), c));
+
+    check (satisfied.lookahead.is_any (),
+           "satisfy of a predicate may begin with anything");
+    check (take_while<iter> (letter, "letters").lookahead.is_any (),
+           "take_while of a predicate may begin with anything");
+    check (take_until<iter> (letter, "letters").lookahead.is_any (),
+           "take_until of a predicate may begin with anything");
+
+    accept_b = true;
+    std::string const b ("b");
+    check (parse_success (core::parse (satisfied, b)),
+           "satisfy asks the predicate as it parses");
+    check (parse_success (core::parse (taken, b)),
+           "take_while1 asks the predicate as it parses");
+    check (parse_success (core::parse (skipped, b)),
+           "skip_while1 asks the predicate as it parses");
+
+    //
+    // a pure predicate is compiled: its parser begins only with the bytes
+    // it accepts.
+    //
+    auto const vowel (pure ([](char const& v) -> bool
+    {
+        return v == 'a' || v == 'e' || v == 'i' || v == 'o' || v == 'u';
+    }));
+    auto const vowels (satisfy<iter, char, range<iter>> (vowel, "vowel"));
+    check (vowels.lookahead.test ('a') && not vowels.lookahead.test ('b') &&
+           not vowels.lookahead.nullable,
+           "satisfy of a pure predicate is compiled");
+    check (take_until<iter> (vowel, "consonants").lookahead.test ('b') &&
+           not take_until<iter> (vowel, "consonants").lookahead.test ('a'),
+           "take_until of a pure predicate begins with what it rejects");
+    check (parse_success (core::parse (option (vowels, c), std::string ("e")))
+           && not parse_success
+               (core::parse (option (vowels, c), std::string ("b"))),
+           "a choice dispatches on a pure predicate");
+
+    if (failures == 0)
+        std::cout << "pure_predicates: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,114 @@
+//
+// Testing that the scratch accumulators of a parse return what they drew
+// from an ordinary memory resource, whichever resources parses alternate
+// between, and that under an arena they are reused from parse to parse
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "core/memory.hpp"
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter = std::string::const_iterator;
+
+//
+// a resource over operator new which counts the bytes it has out.
+//
+struct counting_resource : public memory_resource
+{
+public:
+    void * allocate (std::size_t const bytes, std::size_t const) override
+    {
+        held += bytes;
+        return ::operator new (bytes);
+    }
+
+    void deallocate (void * const p, std::size_t const bytes,
+                     std::size_t const) noexcept override
+    {
+        held -= bytes;
+        ::operator delete (p);
+    }
+
+    std::size_t held = 0;
+};
+
+int main (void)
+{
+    auto const letter = [](char const& c) -> bool
+    {
+        return std::isalpha (static_cast<unsigned char> (c));
+    };
+    auto const word (reducel (some (satisfy<iter, char, range<iter>>
+                                        (letter, "letter")),
+                              [](char const& c, std::string & s)
+                              {
+                                  s.push_back (c);
+                                  return s;
+                              },
+                              std::string ()));
+    auto const words (many (ignorer (lift (word, [](std::string const& s)
+                                           { return s.size (); }),
+                                     many (token<iter> (' ')))));
+    std::string const text ("the quick brown fox jumps over the lazy dog");
+
+    counting_resource first, second;
+    for (int i = 0; i < 100; ++i) {
+        auto & mem (i % 2 == 0 ? first : second);
+        {
+            auto const res (core::parse (words, range<iter> {text}, mem));
+            check (parse_success (res) && res.size () == 10,
+                   "a parse from an ordinary resource");
+        }
+        check (mem.held == 0,
+               "an ordinary resource gets back all it gave, on parse " +
+               std::to_string (i));
+    }
+
+    //
+    // under an arena, the scratch accumulators of one parse are those of
+    // the last, so that the arena draws no more for the second parse after
+    // a release than for the first.
+    //
+    monotonic_arena arena;
+    std::size_t drawn [3];
+    for (auto & d : drawn) {
+        {
+            auto const res (core::parse (words, range<iter> {text}, arena));
+            check (parse_success (res), "a parse from an arena");
+        }
+        d = arena.allocated ();
+        arena.release ();
+    }
+    check (drawn [1] == drawn [2],
+           "an arena draws as much for each parse after a release");
+
+    if (failures == 0)
+        std::cout << "scratch_resources: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+//
+// Testing that a parse session parses a record as soon as the input fed to
+// it completes the record, however little of it arrives at a time
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/session.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using siter = stream_iterator<char>;
+
+int main (void)
+{
+    auto const is_a = [](char const& c) -> bool { return c == 'a'; };
+
+    //
+    // a record is a run of a's ended by ';', as its length.
+    //
+    auto const record (ignorer (lift (take_while1<siter> (is_a, "a's"),
+                                      [](std::string const& s)
+                                      {
+                                          return s.size ();
+                                      }),
+                                token<siter> (';')));
+
+    {
+        parse_session<std::size_t> s (record);
+        check (s.feed (std::string (900, 'a')) == session_status::NEED_MORE &&
+               s.take ().empty (),
+               "a record cut off is not parsed");
+        check (s.feed ("aa;") == session_status::NEED_MORE,
+               "a session needs more after a whole record");
+        auto const vs (s.take ());
+        check (vs.size () == 1 && vs.front () == 902,
+               "a record is parsed once a short chunk completes it");
+        check (s.finish () == session_status::DONE && s.take ().empty (),
+               "a session is done once the input is finished");
+    }
+
+    {
+        parse_session<std::size_t> s (record);
+        std::string const input ("aaa;a;aaaaaaa;aa;");
+        std::size_t parsed (0);
+        for (auto const c : input) {
+            s.feed (&c, 1);
+            auto const vs (s.take ());
+            parsed += vs.size ();
+            check (vs.size () == (c == ';' ? 1u : 0u),
+                   "a record is parsed with the token which completes it");
+        }
+        check (parsed == 4 && s.finish () == session_status::DONE,
+               "a session fed one token at a time parses every record");
+    }
+
+    {
+        parse_session<std::size_t> s (record);
+        s.feed ("aa;ab");
+        check (s.status () == session_status::FAILED &&
+               s.take ().size () == 1 && s.position () == 4,
+               "a session fails at a record which cannot parse");
+    }
+
+    if (failures == 0)
+        std::cout << "session_feeding: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,134 @@
+//
+// Testing that a commit within an alternative does not drop the input of
+// a stream which an enclosing choice may still backtrack to, and that a
+// stream which fails to read fails the parse
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/literal_parsers.hpp"
+#include "core/stream.hpp"
+#include "core/token_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+using siter = stream_iterator<char>;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+//
+// the first alternative commits after "a", and fails (but not fatally) at
+// the end of a run of x much longer than the buffer's chunk; the second
+// must then parse from the "a" again.
+//
+template <typename P>
+void backtrack_over_commit (std::string const& name, P const& xs)
+{
+    auto const a (token<siter> ('a'));
+    auto const b (token<siter> ('b'));
+    auto const p (option (sequence (a, commit (b), xs, token<siter> ('!')),
+                          sequence (a, b, xs, token<siter> ('?'))));
+
+    std::istringstream in ("ab" + std::string (200000, 'x') + "?");
+    stream_buffer<char> const buffer (in, 16);
+    auto const res (core::parse (p, buffer));
+
+    check (parse_success (res), name + ": the second alternative parses");
+    check (torange (res).empty (), name + ": the whole input is parsed");
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+//
+// a descriptor which cannot be read (a directory) is an error of the
+// parse, not the end of its input.
+//
+template <typename P>
+void read_error (std::string const& name, P const& p)
+{
+    auto const fd (::open (".", O_RDONLY));
+    bool thrown (false);
+    try {
+        stream_buffer<char> const buffer (fd, 16);
+        (void) core::parse (p, buffer);
+    } catch (std::system_error const& e) {
+        thrown = e.code ().value () == EISDIR;
+    }
+    ::close (fd);
+    check (fd >= 0 && thrown, name + ": a read error is thrown");
+}
+#endif
+
+int main (void)
+{
+    auto const x (token<siter> ('x'));
+
+    backtrack_over_commit ("skip_many", skip_many (x));
+    backtrack_over_commit ("many", many (x));
+    backtrack_over_commit
+        ("fold_many", fold_many (x, [](char, char & c) { c = 'x'; }, 'x'));
+
+    //
+    // a repetition of records which commit, whose last record fails after
+    // its commit: the parse goes on from the beginning of that record, and
+    // the records before it are released as they are parsed.
+    //
+    {
+        auto const rec (sequence (token<siter> ('a'),
+                                  commit (skip_many (x)),
+                                  token<siter> (';')));
+        auto const p (sequence (skip_many (rec), token<siter> ('a'),
+                                skip_many (x), token<siter> ('.')));
+
+        std::string text;
+        for (int i = 0; i < 100; ++i)
+            text += "a" + std::string (1000, 'x') + ";";
+        text += "a" + std::string (1000, 'x') + ".";
+
+        std::istringstream in (text);
+        stream_buffer<char> const buffer (in, 16);
+        auto const res (core::parse (p, buffer));
+
+        check (parse_success (res), "skip_many: the last record is reparsed");
+        check (torange (res).empty (), "skip_many: the whole input is parsed");
+        check (buffer.capacity () < text.size () / 10,
+               "skip_many: the records before the last are released");
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    read_error ("many", many (x));
+    read_error ("option", option (token<siter> ('a'), x));
+    read_error ("take_while",
+                take_while<siter> ([](char c) { return c == 'x'; }, "x's"));
+    read_error ("literal", literal<siter> ("xyz"));
+#endif
+
+    if (failures == 0)
+        std::cout << "stream_backtracking: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
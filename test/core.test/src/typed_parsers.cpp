@@ -0,0 +1,143 @@
+//
+// Testing that each typed parser, erased, parses as its counterpart built
+// from the type-erased combinators does: to the same values, with the same
+// input left and the same failures
+//
+// Author: Dalton Woodard
+// Contact: daltonmwoodard@gmail.com
+// License: Please see LICENSE.md
+//
+
+#include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/range.hpp"
+#include "core/parser.hpp"
+#include "core/combinators.hpp"
+#include "core/token_parsers.hpp"
+#include "core/typed_parsers.hpp"
+
+using namespace rpc;
+using namespace rpc::core;
+
+int failures = 0;
+
+void check (bool const ok, std::string const& what)
+{
+    if (not ok) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+using iter = std::string::const_iterator;
+
+std::vector<std::string> const inputs
+{
+    "", "a", "ab", "abc1", "1", "  ab", "ab  ", "  ", "ba", "aab;", "a b c."
+};
+
+//
+// the typed parser t, erased, against the core parser c, over every input.
+//
+template <typename T, typename C>
+void same (std::string const& name, T const& t, C const& c)
+{
+    for (auto const& input : inputs) {
+        auto const typed_res (core::parse (typed::erase (t), input));
+        auto const core_res (core::parse (c, input));
+        auto const what (name + " on \"" + input + "\"");
+
+        check (parse_success (typed_res) == parse_success (core_res) &&
+               parse_fatal (typed_res) == parse_fatal (core_res),
+               what + ": the same outcome");
+        check (torange (typed_res).length () == torange (core_res).length (),
+               what + ": the same input left");
+        check (values (typed_res) == values (core_res),
+               what + ": the same values");
+        if (not parse_success (typed_res) && not parse_success (core_res))
+            check (toresult_failure_message (typed_res) ==
+                   toresult_failure_message (core_res),
+                   what + ": the same message (" +
+                   toresult_failure_message (typed_res) + " and " +
+                   toresult_failure_message (core_res) + ")");
+    }
+}
+
+int main (void)
+{
+    auto const is_alpha = [](char const& c) -> bool
+    {
+        return std::isalpha (static_cast<unsigned char> (c));
+    };
+    auto const is_space = [](char const& c) -> bool
+    {
+        return std::isspace (static_cast<unsigned char> (c));
+    };
+    auto const to_int = [](char const& c) { return int (c); };
+    auto const push_char = [](char const& c, std::string & s)
+    {
+        s.push_back (c);
+        return s;
+    };
+    auto const push_front = [](char const& c, std::string & s)
+    {
+        s.insert (s.begin (), c);
+        return s;
+    };
+
+    auto const t_alpha (typed::satisfy<iter> (is_alpha, "alpha"));
+    auto const c_alpha (satisfy<iter, char, range<iter>> (is_alpha, "alpha"));
+    auto const t_a (typed::token<iter> ('a'));
+    auto const c_a (token<iter> ('a'));
+    auto const t_b (typed::token<iter> ('b'));
+    auto const c_b (token<iter> ('b'));
+
+    same ("satisfy", t_alpha, c_alpha);
+    same ("token", t_a, c_a);
+    same ("take_while", typed::take_while<iter> (is_alpha, "alpha"),
+          take_while<iter> (is_alpha, "alpha"));
+    same ("take_while1", typed::take_while1<iter> (is_alpha, "alpha"),
+          take_while1<iter> (is_alpha, "alpha"));
+    same ("skip_while", typed::skip_while<iter> (is_space, "space"),
+          skip_while<iter> (is_space, "space"));
+    same ("skip_while1", typed::skip_while1<iter> (is_space, "space"),
+          skip_while1<iter> (is_space, "space"));
+
+    same ("sequence", typed::sequence (t_a, t_b), sequence (c_a, c_b));
+    same ("option", typed::option (t_b, t_a), option (c_b, c_a));
+    same ("many", typed::many (t_alpha), many (c_alpha));
+    same ("some", typed::some (t_alpha), some (c_alpha));
+    same ("some up to 2", typed::some (t_alpha, 2), some (c_alpha, 2));
+
+    same ("lift", typed::lift (t_alpha, to_int), lift (c_alpha, to_int));
+    same ("lift of a skip",
+          typed::lift (typed::skip_while<iter> (is_space, "space"), to_int),
+          lift (skip_while<iter> (is_space, "space"), to_int));
+    same ("reducel",
+          typed::reducel (typed::some (t_alpha), push_char, std::string ()),
+          reducel (some (c_alpha), push_char, std::string ()));
+    same ("reducer",
+          typed::reducer (typed::some (t_alpha), push_front, std::string ()),
+          reducer (some (c_alpha), push_front, std::string ()));
+
+    auto const t_spaces (typed::skip_while<iter> (is_space, "space"));
+    auto const c_spaces (skip_while<iter> (is_space, "space"));
+    auto const t_word (typed::take_while1<iter> (is_alpha, "alpha"));
+    auto const c_word (take_while1<iter> (is_alpha, "alpha"));
+    same ("ignorel", typed::ignorel (t_spaces, t_word),
+          ignorel (c_spaces, c_word));
+    same ("ignorer", typed::ignorer (t_word, t_spaces),
+          ignorer (c_word, c_spaces));
+    same ("some of ignorer",
+          typed::some (typed::ignorer (t_word, t_spaces)),
+          some (ignorer (c_word, c_spaces)));
+
+    if (failures == 0)
+        std::cout << "typed_parsers: all passed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}